@@ -0,0 +1,139 @@
+#include <input_file.h>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+input_file::input_file(const std::filesystem::path &path)
+    : data_{nullptr}
+    , size_{}
+    , buffer_{}
+    , file_{INVALID_HANDLE_VALUE}
+    , mapping_{nullptr}
+{
+    file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                        nullptr);
+
+    if (file_ == INVALID_HANDLE_VALUE)
+        throw std::runtime_error{"Could not open " + path.string() + "."};
+
+    LARGE_INTEGER file_size{};
+    GetFileSizeEx(file_, &file_size);
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+
+    if (size_ == 0)
+        return;
+
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (mapping_)
+        data_ = static_cast<const std::uint8_t *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+
+    if (!data_)
+    {
+        if (mapping_)
+            CloseHandle(mapping_);
+
+        CloseHandle(file_);
+        throw std::runtime_error{"Could not map " + path.string() + "."};
+    }
+}
+
+input_file::~input_file()
+{
+    if (data_ && mapping_)
+        UnmapViewOfFile(data_);
+
+    if (mapping_)
+        CloseHandle(mapping_);
+
+    if (file_ != INVALID_HANDLE_VALUE)
+        CloseHandle(file_);
+}
+
+#else
+
+input_file::input_file(const std::filesystem::path &path)
+    : data_{nullptr}
+    , size_{}
+    , buffer_{}
+    , mapped_{false}
+{
+    const auto file = ::open(path.c_str(), O_RDONLY);
+
+    if (file < 0)
+        throw std::runtime_error{"Could not open " + path.string() + "."};
+
+    struct stat status
+    {
+    };
+    ::fstat(file, &status);
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    if (size_ == 0)
+    {
+        ::close(file);
+        return;
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    auto *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+
+    if (data == MAP_FAILED)
+        throw std::runtime_error{"Could not map " + path.string() + "."};
+
+    // Every byte is read once from start to end.
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const std::uint8_t *>(data);
+    mapped_ = true;
+}
+
+input_file::~input_file()
+{
+    if (mapped_)
+        ::munmap(const_cast<std::uint8_t *>(data_), size_);
+}
+
+#endif
+
+input_file::input_file(std::FILE *stream)
+    : data_{nullptr}
+    , size_{}
+    , buffer_{}
+#if defined(_WIN32)
+    , file_{INVALID_HANDLE_VALUE}
+    , mapping_{nullptr}
+#else
+    , mapped_{false}
+#endif
+{
+    if (!std::freopen(nullptr, "rb", stream) || std::ferror(stream))
+        throw std::runtime_error(std::strerror(errno));
+
+    std::array<std::uint8_t, 64 * 1024> chunk{};
+    std::size_t length;
+
+    while ((length = std::fread(std::data(chunk), 1, std::size(chunk), stream)) > 0)
+        buffer_.insert(std::end(buffer_), std::data(chunk), std::data(chunk) + length);
+
+    if (std::ferror(stream))
+        throw std::runtime_error(std::strerror(errno));
+
+    data_ = std::data(buffer_);
+    size_ = std::size(buffer_);
+}
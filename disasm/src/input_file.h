@@ -0,0 +1,42 @@
+#pragma once
+
+#include <aeon/common/span.h>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+/*!
+ * The bytes of an input to disassemble. A file is mapped into memory read-only; a stream such as stdin
+ * is read into memory.
+ */
+class input_file final
+{
+public:
+    explicit input_file(const std::filesystem::path &path);
+    explicit input_file(std::FILE *stream);
+    ~input_file();
+
+    input_file(input_file &&) noexcept = delete;
+    auto operator=(input_file &&) noexcept -> input_file & = delete;
+
+    input_file(const input_file &) noexcept = delete;
+    auto operator=(const input_file &) noexcept -> input_file & = delete;
+
+    auto bytes() const noexcept
+    {
+        return aeon::common::span<const std::uint8_t>{data_, size_};
+    }
+
+private:
+    const std::uint8_t *data_;
+    std::size_t size_;
+    std::vector<std::uint8_t> buffer_;
+
+#if defined(_WIN32)
+    void *file_;
+    void *mapping_;
+#else
+    bool mapped_;
+#endif
+};
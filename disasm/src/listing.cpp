@@ -0,0 +1,439 @@
+#include <listing.h>
+#include <disasm6502/decoder.h>
+#include <disasm6502/formatter.h>
+#include <disasm6502/parallel_sweep.h>
+#include <disasm6502/recursive_analysis.h>
+#include <disasm6502/symbol_table.h>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+output_buffer::output_buffer()
+    : data_(64 * 1024)
+    , size_{}
+{
+}
+
+void output_buffer::append(const char *text, const std::size_t size)
+{
+    auto *destination = reserve(size);
+    std::memcpy(destination, text, size);
+    commit(destination + size);
+}
+
+void output_buffer::append(const std::string &text)
+{
+    append(std::data(text), std::size(text));
+}
+
+void output_buffer::clear() noexcept
+{
+    size_ = 0;
+}
+
+static auto write_spaces(char *destination, const std::size_t count) noexcept -> char *
+{
+    std::memset(destination, ' ', count);
+    return destination + count;
+}
+
+static auto write_text(char *destination, const std::string_view text) noexcept -> char *
+{
+    std::memcpy(destination, std::data(text), std::size(text));
+    return destination + std::size(text);
+}
+
+static auto write_label(char *destination, const std::uint16_t address) noexcept -> char *
+{
+    destination = write_text(destination, "L_");
+    destination = disasm6502::format_hex16(address, destination);
+    *destination++ = ':';
+    return destination;
+}
+
+/*!
+ * Symbol names are identifiers, but a symbol file can contain anything; characters that would need an
+ * escape in a JSON string are dropped.
+ */
+static auto write_json_safe(char *destination, const std::string_view text) noexcept -> char *
+{
+    for (const auto c : text)
+    {
+        if (c != '"' && c != '\\' && static_cast<unsigned char>(c) >= 0x20)
+            *destination++ = c;
+    }
+
+    return destination;
+}
+
+/*!
+ * The symbol at the address of an item, and the symbol its operand refers to.
+ */
+struct item_symbols
+{
+    std::optional<std::string_view> name;
+    std::array<char, 128> reference;
+    std::size_t reference_length;
+};
+
+static void find_symbols(const disasm6502::symbol_table *symbols, const disasm6502::decoded_instruction &instruction,
+                         item_symbols &result) noexcept
+{
+    result.name.reset();
+    result.reference_length = 0;
+
+    if (!symbols)
+        return;
+
+    result.name = symbols->exact(instruction.address);
+    result.reference_length =
+        disasm6502::format_symbol(instruction, *symbols, std::data(result.reference), std::size(result.reference));
+}
+
+static auto write_bytes(char *destination, const std::uint8_t *bytes, const std::size_t count) noexcept -> char *
+{
+    for (auto i = std::size_t{0}; i < count; ++i)
+    {
+        if (i != 0)
+            *destination++ = ' ';
+
+        destination = disasm6502::format_hex8(bytes[i], destination);
+    }
+
+    return destination;
+}
+
+static auto write_decimal(char *destination, std::uint32_t value) noexcept -> char *
+{
+    char digits[10];
+    auto count = 0;
+
+    do
+    {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (count > 0)
+        *destination++ = digits[--count];
+
+    return destination;
+}
+
+static auto kind_name(const disasm6502::record_kind kind) noexcept -> const char *
+{
+    switch (kind)
+    {
+        case disasm6502::record_kind::instruction:
+            return "instruction";
+        case disasm6502::record_kind::data_byte:
+            return "byte";
+        case disasm6502::record_kind::data_word:
+            return "word";
+    }
+
+    return "";
+}
+
+static auto json_escape(const std::string &text) -> std::string
+{
+    std::string result;
+
+    for (const auto c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[7];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            result += escaped;
+        }
+        else
+        {
+            result += c;
+        }
+    }
+
+    return result;
+}
+
+/*!
+ * "8000    a9 00           lda #$00", the same columns the listing has always had.
+ */
+class text_writer final
+{
+public:
+    explicit text_writer(output_buffer &output, const listing_settings &settings)
+        : output_{output}
+        , target_{settings.target}
+        , symbols_{settings.symbols}
+        , item_symbols_{}
+    {
+    }
+
+    void begin(const std::string &, const std::uint16_t)
+    {
+    }
+
+    void item(const disasm6502::decoded_instruction &instruction, const std::uint8_t *bytes, const bool label)
+    {
+        static constexpr std::size_t max_label_length = 8;
+        static constexpr std::size_t max_line_length = 8 + 16 + disasm6502::max_formatted_length + 1;
+
+        find_symbols(symbols_, instruction, item_symbols_);
+        const auto name_length = item_symbols_.name ? std::size(*item_symbols_.name) + 2 : 0;
+        const auto reference_length = item_symbols_.reference_length + disasm6502::max_formatted_length + 2;
+
+        auto *destination = output_.reserve(max_label_length + name_length + max_line_length + reference_length);
+
+        if (item_symbols_.name)
+        {
+            destination = write_text(destination, *item_symbols_.name);
+            destination = write_text(destination, ":\n");
+        }
+        else if (label)
+        {
+            destination = write_label(destination, instruction.address);
+            *destination++ = '\n';
+        }
+
+        destination = disasm6502::format_hex16(instruction.address, destination);
+        destination = write_spaces(destination, 4);
+
+        const auto *bytes_start = destination;
+        destination = write_bytes(destination, bytes, instruction.length);
+        destination = write_spaces(destination, 16 - static_cast<std::size_t>(destination - bytes_start));
+
+        const auto text_length = disasm6502::format(instruction, destination, target_);
+        destination += text_length;
+
+        if (item_symbols_.reference_length != 0)
+        {
+            destination = write_spaces(destination, disasm6502::max_formatted_length - text_length);
+            destination = write_text(destination, "; ");
+            destination = write_text(
+                destination, std::string_view{std::data(item_symbols_.reference), item_symbols_.reference_length});
+        }
+
+        *destination++ = '\n';
+        output_.commit(destination);
+    }
+
+    void end()
+    {
+    }
+
+private:
+    output_buffer &output_;
+    disasm6502::cpu_target target_;
+    const disasm6502::symbol_table *symbols_;
+    item_symbols item_symbols_;
+};
+
+class json_writer final
+{
+public:
+    explicit json_writer(output_buffer &output, const listing_settings &settings)
+        : output_{output}
+        , target_{settings.target}
+        , symbols_{settings.symbols}
+        , item_symbols_{}
+        , first_{true}
+    {
+    }
+
+    void begin(const std::string &name, const std::uint16_t address)
+    {
+        output_.append("{\"name\":\"" + json_escape(name) + "\",\"address\":" + std::to_string(address) +
+                       ",\"items\":[");
+    }
+
+    void item(const disasm6502::decoded_instruction &instruction, const std::uint8_t *bytes, const bool label)
+    {
+        static constexpr std::size_t max_item_length = 128;
+
+        find_symbols(symbols_, instruction, item_symbols_);
+        const auto name_length = item_symbols_.name ? std::size(*item_symbols_.name) + 10 : 0;
+        const auto reference_length = item_symbols_.reference_length + 12;
+
+        auto *destination = output_.reserve(max_item_length + name_length + reference_length);
+
+        if (!first_)
+            *destination++ = ',';
+
+        first_ = false;
+
+        destination = write_text(destination, "\n{\"address\":");
+        destination = write_decimal(destination, instruction.address);
+        destination = write_text(destination, ",\"bytes\":\"");
+        destination = write_bytes(destination, bytes, instruction.length);
+        destination = write_text(destination, "\",\"text\":\"");
+        destination += disasm6502::format(instruction, destination, target_);
+        destination = write_text(destination, "\",\"kind\":\"");
+        destination = write_text(destination, kind_name(instruction.kind));
+        *destination++ = '"';
+
+        if (label)
+            destination = write_text(destination, ",\"label\":true");
+
+        if (item_symbols_.name)
+        {
+            destination = write_text(destination, ",\"name\":\"");
+            destination = write_json_safe(destination, *item_symbols_.name);
+            *destination++ = '"';
+        }
+
+        if (item_symbols_.reference_length != 0)
+        {
+            destination = write_text(destination, ",\"symbol\":\"");
+            destination = write_json_safe(
+                destination, std::string_view{std::data(item_symbols_.reference), item_symbols_.reference_length});
+            *destination++ = '"';
+        }
+
+        *destination++ = '}';
+        output_.commit(destination);
+    }
+
+    void end()
+    {
+        output_.append(first_ ? "]}\n" : "\n]}\n", first_ ? 3 : 4);
+    }
+
+private:
+    output_buffer &output_;
+    disasm6502::cpu_target target_;
+    const disasm6502::symbol_table *symbols_;
+    item_symbols item_symbols_;
+    bool first_;
+};
+
+class binary_writer final
+{
+public:
+    static constexpr std::size_t header_size = 12;
+    static constexpr std::size_t record_size = 8;
+
+    explicit binary_writer(output_buffer &output, const listing_settings &settings)
+        : output_{output}
+        , flags_{static_cast<std::uint8_t>((settings.recursive ? 1 : 0) | static_cast<int>(settings.target) << 1)}
+        , header_{}
+        , count_{}
+    {
+    }
+
+    void begin(const std::string &, const std::uint16_t address)
+    {
+        header_ = output_.size();
+
+        auto *destination = output_.reserve(header_size);
+        std::memcpy(destination, "D65L", 4);
+        destination[4] = 1;
+        destination[5] = static_cast<char>(flags_);
+        write16(destination + 6, address);
+        output_.commit(destination + header_size);
+    }
+
+    void item(const disasm6502::decoded_instruction &instruction, const std::uint8_t *, const bool label)
+    {
+        auto *destination = output_.reserve(record_size);
+        write16(destination, instruction.address);
+        write16(destination + 2, instruction.operand);
+        destination[4] = static_cast<char>(instruction.opcode);
+        destination[5] = static_cast<char>(instruction.length);
+        destination[6] = static_cast<char>(instruction.mode);
+        destination[7] = static_cast<char>(static_cast<std::uint8_t>(instruction.kind) | (label ? 0x80 : 0));
+        output_.commit(destination + record_size);
+        ++count_;
+    }
+
+    void end()
+    {
+        write16(output_.data() + header_ + 8, static_cast<std::uint16_t>(count_));
+        write16(output_.data() + header_ + 10, static_cast<std::uint16_t>(count_ >> 16));
+    }
+
+private:
+    static void write16(char *destination, const std::uint16_t value) noexcept
+    {
+        destination[0] = static_cast<char>(value & 0xff);
+        destination[1] = static_cast<char>(value >> 8);
+    }
+
+    output_buffer &output_;
+    std::uint8_t flags_;
+    std::size_t header_;
+    std::uint32_t count_;
+};
+
+template <typename writer_t>
+static void write_items(const std::string &name, const aeon::common::span<const std::uint8_t> bytes,
+                        const std::uint16_t address, const listing_settings &settings, output_buffer &output)
+{
+    writer_t writer{output, settings};
+    writer.begin(name, address);
+
+    // Every decoder yields items that cover the input back to back, so the bytes of an item are found by
+    // counting lengths; addresses wrap in inputs larger than 64KB.
+    auto position = std::size_t{0};
+
+    const auto item = [&writer, &position, &bytes](const disasm6502::decoded_instruction &instruction,
+                                                   const bool label) {
+        writer.item(instruction, std::data(bytes) + position, label);
+        position += instruction.length;
+    };
+
+    disasm6502::decoded_instruction instruction;
+
+    if (settings.recursive)
+    {
+        // Recursive analysis follows addresses, so every byte needs one.
+        if (std::size(bytes) > 0x10000u - address)
+            throw std::runtime_error{"Recursive disassembly needs the input to end at or before $FFFF; use a lower "
+                                     "--offset or a smaller --range."};
+
+        const disasm6502::recursive_analysis analysis{bytes, address, settings.target, settings.entry_points};
+        disasm6502::recursive_decoder decoder{analysis};
+
+        while (decoder.next(instruction))
+            item(instruction, analysis.is_label(instruction.address));
+    }
+    else if (settings.sweep_threads > 1)
+    {
+        const disasm6502::parallel_sweep sweep{bytes, address, settings.target, settings.sweep_threads};
+        sweep.for_each([&item](const disasm6502::decoded_instruction &instruction) { item(instruction, false); });
+    }
+    else
+    {
+        disasm6502::linear_decoder decoder{bytes, address, settings.target};
+
+        while (decoder.next(instruction))
+            item(instruction, false);
+    }
+
+    writer.end();
+}
+
+void write_listing(const std::string &name, const aeon::common::span<const std::uint8_t> bytes,
+                   const std::uint16_t address, const listing_settings &settings, output_buffer &output)
+{
+    switch (settings.format)
+    {
+        case listing_format::text:
+            write_items<text_writer>(name, bytes, address, settings, output);
+            break;
+        case listing_format::json:
+            write_items<json_writer>(name, bytes, address, settings, output);
+            break;
+        case listing_format::binary:
+            write_items<binary_writer>(name, bytes, address, settings, output);
+            break;
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <disasm6502/decoder.h>
+#include <aeon/common/span.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace disasm6502
+{
+class symbol_table;
+} // namespace disasm6502
+
+/*!
+ * A growing block of output text. Items are formatted straight into it, and the whole buffer is written
+ * out at once.
+ */
+class output_buffer final
+{
+public:
+    output_buffer();
+    ~output_buffer() = default;
+
+    output_buffer(output_buffer &&) noexcept = default;
+    auto operator=(output_buffer &&) noexcept -> output_buffer & = default;
+
+    output_buffer(const output_buffer &) noexcept = delete;
+    auto operator=(const output_buffer &) noexcept -> output_buffer & = delete;
+
+    /*!
+     * Make room for at least size more bytes. Returns where to write them; pass the end of what was
+     * actually written to commit().
+     */
+    auto reserve(const std::size_t size) -> char *
+    {
+        if (std::size(data_) - size_ < size)
+            data_.resize(std::max(std::size(data_) * 2, size_ + size));
+
+        return std::data(data_) + size_;
+    }
+
+    void commit(const char *end) noexcept
+    {
+        size_ = static_cast<std::size_t>(end - std::data(data_));
+    }
+
+    void append(const char *text, const std::size_t size);
+    void append(const std::string &text);
+
+    auto data() noexcept
+    {
+        return std::data(data_);
+    }
+
+    auto data() const noexcept
+    {
+        return std::data(data_);
+    }
+
+    auto size() const noexcept
+    {
+        return size_;
+    }
+
+    auto empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    void clear() noexcept;
+
+private:
+    std::vector<char> data_;
+    std::size_t size_;
+};
+
+enum class listing_format
+{
+    text,
+    json,
+    binary
+};
+
+struct listing_settings
+{
+    listing_format format{listing_format::text};
+    disasm6502::cpu_target target{disasm6502::cpu_target::target_65c02};
+
+    // Follow control flow from the vectors and entry points instead of a linear sweep.
+    bool recursive{false};
+    std::vector<std::uint16_t> entry_points;
+
+    // Threads used for the linear sweep of one input.
+    std::size_t sweep_threads{1};
+
+    // Names for addresses, if any were loaded.
+    const disasm6502::symbol_table *symbols{nullptr};
+};
+
+/*!
+ * Disassemble bytes loaded at the given address and append the listing to the buffer.
+ *
+ * text: One line per item with the address, the bytes and the assembly. Addresses with a symbol get a
+ * label line, and so do branch, jump and call targets in recursive mode. An operand that refers to a
+ * symbol is annotated with "; name+offset".
+ *
+ * json: An object with the name, the start address and an array of items. Items carry the symbol at
+ * their address as "name" and the symbol their operand refers to as "symbol".
+ *
+ * binary: A 12 byte header: "D65L", a version byte (1), a flags byte (bit 0 set for recursive, the
+ * cpu_target in bits 1 and 2), the start address and the number of items, little endian. Then one 8
+ * byte record per item: address, operand, opcode, length, addressing mode and kind, with bit 7 of the
+ * kind set for labels.
+ */
+void write_listing(const std::string &name, const aeon::common::span<const std::uint8_t> bytes,
+                   const std::uint16_t address, const listing_settings &settings, output_buffer &output);
+
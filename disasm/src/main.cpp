@@ -1,79 +1,402 @@
-#include <disasm6502/disasm.h>
-#include <aeon/streams/file_stream.h>
-#include <aeon/common/string.h>
+#include <input_file.h>
+#include <listing.h>
+#include <disasm6502/symbol_table.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
-#include <array>
-#include <vector>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string>
-#include <filesystem>
+#include <thread>
+#include <vector>
 
-auto load_from_stdin() -> std::vector<std::uint8_t>
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+struct options
+{
+    std::uint16_t offset{0x8000};
+    std::size_t range_begin{0};
+    std::size_t range_end{std::numeric_limits<std::size_t>::max()};
+    listing_settings listing;
+    std::vector<std::filesystem::path> symbol_files;
+    std::optional<std::filesystem::path> output_directory;
+    std::size_t thread_count{0};
+    std::vector<std::string> inputs;
+};
+
+/*!
+ * One input and its listing. Listings are made in parallel but written to standard output in the order
+ * of the inputs.
+ */
+struct job
 {
-    std::freopen(nullptr, "rb", stdin);
+    std::string input;
+    output_buffer output;
+    std::string error;
+    bool done{false};
+};
 
-    if(std::ferror(stdin))
-        throw std::runtime_error(std::strerror(errno));
+static void print_usage()
+{
+    std::cerr << "Usage: disasm [options] [file ...]\n"
+                 "  --offset ADDRESS      Address the first byte of each file is loaded at (default $8000)\n"
+                 "  --range BEGIN:END     Only disassemble these bytes of each file; either side may be omitted\n"
+                 "  --cpu CPU             6502, 6502-undocumented, 65c02 or w65c02 (default 65c02)\n"
+                 "  --format text|json|binary\n"
+                 "  --recursive           Follow control flow from the vectors and entry points\n"
+                 "  --entry ADDRESS       Extra entry point for --recursive; may be repeated\n"
+                 "  --symbols FILE        Label addresses from a ca65 .dbg, VICE label or \"name = $addr\" file;\n"
+                 "                        may be repeated\n"
+                 "  --output-dir DIR      Write each listing to DIR instead of standard output\n"
+                 "  --threads N           Number of threads; 0 uses one per hardware thread\n"
+                 "Numbers are decimal, or hex with a $ or 0x prefix. Without files, standard input is read.\n";
+}
 
-    std::vector<std::uint8_t> input;
-    std::array<char, 1024> buf{};
-    std::size_t len;
+static auto parse_number(const std::string &text, const std::uint64_t max) -> std::uint64_t
+{
+    auto digits = text;
+    auto base = 10;
 
-    while((len = std::fread(std::data(buf), 1, std::size(buf), stdin)) > 0)
+    if (!std::empty(digits) && digits[0] == '$')
+    {
+        digits.erase(0, 1);
+        base = 16;
+    }
+    else if (std::size(digits) > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'))
     {
-        if(std::ferror(stdin) && !std::feof(stdin))
-            throw std::runtime_error(std::strerror(errno));
+        digits.erase(0, 2);
+        base = 16;
+    }
+
+    std::size_t used = 0;
+    std::uint64_t value = 0;
 
-        input.insert(std::end(input), std::data(buf), std::data(buf) + len);
+    try
+    {
+        value = std::stoull(digits, &used, base);
+    }
+    catch (const std::exception &)
+    {
+        used = 0;
     }
 
-    return input;
+    if (std::empty(digits) || used != std::size(digits) || value > max)
+        throw std::runtime_error{"Invalid number: " + text};
+
+    return value;
 }
 
-auto load_from_file(const std::filesystem::path &path) -> std::vector<std::uint8_t>
+static auto parse_range(const std::string &text, options &result)
 {
-    aeon::streams::file_stream input{path};
-    return input.read_to_vector();
+    const auto separator = text.find(':');
+
+    if (separator == std::string::npos)
+        throw std::runtime_error{"Invalid range: " + text};
+
+    const auto begin = text.substr(0, separator);
+    const auto end = text.substr(separator + 1);
+    const auto max = std::numeric_limits<std::size_t>::max();
+
+    if (!std::empty(begin))
+        result.range_begin = static_cast<std::size_t>(parse_number(begin, max));
+
+    if (!std::empty(end))
+        result.range_end = static_cast<std::size_t>(parse_number(end, max));
 }
 
-int main(int argc, char *argv[])
+static auto parse_options(const int argc, char *argv[]) -> std::optional<options>
 {
-    // TODO: Grab from arguments.
-    const std::uint16_t offset = 0x8000;
+    options result;
 
-    try
+    for (auto i = 1; i < argc; ++i)
     {
-        disasm6502::initialize();
+        const std::string argument{argv[i]};
+
+        if (argument.rfind("--", 0) != 0)
+        {
+            result.inputs.push_back(argument);
+            continue;
+        }
+
+        if (argument == "--recursive")
+        {
+            result.listing.recursive = true;
+            continue;
+        }
 
-        std::vector<std::uint8_t> input;
+        if (i + 1 == argc)
+            return std::nullopt;
 
-        if (argc == 1)
+        const std::string value{argv[++i]};
+
+        if (argument == "--offset")
+        {
+            result.offset = static_cast<std::uint16_t>(parse_number(value, 0xffff));
+        }
+        else if (argument == "--range")
+        {
+            parse_range(value, result);
+        }
+        else if (argument == "--cpu")
+        {
+            if (value == "6502")
+                result.listing.target = disasm6502::cpu_target::target_6502;
+            else if (value == "6502-undocumented")
+                result.listing.target = disasm6502::cpu_target::target_6502_undocumented;
+            else if (value == "65c02")
+                result.listing.target = disasm6502::cpu_target::target_65c02;
+            else if (value == "w65c02")
+                result.listing.target = disasm6502::cpu_target::target_wdc_65c02;
+            else
+                return std::nullopt;
+        }
+        else if (argument == "--format")
+        {
+            if (value == "text")
+                result.listing.format = listing_format::text;
+            else if (value == "json")
+                result.listing.format = listing_format::json;
+            else if (value == "binary")
+                result.listing.format = listing_format::binary;
+            else
+                return std::nullopt;
+        }
+        else if (argument == "--entry")
+        {
+            result.listing.entry_points.push_back(static_cast<std::uint16_t>(parse_number(value, 0xffff)));
+        }
+        else if (argument == "--symbols")
+        {
+            result.symbol_files.emplace_back(value);
+        }
+        else if (argument == "--output-dir")
+        {
+            result.output_directory = value;
+        }
+        else if (argument == "--threads")
         {
-            input = load_from_stdin();
+            result.thread_count = static_cast<std::size_t>(parse_number(value, 1024));
         }
         else
         {
-            input = load_from_file(argv[1]);
+            return std::nullopt;
         }
+    }
+
+    if (result.range_begin > result.range_end)
+        throw std::runtime_error{"The range ends before it begins."};
+
+    if (std::empty(result.inputs))
+        result.inputs.emplace_back("-");
+
+    return result;
+}
+
+static void write_all(std::FILE *file, const char *data, const std::size_t size)
+{
+    if (std::fwrite(data, 1, size, file) != size)
+        throw std::runtime_error{"Could not write the output."};
+}
+
+static auto output_path(const std::filesystem::path &directory, const std::string &input, const listing_format format)
+{
+    const auto name = input == "-" ? std::string{"stdin"} : std::filesystem::path{input}.filename().string();
+
+    switch (format)
+    {
+        case listing_format::json:
+            return directory / (name + ".json");
+        case listing_format::binary:
+            return directory / (name + ".bin");
+        case listing_format::text:
+        default:
+            return directory / (name + ".asm");
+    }
+}
+
+static void run_job(job &job, const options &options)
+{
+    try
+    {
+        const auto input = job.input == "-" ? std::make_unique<input_file>(stdin)
+                                            : std::make_unique<input_file>(std::filesystem::path{job.input});
+
+        const auto bytes = input->bytes();
+        const auto begin = std::min(options.range_begin, std::size(bytes));
+        const auto end = std::min(options.range_end, std::size(bytes));
+        const aeon::common::span<const std::uint8_t> range{std::data(bytes) + begin, end - begin};
+
+        write_listing(job.input, range, static_cast<std::uint16_t>(options.offset + begin), options.listing,
+                      job.output);
+
+        if (!options.output_directory)
+            return;
+
+        const auto path = output_path(*options.output_directory, job.input, options.listing.format);
+        auto *file = std::fopen(path.string().c_str(), "wb");
+
+        if (!file)
+            throw std::runtime_error{"Could not create " + path.string() + "."};
+
+        const auto written = std::fwrite(job.output.data(), 1, job.output.size(), file);
+        const auto closed = std::fclose(file) == 0;
 
-        const auto disassembled_file = disasm6502::disassemble(aeon::common::span{input}, offset);
+        if (written != job.output.size() || !closed)
+            throw std::runtime_error{"Could not write " + path.string() + "."};
+
+        job.output = output_buffer{};
+    }
+    catch (const std::exception &e)
+    {
+        job.error = e.what();
+    }
+}
+
+/*!
+ * Process all inputs on a pool of threads. With standard output as the target, listings are written in
+ * order as soon as they are done; workers don't run too far ahead, so only a few listings are held in
+ * memory at a time.
+ */
+static auto run_jobs(std::vector<job> &jobs, const options &options, const std::size_t thread_count) -> bool
+{
+    const auto to_stdout = !options.output_directory;
+    const auto max_pending = thread_count * 2;
+    const auto several = std::size(jobs) > 1;
+    const auto format = options.listing.format;
 
-        for (const auto &disassembled : disassembled_file)
+    std::mutex mutex;
+    std::condition_variable changed;
+    auto next_job = std::size_t{0};
+    auto written = std::size_t{0};
+
+    const auto worker = [&]() {
+        for (;;)
         {
-            std::string assembly_string;
-            for (const auto byte : disassembled.bytes())
+            std::size_t index;
+
+            {
+                std::unique_lock lock{mutex};
+                changed.wait(lock, [&]() { return !to_stdout || next_job - written < max_pending; });
+
+                if (next_job >= std::size(jobs))
+                    return;
+
+                index = next_job++;
+            }
+
+            run_job(jobs[index], options);
+
             {
-                assembly_string += aeon::common::string::int_to_hex_string(byte) + ' ';
+                std::lock_guard lock{mutex};
+                jobs[index].done = true;
             }
 
-            assembly_string.resize(std::size(assembly_string) - 1);
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (auto i = std::size_t{0}; i < thread_count; ++i)
+        workers.emplace_back(worker);
+
+    auto success = true;
+
+    for (auto index = std::size_t{0}; index < std::size(jobs); ++index)
+    {
+        auto &job = jobs[index];
+
+        {
+            std::unique_lock lock{mutex};
+            changed.wait(lock, [&job]() { return job.done; });
+        }
+
+        if (!std::empty(job.error))
+        {
+            std::cerr << job.input << ": " << job.error << '\n';
+            success = false;
+        }
+        else if (to_stdout)
+        {
+            // Several listings on one output still form one document: a JSON array, or text with a
+            // comment line naming each input. Binary listings delimit themselves.
+            std::string prefix;
+
+            if (several && format == listing_format::json)
+                prefix = index == 0 ? "[" : ",";
+            else if (several && format == listing_format::text)
+                prefix = (index == 0 ? "; " : "\n; ") + job.input + '\n';
+
+            write_all(stdout, std::data(prefix), std::size(prefix));
+            write_all(stdout, job.output.data(), job.output.size());
+        }
+
+        job.output = output_buffer{};
 
-            std::cout << std::left << std::setw(8) << aeon::common::string::int_to_hex_string(disassembled.address());
-            std::cout << std::left << std::setw(16) << assembly_string;
-            std::cout << disassembled.disassembly();
-            std::cout << '\n';
+        {
+            std::lock_guard lock{mutex};
+            ++written;
         }
 
-        return 0;
+        changed.notify_all();
+    }
+
+    for (auto &thread : workers)
+        thread.join();
+
+    if (to_stdout && several && format == listing_format::json)
+        write_all(stdout, "]\n", 2);
+
+    std::fflush(stdout);
+    return success;
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        const auto options = parse_options(argc, argv);
+
+        if (!options)
+        {
+            print_usage();
+            return 1;
+        }
+
+        disasm6502::symbol_table symbols;
+        for (const auto &path : options->symbol_files)
+            symbols.load(path);
+
+        if (options->output_directory)
+            std::filesystem::create_directories(*options->output_directory);
+
+#if defined(_WIN32)
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+        std::vector<job> jobs(std::size(options->inputs));
+        for (auto i = std::size_t{0}; i < std::size(jobs); ++i)
+            jobs[i].input = options->inputs[i];
+
+        const auto thread_count = std::max<std::size_t>(
+            options->thread_count != 0 ? options->thread_count : std::thread::hardware_concurrency(), 1);
+        const auto job_threads = std::min(thread_count, std::size(jobs));
+
+        // Threads that no file needs help decode the linear sweep of each file.
+        auto job_options = *options;
+        job_options.listing.sweep_threads = std::max<std::size_t>(thread_count / std::size(jobs), 1);
+
+        if (!symbols.empty())
+            job_options.listing.symbols = &symbols;
+
+        return run_jobs(jobs, job_options, job_threads) ? 0 : 1;
     }
     catch (const std::exception &e)
     {
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <aeon/common/span.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace disasm6502
+{
+
+/*!
+ * target_6502: The NMOS 6502 with its documented instructions.
+ * target_6502_undocumented: The NMOS 6502 including the undocumented opcodes.
+ * target_65c02: The CMOS 65C02.
+ * target_wdc_65c02: The WDC 65C02, which adds the bit manipulation instructions, wai and stp.
+ */
+enum class cpu_target
+{
+    target_6502,
+    target_6502_undocumented,
+    target_65c02,
+    target_wdc_65c02
+};
+
+enum class addressing_mode : std::uint8_t
+{
+    implied,
+    accumulator,
+    immediate,
+    zero_page,
+    zero_page_x,
+    zero_page_y,
+    absolute,
+    absolute_x,
+    absolute_y,
+    relative,
+    indexed_indirect_x,
+    indirect_indexed_y,
+    absolute_indirect,
+    zero_page_indirect,
+    absolute_indexed_indirect,
+    zero_page_relative
+};
+
+/*!
+ * instruction: An opcode with its operand.
+ * data_byte: A byte that is not a known opcode, or an instruction cut off by the end of the input.
+ * data_word: A 16-bit interrupt vector.
+ */
+enum class record_kind : std::uint8_t
+{
+    instruction,
+    data_byte,
+    data_word
+};
+
+/*!
+ * One decoded instruction or data item. The operand holds the operand bytes in little endian order
+ * (the raw offset for relative branches, which bbr and bbs have in the high byte), or the value of a
+ * data item. Plain data, so decoding a whole image never allocates.
+ */
+struct decoded_instruction
+{
+    std::uint16_t address;
+    std::uint16_t operand;
+    std::uint8_t opcode;
+    std::uint8_t length;
+    addressing_mode mode;
+    record_kind kind;
+};
+
+/*!
+ * Address a relative branch goes to when it is taken.
+ */
+constexpr auto branch_target(const decoded_instruction &instruction) noexcept -> std::uint16_t
+{
+    const auto offset = instruction.mode == addressing_mode::zero_page_relative ? instruction.operand >> 8
+                                                                                : instruction.operand;
+    return static_cast<std::uint16_t>(instruction.address + instruction.length + static_cast<std::int8_t>(offset));
+}
+
+/*!
+ * The address an item refers to: the memory operand of an instruction, the target of a branch, or the
+ * value of an interrupt vector. Nothing for immediate and implied operands or data bytes.
+ */
+auto referenced_address(const decoded_instruction &instruction) noexcept -> std::optional<std::uint16_t>;
+
+/*!
+ * Decode the item at the start of the given bytes, which must not be empty. Opcodes that are not part
+ * of the target's instruction set become data bytes.
+ */
+auto decode(const aeon::common::span<const std::uint8_t> bytes, const std::uint16_t address,
+            const cpu_target target) noexcept -> decoded_instruction;
+
+/*!
+ * Linear sweep over a block of bytes: every item starts right after the previous one.
+ */
+class linear_decoder final
+{
+public:
+    explicit linear_decoder(const aeon::common::span<const std::uint8_t> bytes, const std::uint16_t offset,
+                            const cpu_target target) noexcept;
+    ~linear_decoder() = default;
+
+    linear_decoder(linear_decoder &&) noexcept = default;
+    auto operator=(linear_decoder &&) noexcept -> linear_decoder & = default;
+
+    linear_decoder(const linear_decoder &) noexcept = default;
+    auto operator=(const linear_decoder &) noexcept -> linear_decoder & = default;
+
+    /*!
+     * Decode the next item. Returns false at the end of the input.
+     */
+    auto next(decoded_instruction &instruction) noexcept -> bool;
+
+    /*!
+     * Offset into the input of the next item.
+     */
+    auto position() const noexcept
+    {
+        return position_;
+    }
+
+private:
+    aeon::common::span<const std::uint8_t> bytes_;
+    std::size_t position_;
+    std::uint16_t address_;
+    cpu_target target_;
+};
+
+} // namespace disasm6502
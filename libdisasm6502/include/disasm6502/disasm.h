@@ -1,6 +1,8 @@
 #pragma once
 
+#include <disasm6502/decoder.h>
 #include <aeon/common/span.h>
+#include <string>
 #include <vector>
 
 namespace disasm6502
@@ -46,15 +48,11 @@ private:
     aeon::common::span<std::uint8_t> bytes_;
 };
 
-enum class cpu_target
-{
-    target_6502,
-    target_65c02
-};
-
-void initialize(const cpu_target target = cpu_target::target_65c02);
-
-auto disassemble(const aeon::common::span<std::uint8_t> bytes, const std::uint16_t offset = 0)
-    -> std::vector<disassembled_instruction>;
+/*!
+ * Linear sweep that returns the text of every item. Convenient, but every item owns a string; use
+ * linear_decoder and format() to disassemble without allocating.
+ */
+auto disassemble(const aeon::common::span<std::uint8_t> bytes, const std::uint16_t offset = 0,
+                 const cpu_target target = cpu_target::target_65c02) -> std::vector<disassembled_instruction>;
 
 } // namespace disasm6502
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <disasm6502/decoder.h>
+#include <aeon/common/span.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace disasm6502
+{
+
+/*!
+ * Items returned by disassembly_cache::window(): size is the number of items written, current the index
+ * of the item that contains the requested address.
+ */
+struct disassembly_window
+{
+    std::size_t size;
+    std::size_t current;
+};
+
+/*!
+ * Linear sweep disassembly of an address range that is kept up to date as the memory changes, for views
+ * that follow a running machine.
+ *
+ * The decoded item is stored at its start address. Since items cover the range back to back, the item
+ * after one starts where it ends and the item before one is the one of at most 3 bytes that ends where
+ * it starts. Walking N items in either direction from any address is therefore N steps, no matter how
+ * large the range is.
+ *
+ * A write only decodes again from the item that contains the written byte, until the new items line up
+ * with an item start of the old decode past the write.
+ */
+class disassembly_cache final
+{
+public:
+    /*!
+     * Disassemble a copy of the bytes, which are at the given address. At most 64KB.
+     */
+    explicit disassembly_cache(const aeon::common::span<const std::uint8_t> bytes, const std::uint16_t address,
+                               const cpu_target target);
+    ~disassembly_cache() = default;
+
+    disassembly_cache(disassembly_cache &&) noexcept = default;
+    auto operator=(disassembly_cache &&) noexcept -> disassembly_cache & = default;
+
+    disassembly_cache(const disassembly_cache &) noexcept = delete;
+    auto operator=(const disassembly_cache &) noexcept -> disassembly_cache & = delete;
+
+    auto begin_address() const noexcept
+    {
+        return address_;
+    }
+
+    auto size() const noexcept
+    {
+        return std::size(bytes_);
+    }
+
+    auto target() const noexcept
+    {
+        return target_;
+    }
+
+    auto contains(const std::uint16_t address) const noexcept -> bool
+    {
+        return offset_of(address) < std::size(bytes_);
+    }
+
+    /*!
+     * Update the cache after a write to memory. Writes outside the range are ignored, so every write to
+     * the bus can be passed on.
+     */
+    void write(const std::uint16_t address, const std::uint8_t value) noexcept;
+
+    /*!
+     * Make an item start at this address, for example the program counter when the linear sweep went out
+     * of step with the code that is executing. The bytes before it that no longer form a whole item
+     * become data bytes. Lasts until a write decodes this part of the range again.
+     */
+    void resynchronize(const std::uint16_t address) noexcept;
+
+    /*!
+     * The item that contains the address, which must be in the range.
+     */
+    auto item(const std::uint16_t address) const noexcept -> const decoded_instruction &;
+
+    /*!
+     * Write up to before items preceding the item that contains the address, that item, and up to after
+     * items following it, in order. The output needs room for before + after + 1 items. Returns an empty
+     * window for an address outside the range.
+     */
+    auto window(const std::uint16_t address, const std::size_t before, const std::size_t after,
+                decoded_instruction *output) const noexcept -> disassembly_window;
+
+private:
+    auto offset_of(const std::uint16_t address) const noexcept -> std::size_t
+    {
+        return static_cast<std::uint16_t>(address - address_);
+    }
+
+    auto is_start(const std::size_t offset) const noexcept
+    {
+        return items_[offset].length != 0;
+    }
+
+    auto start_of(const std::size_t offset) const noexcept -> std::size_t;
+    void decode_at(const std::size_t offset) noexcept;
+    void redecode(std::size_t offset, const std::size_t last_changed) noexcept;
+
+    std::uint16_t address_;
+    cpu_target target_;
+    std::vector<std::uint8_t> bytes_;
+
+    // The item starting at each offset; length 0 where no item starts.
+    std::vector<decoded_instruction> items_;
+};
+
+} // namespace disasm6502
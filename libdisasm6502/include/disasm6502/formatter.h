@@ -0,0 +1,28 @@
+#pragma once
+
+#include <disasm6502/decoder.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace disasm6502
+{
+
+/*!
+ * The longest text format() writes, for example "lda $(12),Y" or ".dw #$fffe".
+ */
+inline constexpr std::size_t max_formatted_length = 16;
+
+/*!
+ * Write the assembly text of an item, decoded for the given target, into a buffer of at least
+ * max_formatted_length characters. Returns the number of characters written; no terminating null is
+ * added.
+ */
+auto format(const decoded_instruction &instruction, char *buffer, const cpu_target target) noexcept -> std::size_t;
+
+/*!
+ * Write a byte or word as lowercase hex digits, 2 or 4 characters. Returns the end of the written text.
+ */
+auto format_hex8(const std::uint8_t value, char *buffer) noexcept -> char *;
+auto format_hex16(const std::uint16_t value, char *buffer) noexcept -> char *;
+
+} // namespace disasm6502
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <disasm6502/decoder.h>
+#include <aeon/common/span.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace disasm6502
+{
+
+/*!
+ * Linear sweep of a large image split into chunks that are decoded concurrently. The result is the same
+ * sequence of items linear_decoder produces.
+ *
+ * Every chunk is first decoded as if an instruction started at its first byte. Afterwards each chunk is
+ * checked against where the last instruction of the chunk before it really ended. If that instruction
+ * reached into the chunk, the chunk is decoded again from the real boundary, but only until it meets an
+ * instruction start of the first decode; from there on both decodes are identical. The re-decoded head
+ * is kept apart from the rest, so no records are moved to merge the chunks.
+ */
+class parallel_sweep final
+{
+public:
+    explicit parallel_sweep(const aeon::common::span<const std::uint8_t> bytes, const std::uint16_t offset,
+                            const cpu_target target, const std::size_t thread_count = 0,
+                            const std::size_t min_chunk_size = 16 * 1024);
+    ~parallel_sweep() = default;
+
+    parallel_sweep(parallel_sweep &&) noexcept = default;
+    auto operator=(parallel_sweep &&) noexcept -> parallel_sweep & = default;
+
+    parallel_sweep(const parallel_sweep &) noexcept = delete;
+    auto operator=(const parallel_sweep &) noexcept -> parallel_sweep & = delete;
+
+    auto chunk_count() const noexcept
+    {
+        return std::size(chunks_);
+    }
+
+    /*!
+     * Total number of items.
+     */
+    auto size() const noexcept -> std::size_t;
+
+    /*!
+     * Call function(const decoded_instruction &) for every item of one chunk, in order. Chunks can be
+     * visited concurrently, for example to format them in parallel.
+     */
+    template <typename function_t>
+    void for_each_in_chunk(const std::size_t index, function_t &&function) const
+    {
+        const auto &current_chunk = chunks_[index];
+
+        for (const auto &instruction : current_chunk.head)
+            function(instruction);
+
+        for (auto i = current_chunk.first; i < std::size(current_chunk.records); ++i)
+            function(current_chunk.records[i]);
+    }
+
+    /*!
+     * Call function(const decoded_instruction &) for every item, in order.
+     */
+    template <typename function_t>
+    void for_each(function_t &&function) const
+    {
+        for (auto i = std::size_t{0}; i < std::size(chunks_); ++i)
+            for_each_in_chunk(i, function);
+    }
+
+private:
+    struct chunk
+    {
+        std::size_t begin;
+        std::size_t end;
+
+        // Records decoded from the real instruction boundary, where it differs from the start of the chunk.
+        std::vector<decoded_instruction> head;
+
+        // The speculative decode, valid from index first onward.
+        std::vector<decoded_instruction> records;
+        std::size_t first;
+
+        // Position right after the last instruction of the chunk.
+        std::size_t next;
+    };
+
+    auto remaining(const std::size_t position) const noexcept -> aeon::common::span<const std::uint8_t>;
+    void decode_chunk(chunk &current_chunk) const noexcept;
+    void resynchronize(chunk &current_chunk, const std::size_t boundary) const;
+
+    aeon::common::span<const std::uint8_t> bytes_;
+    std::uint16_t offset_;
+    cpu_target target_;
+    std::vector<chunk> chunks_;
+};
+
+} // namespace disasm6502
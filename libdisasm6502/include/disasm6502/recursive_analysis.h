@@ -0,0 +1,151 @@
+#pragma once
+
+#include <disasm6502/decoder.h>
+#include <aeon/common/span.h>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace disasm6502
+{
+
+/*!
+ * A run of instructions that is only entered at its first instruction and only left after its last.
+ * End is one past the last byte. Successors are the blocks control can continue in: the target and the
+ * fall through of a branch, the target of a jump, or the next block when a block simply runs into it.
+ * Calls don't end a block.
+ */
+struct basic_block
+{
+    std::uint16_t start;
+    std::uint32_t end;
+    std::array<std::uint16_t, 2> successors;
+    std::uint8_t successor_count;
+};
+
+/*!
+ * Recursive traversal of an image: decoding starts at the entry points and follows every branch, jump
+ * and call, so data embedded between code can't desynchronize it. Every byte that is not reached as
+ * part of an instruction is data.
+ *
+ * Targets of indirect jumps and return addresses are not known statically; code only reached that way
+ * needs an explicit entry point. A target that would decode over the middle of an instruction found
+ * earlier is labelled but not decoded again.
+ */
+class recursive_analysis final
+{
+public:
+    /*!
+     * Analyze an image loaded at the given offset. If use_vectors is set, the NMI, reset and IRQ vectors
+     * are entry points too, as far as the image contains them. Bytes that would be loaded past $FFFF are
+     * ignored, so image() can be shorter than the given image.
+     */
+    explicit recursive_analysis(const aeon::common::span<const std::uint8_t> image, const std::uint16_t offset,
+                                const cpu_target target, const std::vector<std::uint16_t> &entry_points = {},
+                                const bool use_vectors = true);
+    ~recursive_analysis() = default;
+
+    recursive_analysis(recursive_analysis &&) noexcept = default;
+    auto operator=(recursive_analysis &&) noexcept -> recursive_analysis & = default;
+
+    recursive_analysis(const recursive_analysis &) noexcept = delete;
+    auto operator=(const recursive_analysis &) noexcept -> recursive_analysis & = delete;
+
+    auto image() const noexcept
+    {
+        return image_;
+    }
+
+    auto offset() const noexcept
+    {
+        return offset_;
+    }
+
+    auto target() const noexcept
+    {
+        return target_;
+    }
+
+    /*!
+     * True for every byte that is part of a reachable instruction.
+     */
+    auto is_code(const std::uint16_t address) const noexcept -> bool
+    {
+        return code_[address];
+    }
+
+    auto is_instruction_start(const std::uint16_t address) const noexcept -> bool
+    {
+        return instruction_start_[address];
+    }
+
+    /*!
+     * True for entry points and the targets of branches, jumps and calls, including targets outside the image.
+     */
+    auto is_label(const std::uint16_t address) const noexcept -> bool
+    {
+        return label_[address];
+    }
+
+    /*!
+     * Basic blocks in address order.
+     */
+    auto blocks() const noexcept -> const std::vector<basic_block> &
+    {
+        return blocks_;
+    }
+
+private:
+    auto contains(const std::uint32_t address) const noexcept -> bool;
+    void trace(const std::uint16_t entry_point, std::vector<std::uint16_t> &worklist) noexcept;
+    void build_blocks();
+
+    aeon::common::span<const std::uint8_t> image_;
+    std::uint16_t offset_;
+    cpu_target target_;
+
+    std::bitset<0x10000> code_;
+    std::bitset<0x10000> instruction_start_;
+    std::bitset<0x10000> label_;
+
+    // Instructions that start a basic block besides the labels: the fall through of a branch, and code
+    // that another trace ran into.
+    std::bitset<0x10000> leader_;
+
+    std::vector<basic_block> blocks_;
+};
+
+/*!
+ * Walks an analyzed image from start to end, like linear_decoder, but yields the instructions found by
+ * the analysis and data items for all other bytes.
+ */
+class recursive_decoder final
+{
+public:
+    explicit recursive_decoder(const recursive_analysis &analysis) noexcept;
+    ~recursive_decoder() = default;
+
+    recursive_decoder(recursive_decoder &&) noexcept = default;
+    auto operator=(recursive_decoder &&) noexcept -> recursive_decoder & = delete;
+
+    recursive_decoder(const recursive_decoder &) noexcept = default;
+    auto operator=(const recursive_decoder &) noexcept -> recursive_decoder & = delete;
+
+    /*!
+     * Decode the next item. Returns false at the end of the image.
+     */
+    auto next(decoded_instruction &instruction) noexcept -> bool;
+
+    auto position() const noexcept
+    {
+        return position_;
+    }
+
+private:
+    const recursive_analysis &analysis_;
+    std::size_t position_;
+};
+
+} // namespace disasm6502
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <disasm6502/decoder.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace disasm6502
+{
+
+/*!
+ * A symbol an address belongs to, and how far past the symbol the address lies.
+ */
+struct symbol_match
+{
+    std::string_view name;
+    std::uint16_t offset;
+};
+
+/*!
+ * Names for addresses, loaded from symbol files, for annotating listings and traces.
+ *
+ * Symbols are kept in a flat array sorted by address, with all names in a single string. On top of that,
+ * a table with an entry for each of the 64K addresses points at the nearest symbol at or below it, so
+ * every lookup is a single index and never allocates. When several symbols share an address, the one
+ * loaded first is used.
+ */
+class symbol_table final
+{
+public:
+    /*!
+     * Addresses more than max_offset bytes past the nearest symbol are not annotated.
+     */
+    explicit symbol_table(const std::uint16_t max_offset = 0xff);
+    ~symbol_table() = default;
+
+    symbol_table(symbol_table &&) noexcept = default;
+    auto operator=(symbol_table &&) noexcept -> symbol_table & = default;
+
+    symbol_table(const symbol_table &) noexcept = delete;
+    auto operator=(const symbol_table &) noexcept -> symbol_table & = delete;
+
+    /*!
+     * Load a symbol file, detecting its format from the contents: a ca65/ld65 debug info file (.dbg),
+     * a VICE label file ("al C:1234 .name"), or plain assignments ("name = $1234"). Throws on errors.
+     */
+    void load(const std::filesystem::path &path);
+
+    void load_ca65_debug_info(const std::string_view text);
+    void load_vice_labels(const std::string_view text);
+    void load_assignments(const std::string_view text);
+
+    void add(const std::string_view name, const std::uint16_t address);
+
+    auto size() const noexcept
+    {
+        return std::size(symbols_);
+    }
+
+    auto empty() const noexcept
+    {
+        return std::empty(symbols_);
+    }
+
+    /*!
+     * The symbol at exactly this address, if any.
+     */
+    auto exact(const std::uint16_t address) const noexcept -> std::optional<std::string_view>;
+
+    /*!
+     * The nearest symbol at or below this address, within max_offset bytes.
+     */
+    auto find(const std::uint16_t address) const noexcept -> std::optional<symbol_match>;
+
+private:
+    struct symbol
+    {
+        std::uint16_t address;
+        std::uint32_t name_offset;
+        std::uint32_t name_length;
+    };
+
+    static constexpr std::uint32_t no_symbol = 0xffffffff;
+
+    void insert(const std::string_view name, const std::uint16_t address);
+    void build_index();
+
+    auto name(const symbol &entry) const noexcept -> std::string_view
+    {
+        return std::string_view{names_}.substr(entry.name_offset, entry.name_length);
+    }
+
+    std::uint16_t max_offset_;
+    std::vector<symbol> symbols_;
+    std::string names_;
+    std::vector<std::uint32_t> index_;
+};
+
+/*!
+ * Write "name" or "name+offset" for the address an item refers to. Returns the number of characters
+ * written, which is 0 if the item refers to no address or no symbol covers it; no terminating null is
+ * added. The text is cut off at capacity characters.
+ */
+auto format_symbol(const decoded_instruction &instruction, const symbol_table &symbols, char *buffer,
+                   const std::size_t capacity) noexcept -> std::size_t;
+
+auto format_symbol(const symbol_match &match, char *buffer, const std::size_t capacity) noexcept -> std::size_t;
+
+} // namespace disasm6502
@@ -0,0 +1,86 @@
+#include <disasm6502/decoder.h>
+#include <opcode_table.h>
+
+namespace disasm6502
+{
+
+static auto is_interrupt_vector_address(const std::uint16_t address) noexcept
+{
+    return address == 0xfffa || address == 0xfffc || address == 0xfffe;
+}
+
+auto referenced_address(const decoded_instruction &instruction) noexcept -> std::optional<std::uint16_t>
+{
+    if (instruction.kind == record_kind::data_word)
+        return instruction.operand;
+
+    if (instruction.kind != record_kind::instruction)
+        return std::nullopt;
+
+    switch (instruction.mode)
+    {
+        case addressing_mode::implied:
+        case addressing_mode::accumulator:
+        case addressing_mode::immediate:
+            return std::nullopt;
+        case addressing_mode::relative:
+            return branch_target(instruction);
+        default:
+            return instruction.operand;
+    }
+}
+
+auto decode(const aeon::common::span<const std::uint8_t> bytes, const std::uint16_t address,
+            const cpu_target target) noexcept -> decoded_instruction
+{
+    const auto *data = std::data(bytes);
+    const auto size = std::size(bytes);
+
+    // Special case for the interrupt vector table
+    if (is_interrupt_vector_address(address) && size >= 2)
+    {
+        return {address, static_cast<std::uint16_t>(data[0] | (data[1] << 8)), data[0], 2, addressing_mode::absolute,
+                record_kind::data_word};
+    }
+
+    const auto &info = opcodes(target)[data[0]];
+    const auto length = instruction_length(info.mode);
+
+    if (info.mnemonic == nullptr || size < length)
+        return {address, data[0], data[0], 1, addressing_mode::immediate, record_kind::data_byte};
+
+    std::uint16_t operand = 0;
+
+    if (length > 1)
+        operand = data[1];
+
+    if (length > 2)
+        operand |= static_cast<std::uint16_t>(data[2] << 8);
+
+    return {address, operand, data[0], length, info.mode, record_kind::instruction};
+}
+
+linear_decoder::linear_decoder(const aeon::common::span<const std::uint8_t> bytes, const std::uint16_t offset,
+                               const cpu_target target) noexcept
+    : bytes_{bytes}
+    , position_{}
+    , address_{offset}
+    , target_{target}
+{
+}
+
+auto linear_decoder::next(decoded_instruction &instruction) noexcept -> bool
+{
+    const auto size = std::size(bytes_);
+
+    if (position_ >= size)
+        return false;
+
+    instruction = decode(aeon::common::span<const std::uint8_t>{std::data(bytes_) + position_, size - position_},
+                         address_, target_);
+    position_ += instruction.length;
+    address_ += instruction.length;
+    return true;
+}
+
+} // namespace disasm6502
@@ -0,0 +1,112 @@
+#include <disasm6502/disassembly_cache.h>
+#include <stdexcept>
+
+namespace disasm6502
+{
+
+disassembly_cache::disassembly_cache(const aeon::common::span<const std::uint8_t> bytes, const std::uint16_t address,
+                                     const cpu_target target)
+    : address_{address}
+    , target_{target}
+    , bytes_(std::begin(bytes), std::end(bytes))
+    , items_(std::size(bytes))
+{
+    if (std::size(bytes_) > 0x10000)
+        throw std::runtime_error{"A disassembly cache covers at most 64KB."};
+
+    for (auto offset = std::size_t{0}; offset < std::size(bytes_); offset += items_[offset].length)
+        decode_at(offset);
+}
+
+void disassembly_cache::write(const std::uint16_t address, const std::uint8_t value) noexcept
+{
+    const auto offset = offset_of(address);
+
+    if (offset >= std::size(bytes_) || bytes_[offset] == value)
+        return;
+
+    bytes_[offset] = value;
+    redecode(start_of(offset), offset);
+}
+
+void disassembly_cache::resynchronize(const std::uint16_t address) noexcept
+{
+    const auto offset = offset_of(address);
+
+    if (offset >= std::size(bytes_) || is_start(offset))
+        return;
+
+    for (auto data = start_of(offset); data < offset; ++data)
+    {
+        const auto byte = bytes_[data];
+        items_[data] = {static_cast<std::uint16_t>(address_ + data), byte, byte, 1, addressing_mode::immediate,
+                        record_kind::data_byte};
+    }
+
+    redecode(offset, offset);
+}
+
+auto disassembly_cache::item(const std::uint16_t address) const noexcept -> const decoded_instruction &
+{
+    return items_[start_of(offset_of(address))];
+}
+
+auto disassembly_cache::window(const std::uint16_t address, const std::size_t before, const std::size_t after,
+                               decoded_instruction *output) const noexcept -> disassembly_window
+{
+    const auto offset = offset_of(address);
+
+    if (offset >= std::size(bytes_))
+        return {0, 0};
+
+    auto first = start_of(offset);
+    auto current = std::size_t{0};
+
+    while (current < before && first > 0)
+    {
+        first = start_of(first - 1);
+        ++current;
+    }
+
+    auto size = std::size_t{0};
+
+    for (auto item = first; size <= current + after && item < std::size(bytes_); item += items_[item].length)
+        output[size++] = items_[item];
+
+    return {size, current};
+}
+
+auto disassembly_cache::start_of(std::size_t offset) const noexcept -> std::size_t
+{
+    // Offset 0 always starts an item, and no item is longer than 3 bytes.
+    while (!is_start(offset))
+        --offset;
+
+    return offset;
+}
+
+void disassembly_cache::decode_at(const std::size_t offset) noexcept
+{
+    const aeon::common::span<const std::uint8_t> remaining{std::data(bytes_) + offset, std::size(bytes_) - offset};
+    const auto instruction = decode(remaining, static_cast<std::uint16_t>(address_ + offset), target_);
+    items_[offset] = instruction;
+
+    // Items of the old decode that started inside this one are gone.
+    for (auto i = std::size_t{1}; i < instruction.length; ++i)
+        items_[offset + i].length = 0;
+}
+
+void disassembly_cache::redecode(std::size_t offset, const std::size_t last_changed) noexcept
+{
+    for (;;)
+    {
+        decode_at(offset);
+        offset += items_[offset].length;
+
+        // Past the change, the old decode is still right from any of its item starts onward.
+        if (offset >= std::size(bytes_) || (offset > last_changed && is_start(offset)))
+            return;
+    }
+}
+
+} // namespace disasm6502
@@ -0,0 +1,144 @@
+#include <disasm6502/formatter.h>
+#include <opcode_table.h>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+namespace disasm6502
+{
+
+static constexpr auto make_hex_table() noexcept
+{
+    constexpr char digits[] = "0123456789abcdef";
+
+    std::array<std::array<char, 2>, 256> table{};
+    for (auto i = 0u; i < std::size(table); ++i)
+        table[i] = {digits[i >> 4], digits[i & 0x0f]};
+
+    return table;
+}
+
+static constexpr auto hex_table = make_hex_table();
+
+// Short text that is always copied as 4 bytes; only length of them are kept.
+struct fixed_text
+{
+    std::array<char, 4> text;
+    std::uint8_t length;
+};
+
+static constexpr auto make_fixed_text(const char *text) noexcept
+{
+    fixed_text result{};
+    while (text[result.length] != '\0')
+    {
+        result.text[result.length] = text[result.length];
+        ++result.length;
+    }
+
+    return result;
+}
+
+// Text around the operand, and the number of operand bytes printed, per addressing mode.
+struct operand_format
+{
+    fixed_text prefix;
+    std::uint8_t size;
+    fixed_text suffix;
+};
+
+static constexpr auto make_operand_format(const char *prefix, const std::uint8_t size, const char *suffix) noexcept
+{
+    return operand_format{make_fixed_text(prefix), size, make_fixed_text(suffix)};
+}
+
+static constexpr std::array<operand_format, 16> operand_formats{{
+    make_operand_format("", 0, ""),        // implied
+    make_operand_format(" A", 0, ""),      // accumulator
+    make_operand_format(" #$", 1, ""),     // immediate
+    make_operand_format(" $", 1, ""),      // zero_page
+    make_operand_format(" $", 1, ",X"),    // zero_page_x
+    make_operand_format(" $", 1, ",Y"),    // zero_page_y
+    make_operand_format(" $", 2, ""),      // absolute
+    make_operand_format(" $", 2, ",X"),    // absolute_x
+    make_operand_format(" $", 2, ",Y"),    // absolute_y
+    make_operand_format(" $", 1, ""),      // relative
+    make_operand_format(" $(", 1, ",X)"),  // indexed_indirect_x
+    make_operand_format(" $(", 1, "),Y"),  // indirect_indexed_y
+    make_operand_format(" ($", 2, ")"),    // absolute_indirect
+    make_operand_format(" $(", 1, ")"),    // zero_page_indirect
+    make_operand_format(" ($", 2, ",X)"),  // absolute_indexed_indirect
+    make_operand_format(" $", 1, ",$"),    // zero_page_relative, followed by the branch offset
+}};
+
+// The buffer is large enough for a fixed 4 byte copy at every step, which avoids a variable length copy.
+static auto append(char *buffer, const fixed_text &text) noexcept
+{
+    std::memcpy(buffer, std::data(text.text), std::size(text.text));
+    return buffer + text.length;
+}
+
+static auto append(char *buffer, const char *text) noexcept
+{
+    const auto length = std::strlen(text);
+    std::memcpy(buffer, text, length);
+    return buffer + length;
+}
+
+auto format_hex8(const std::uint8_t value, char *buffer) noexcept -> char *
+{
+    std::memcpy(buffer, std::data(hex_table[value]), 2);
+    return buffer + 2;
+}
+
+auto format_hex16(const std::uint16_t value, char *buffer) noexcept -> char *
+{
+    buffer = format_hex8(static_cast<std::uint8_t>(value >> 8), buffer);
+    return format_hex8(static_cast<std::uint8_t>(value), buffer);
+}
+
+auto format(const decoded_instruction &instruction, char *buffer, const cpu_target target) noexcept -> std::size_t
+{
+    auto *out = buffer;
+
+    switch (instruction.kind)
+    {
+        case record_kind::data_byte:
+            out = format_hex8(static_cast<std::uint8_t>(instruction.operand), append(out, ".db #$"));
+            break;
+        case record_kind::data_word:
+            out = format_hex16(instruction.operand, append(out, ".dw #$"));
+            break;
+        case record_kind::instruction:
+        {
+            const auto &format = operand_formats[static_cast<std::size_t>(instruction.mode)];
+            const auto *mnemonic = opcodes(target)[instruction.opcode].mnemonic;
+
+            // Decoded for another target; the byte is all that is known to be right.
+            if (!mnemonic)
+            {
+                out = format_hex8(instruction.opcode, append(out, ".db #$"));
+                break;
+            }
+
+            out = append(append(out, mnemonic), format.prefix);
+
+            if (format.size == 1)
+                out = format_hex8(static_cast<std::uint8_t>(instruction.operand), out);
+            else if (format.size == 2)
+                out = format_hex16(instruction.operand, out);
+
+            out = append(out, format.suffix);
+
+            if (instruction.mode == addressing_mode::zero_page_relative)
+                out = format_hex8(static_cast<std::uint8_t>(instruction.operand >> 8), out);
+
+            break;
+        }
+    }
+
+    assert(static_cast<std::size_t>(out - buffer) <= max_formatted_length);
+    return static_cast<std::size_t>(out - buffer);
+}
+
+} // namespace disasm6502
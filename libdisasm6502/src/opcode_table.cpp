@@ -0,0 +1,390 @@
+#include <opcode_table.h>
+
+namespace disasm6502
+{
+
+static constexpr auto make_nmos_table() noexcept
+{
+    opcode_table table{};
+
+    table[0x69] = {addressing_mode::immediate, "adc"};
+    table[0x6D] = {addressing_mode::absolute, "adc"};
+    table[0x65] = {addressing_mode::zero_page, "adc"};
+    table[0x61] = {addressing_mode::indexed_indirect_x, "adc"};
+    table[0x71] = {addressing_mode::indirect_indexed_y, "adc"};
+    table[0x75] = {addressing_mode::zero_page_x, "adc"};
+    table[0x7D] = {addressing_mode::absolute_x, "adc"};
+    table[0x79] = {addressing_mode::absolute_y, "adc"};
+
+    table[0x29] = {addressing_mode::immediate, "and"};
+    table[0x2D] = {addressing_mode::absolute, "and"};
+    table[0x25] = {addressing_mode::zero_page, "and"};
+    table[0x21] = {addressing_mode::indexed_indirect_x, "and"};
+    table[0x31] = {addressing_mode::indirect_indexed_y, "and"};
+    table[0x35] = {addressing_mode::zero_page_x, "and"};
+    table[0x3D] = {addressing_mode::absolute_x, "and"};
+    table[0x39] = {addressing_mode::absolute_y, "and"};
+
+    table[0x0E] = {addressing_mode::absolute, "asl"};
+    table[0x06] = {addressing_mode::zero_page, "asl"};
+    table[0x0A] = {addressing_mode::accumulator, "asl"};
+    table[0x16] = {addressing_mode::zero_page_x, "asl"};
+    table[0x1E] = {addressing_mode::absolute_x, "asl"};
+
+    table[0x90] = {addressing_mode::relative, "bcc"};
+
+    table[0xB0] = {addressing_mode::relative, "bcs"};
+
+    table[0xF0] = {addressing_mode::relative, "beq"};
+
+    table[0x2C] = {addressing_mode::absolute, "bit"};
+    table[0x24] = {addressing_mode::zero_page, "bit"};
+
+    table[0x30] = {addressing_mode::relative, "bmi"};
+
+    table[0xD0] = {addressing_mode::relative, "bne"};
+
+    table[0x10] = {addressing_mode::relative, "bpl"};
+
+    table[0x00] = {addressing_mode::implied, "brk"};
+
+    table[0x50] = {addressing_mode::relative, "bvc"};
+
+    table[0x70] = {addressing_mode::relative, "bvs"};
+
+    table[0x18] = {addressing_mode::implied, "clc"};
+
+    table[0xD8] = {addressing_mode::implied, "cld"};
+
+    table[0x58] = {addressing_mode::implied, "cli"};
+
+    table[0xB8] = {addressing_mode::implied, "clv"};
+
+    table[0xC9] = {addressing_mode::immediate, "cmp"};
+    table[0xCD] = {addressing_mode::absolute, "cmp"};
+    table[0xC5] = {addressing_mode::zero_page, "cmp"};
+    table[0xC1] = {addressing_mode::indexed_indirect_x, "cmp"};
+    table[0xD1] = {addressing_mode::indirect_indexed_y, "cmp"};
+    table[0xD5] = {addressing_mode::zero_page_x, "cmp"};
+    table[0xDD] = {addressing_mode::absolute_x, "cmp"};
+    table[0xD9] = {addressing_mode::absolute_y, "cmp"};
+
+    table[0xE0] = {addressing_mode::immediate, "cpx"};
+    table[0xEC] = {addressing_mode::absolute, "cpx"};
+    table[0xE4] = {addressing_mode::zero_page, "cpx"};
+
+    table[0xC0] = {addressing_mode::immediate, "cpy"};
+    table[0xCC] = {addressing_mode::absolute, "cpy"};
+    table[0xC4] = {addressing_mode::zero_page, "cpy"};
+
+    table[0xCE] = {addressing_mode::absolute, "dec"};
+    table[0xC6] = {addressing_mode::zero_page, "dec"};
+    table[0xD6] = {addressing_mode::zero_page_x, "dec"};
+    table[0xDE] = {addressing_mode::absolute_x, "dec"};
+
+    table[0xCA] = {addressing_mode::implied, "dex"};
+
+    table[0x88] = {addressing_mode::implied, "dey"};
+
+    table[0x49] = {addressing_mode::immediate, "eor"};
+    table[0x4D] = {addressing_mode::absolute, "eor"};
+    table[0x45] = {addressing_mode::zero_page, "eor"};
+    table[0x41] = {addressing_mode::indexed_indirect_x, "eor"};
+    table[0x51] = {addressing_mode::indirect_indexed_y, "eor"};
+    table[0x55] = {addressing_mode::zero_page_x, "eor"};
+    table[0x5D] = {addressing_mode::absolute_x, "eor"};
+    table[0x59] = {addressing_mode::absolute_y, "eor"};
+
+    table[0xEE] = {addressing_mode::absolute, "inc"};
+    table[0xE6] = {addressing_mode::zero_page, "inc"};
+    table[0xF6] = {addressing_mode::zero_page_x, "inc"};
+    table[0xFE] = {addressing_mode::absolute_x, "inc"};
+
+    table[0xE8] = {addressing_mode::implied, "inx"};
+
+    table[0xC8] = {addressing_mode::implied, "iny"};
+
+    table[0x4C] = {addressing_mode::absolute, "jmp"};
+    table[0x6C] = {addressing_mode::absolute_indirect, "jmp"};
+
+    table[0x20] = {addressing_mode::absolute, "jsr"};
+
+    table[0xA9] = {addressing_mode::immediate, "lda"};
+    table[0xAD] = {addressing_mode::absolute, "lda"};
+    table[0xA5] = {addressing_mode::zero_page, "lda"};
+    table[0xA1] = {addressing_mode::indexed_indirect_x, "lda"};
+    table[0xB1] = {addressing_mode::indirect_indexed_y, "lda"};
+    table[0xB5] = {addressing_mode::zero_page_x, "lda"};
+    table[0xBD] = {addressing_mode::absolute_x, "lda"};
+    table[0xB9] = {addressing_mode::absolute_y, "lda"};
+
+    table[0xA2] = {addressing_mode::immediate, "ldx"};
+    table[0xAE] = {addressing_mode::absolute, "ldx"};
+    table[0xA6] = {addressing_mode::zero_page, "ldx"};
+    table[0xBE] = {addressing_mode::absolute_y, "ldx"};
+    table[0xB6] = {addressing_mode::zero_page_y, "ldx"};
+
+    table[0xA0] = {addressing_mode::immediate, "ldy"};
+    table[0xAC] = {addressing_mode::absolute, "ldy"};
+    table[0xA4] = {addressing_mode::zero_page, "ldy"};
+    table[0xB4] = {addressing_mode::zero_page_x, "ldy"};
+    table[0xBC] = {addressing_mode::absolute_x, "ldy"};
+
+    table[0x4E] = {addressing_mode::absolute, "lsr"};
+    table[0x46] = {addressing_mode::zero_page, "lsr"};
+    table[0x4A] = {addressing_mode::accumulator, "lsr"};
+    table[0x56] = {addressing_mode::zero_page_x, "lsr"};
+    table[0x5E] = {addressing_mode::absolute_x, "lsr"};
+
+    table[0xEA] = {addressing_mode::implied, "nop"};
+
+    table[0x09] = {addressing_mode::immediate, "ora"};
+    table[0x0D] = {addressing_mode::absolute, "ora"};
+    table[0x05] = {addressing_mode::zero_page, "ora"};
+    table[0x01] = {addressing_mode::indexed_indirect_x, "ora"};
+    table[0x11] = {addressing_mode::indirect_indexed_y, "ora"};
+    table[0x15] = {addressing_mode::zero_page_x, "ora"};
+    table[0x1D] = {addressing_mode::absolute_x, "ora"};
+    table[0x19] = {addressing_mode::absolute_y, "ora"};
+
+    table[0x48] = {addressing_mode::implied, "pha"};
+
+    table[0x08] = {addressing_mode::implied, "php"};
+
+    table[0x68] = {addressing_mode::implied, "pla"};
+
+    table[0x28] = {addressing_mode::implied, "plp"};
+
+    table[0x2E] = {addressing_mode::absolute, "rol"};
+    table[0x26] = {addressing_mode::zero_page, "rol"};
+    table[0x2A] = {addressing_mode::accumulator, "rol"};
+    table[0x36] = {addressing_mode::zero_page_x, "rol"};
+    table[0x3E] = {addressing_mode::absolute_x, "rol"};
+
+    table[0x6E] = {addressing_mode::absolute, "ror"};
+    table[0x66] = {addressing_mode::zero_page, "ror"};
+    table[0x6A] = {addressing_mode::accumulator, "ror"};
+    table[0x76] = {addressing_mode::zero_page_x, "ror"};
+    table[0x7E] = {addressing_mode::absolute_x, "ror"};
+
+    table[0x40] = {addressing_mode::implied, "rti"};
+
+    table[0x60] = {addressing_mode::implied, "rts"};
+
+    table[0xE9] = {addressing_mode::immediate, "sbc"};
+    table[0xED] = {addressing_mode::absolute, "sbc"};
+    table[0xE5] = {addressing_mode::zero_page, "sbc"};
+    table[0xE1] = {addressing_mode::indexed_indirect_x, "sbc"};
+    table[0xF1] = {addressing_mode::indirect_indexed_y, "sbc"};
+    table[0xF5] = {addressing_mode::zero_page_x, "sbc"};
+    table[0xFD] = {addressing_mode::absolute_x, "sbc"};
+    table[0xF9] = {addressing_mode::absolute_y, "sbc"};
+
+    table[0x38] = {addressing_mode::implied, "sec"};
+
+    table[0xF8] = {addressing_mode::implied, "sed"};
+
+    table[0x78] = {addressing_mode::implied, "sei"};
+
+    table[0x8D] = {addressing_mode::absolute, "sta"};
+    table[0x85] = {addressing_mode::zero_page, "sta"};
+    table[0x81] = {addressing_mode::indexed_indirect_x, "sta"};
+    table[0x91] = {addressing_mode::indirect_indexed_y, "sta"};
+    table[0x95] = {addressing_mode::zero_page_x, "sta"};
+    table[0x9D] = {addressing_mode::absolute_x, "sta"};
+    table[0x99] = {addressing_mode::absolute_y, "sta"};
+
+    table[0x8E] = {addressing_mode::absolute, "stx"};
+    table[0x86] = {addressing_mode::zero_page, "stx"};
+    table[0x96] = {addressing_mode::zero_page_y, "stx"};
+
+    table[0x8C] = {addressing_mode::absolute, "sty"};
+    table[0x84] = {addressing_mode::zero_page, "sty"};
+    table[0x94] = {addressing_mode::zero_page_x, "sty"};
+
+    table[0xAA] = {addressing_mode::implied, "tax"};
+
+    table[0xA8] = {addressing_mode::implied, "tay"};
+
+    table[0xBA] = {addressing_mode::implied, "tsx"};
+
+    table[0x8A] = {addressing_mode::implied, "txa"};
+
+    table[0x9A] = {addressing_mode::implied, "txs"};
+
+    table[0x98] = {addressing_mode::implied, "tya"};
+
+    return table;
+}
+
+/*!
+ * The undocumented opcodes of the NMOS 6502, with the names most assemblers use. Every opcode does
+ * something, so this table has no gaps.
+ */
+static constexpr auto make_nmos_undocumented_table() noexcept
+{
+    auto table = make_nmos_table();
+
+    const auto add_group = [&table](const std::uint8_t base, const char *mnemonic) {
+        table[base + 0x07] = {addressing_mode::zero_page, mnemonic};
+        table[base + 0x17] = {addressing_mode::zero_page_x, mnemonic};
+        table[base + 0x03] = {addressing_mode::indexed_indirect_x, mnemonic};
+        table[base + 0x13] = {addressing_mode::indirect_indexed_y, mnemonic};
+        table[base + 0x0F] = {addressing_mode::absolute, mnemonic};
+        table[base + 0x1F] = {addressing_mode::absolute_x, mnemonic};
+        table[base + 0x1B] = {addressing_mode::absolute_y, mnemonic};
+    };
+
+    add_group(0x00, "slo");
+    add_group(0x20, "rla");
+    add_group(0x40, "sre");
+    add_group(0x60, "rra");
+    add_group(0xC0, "dcp");
+    add_group(0xE0, "isc");
+
+    table[0x87] = {addressing_mode::zero_page, "sax"};
+    table[0x97] = {addressing_mode::zero_page_y, "sax"};
+    table[0x83] = {addressing_mode::indexed_indirect_x, "sax"};
+    table[0x8F] = {addressing_mode::absolute, "sax"};
+
+    table[0xA7] = {addressing_mode::zero_page, "lax"};
+    table[0xB7] = {addressing_mode::zero_page_y, "lax"};
+    table[0xA3] = {addressing_mode::indexed_indirect_x, "lax"};
+    table[0xB3] = {addressing_mode::indirect_indexed_y, "lax"};
+    table[0xAF] = {addressing_mode::absolute, "lax"};
+    table[0xBF] = {addressing_mode::absolute_y, "lax"};
+
+    table[0x0B] = {addressing_mode::immediate, "anc"};
+    table[0x2B] = {addressing_mode::immediate, "anc"};
+    table[0x4B] = {addressing_mode::immediate, "alr"};
+    table[0x6B] = {addressing_mode::immediate, "arr"};
+    table[0x8B] = {addressing_mode::immediate, "ane"};
+    table[0xAB] = {addressing_mode::immediate, "lxa"};
+    table[0xCB] = {addressing_mode::immediate, "sbx"};
+    table[0xEB] = {addressing_mode::immediate, "sbc"};
+
+    table[0x93] = {addressing_mode::indirect_indexed_y, "sha"};
+    table[0x9F] = {addressing_mode::absolute_y, "sha"};
+    table[0x9C] = {addressing_mode::absolute_x, "shy"};
+    table[0x9E] = {addressing_mode::absolute_y, "shx"};
+    table[0x9B] = {addressing_mode::absolute_y, "tas"};
+    table[0xBB] = {addressing_mode::absolute_y, "las"};
+
+    for (const auto opcode : {0x1A, 0x3A, 0x5A, 0x7A, 0xDA, 0xFA})
+        table[opcode] = {addressing_mode::implied, "nop"};
+
+    for (const auto opcode : {0x80, 0x82, 0x89, 0xC2, 0xE2})
+        table[opcode] = {addressing_mode::immediate, "nop"};
+
+    for (const auto opcode : {0x04, 0x44, 0x64})
+        table[opcode] = {addressing_mode::zero_page, "nop"};
+
+    for (const auto opcode : {0x14, 0x34, 0x54, 0x74, 0xD4, 0xF4})
+        table[opcode] = {addressing_mode::zero_page_x, "nop"};
+
+    table[0x0C] = {addressing_mode::absolute, "nop"};
+
+    for (const auto opcode : {0x1C, 0x3C, 0x5C, 0x7C, 0xDC, 0xFC})
+        table[opcode] = {addressing_mode::absolute_x, "nop"};
+
+    for (const auto opcode : {0x02, 0x12, 0x22, 0x32, 0x42, 0x52, 0x62, 0x72, 0x92, 0xB2, 0xD2, 0xF2})
+        table[opcode] = {addressing_mode::implied, "jam"};
+
+    return table;
+}
+
+/*!
+ * The CMOS 65C02 adds instructions, the (zp) and (abs,X) addressing modes, and new modes for bit.
+ * See http://6502.org/tutorials/65c02opcodes.html
+ */
+static constexpr auto make_65c02_table() noexcept
+{
+    auto table = make_nmos_table();
+
+    table[0x80] = {addressing_mode::relative, "bra"};
+
+    table[0xDA] = {addressing_mode::implied, "phx"};
+    table[0x5A] = {addressing_mode::implied, "phy"};
+    table[0xFA] = {addressing_mode::implied, "plx"};
+    table[0x7A] = {addressing_mode::implied, "ply"};
+
+    table[0x64] = {addressing_mode::zero_page, "stz"};
+    table[0x74] = {addressing_mode::zero_page_x, "stz"};
+    table[0x9C] = {addressing_mode::absolute, "stz"};
+    table[0x9E] = {addressing_mode::absolute_x, "stz"};
+
+    table[0x14] = {addressing_mode::zero_page, "trb"};
+    table[0x1C] = {addressing_mode::absolute, "trb"};
+    table[0x04] = {addressing_mode::zero_page, "tsb"};
+    table[0x0C] = {addressing_mode::absolute, "tsb"};
+
+    table[0x89] = {addressing_mode::immediate, "bit"};
+    table[0x34] = {addressing_mode::zero_page_x, "bit"};
+    table[0x3C] = {addressing_mode::absolute_x, "bit"};
+
+    table[0x1A] = {addressing_mode::accumulator, "inc"};
+    table[0x3A] = {addressing_mode::accumulator, "dec"};
+
+    table[0x7C] = {addressing_mode::absolute_indexed_indirect, "jmp"};
+
+    table[0x12] = {addressing_mode::zero_page_indirect, "ora"};
+    table[0x32] = {addressing_mode::zero_page_indirect, "and"};
+    table[0x52] = {addressing_mode::zero_page_indirect, "eor"};
+    table[0x72] = {addressing_mode::zero_page_indirect, "adc"};
+    table[0x92] = {addressing_mode::zero_page_indirect, "sta"};
+    table[0xB2] = {addressing_mode::zero_page_indirect, "lda"};
+    table[0xD2] = {addressing_mode::zero_page_indirect, "cmp"};
+    table[0xF2] = {addressing_mode::zero_page_indirect, "sbc"};
+
+    return table;
+}
+
+/*!
+ * The WDC 65C02 adds the bit manipulation instructions (also on the Rockwell parts), wai and stp.
+ */
+static constexpr auto make_wdc_65c02_table() noexcept
+{
+    auto table = make_65c02_table();
+
+    constexpr const char *rmb[] = {"rmb0", "rmb1", "rmb2", "rmb3", "rmb4", "rmb5", "rmb6", "rmb7"};
+    constexpr const char *smb[] = {"smb0", "smb1", "smb2", "smb3", "smb4", "smb5", "smb6", "smb7"};
+    constexpr const char *bbr[] = {"bbr0", "bbr1", "bbr2", "bbr3", "bbr4", "bbr5", "bbr6", "bbr7"};
+    constexpr const char *bbs[] = {"bbs0", "bbs1", "bbs2", "bbs3", "bbs4", "bbs5", "bbs6", "bbs7"};
+
+    for (auto bit = 0; bit < 8; ++bit)
+    {
+        table[0x07 + bit * 0x10] = {addressing_mode::zero_page, rmb[bit]};
+        table[0x87 + bit * 0x10] = {addressing_mode::zero_page, smb[bit]};
+        table[0x0F + bit * 0x10] = {addressing_mode::zero_page_relative, bbr[bit]};
+        table[0x8F + bit * 0x10] = {addressing_mode::zero_page_relative, bbs[bit]};
+    }
+
+    table[0xCB] = {addressing_mode::implied, "wai"};
+    table[0xDB] = {addressing_mode::implied, "stp"};
+
+    return table;
+}
+
+static constexpr auto defined_opcodes(const opcode_table &table) noexcept
+{
+    auto count = 0;
+
+    for (const auto &info : table)
+    {
+        if (info.mnemonic)
+            ++count;
+    }
+
+    return count;
+}
+
+static_assert(defined_opcodes(make_nmos_table()) == 151);
+static_assert(defined_opcodes(make_nmos_undocumented_table()) == 256);
+static_assert(defined_opcodes(make_65c02_table()) == 151 + 27);
+static_assert(defined_opcodes(make_wdc_65c02_table()) == 151 + 27 + 34);
+
+// Indexed by cpu_target.
+constexpr std::array<opcode_table, 4> opcode_tables{make_nmos_table(), make_nmos_undocumented_table(),
+                                                    make_65c02_table(), make_wdc_65c02_table()};
+
+} // namespace disasm6502
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <disasm6502/decoder.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace disasm6502
+{
+
+struct opcode_info
+{
+    addressing_mode mode{};
+
+    // nullptr for opcodes that are not part of the instruction set.
+    const char *mnemonic{};
+};
+
+using opcode_table = std::array<opcode_info, 256>;
+
+/*!
+ * Mnemonic and addressing mode of every opcode, one constant table per cpu_target.
+ */
+extern const std::array<opcode_table, 4> opcode_tables;
+
+inline auto opcodes(const cpu_target target) noexcept -> const opcode_table &
+{
+    return opcode_tables[static_cast<std::size_t>(target)];
+}
+
+constexpr auto instruction_length(const addressing_mode mode) noexcept -> std::uint8_t
+{
+    switch (mode)
+    {
+        case addressing_mode::implied:
+        case addressing_mode::accumulator:
+            return 1;
+        case addressing_mode::absolute:
+        case addressing_mode::absolute_x:
+        case addressing_mode::absolute_y:
+        case addressing_mode::absolute_indirect:
+        case addressing_mode::absolute_indexed_indirect:
+        case addressing_mode::zero_page_relative:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+/*!
+ * How an instruction passes control on. Exit covers returns, BRK and the instructions that halt the
+ * CPU: the next instruction is not known statically.
+ */
+enum class control_flow : std::uint8_t
+{
+    sequential,
+    branch,
+    jump,
+    indirect_jump,
+    call,
+    exit
+};
+
+/*!
+ * The opcode and addressing mode together identify the instruction on every target, so the target is
+ * not needed here.
+ */
+constexpr auto control_flow_of(const decoded_instruction &instruction) noexcept -> control_flow
+{
+    switch (instruction.mode)
+    {
+        case addressing_mode::relative:
+            // bra is the only unconditional relative branch.
+            return instruction.opcode == 0x80 ? control_flow::jump : control_flow::branch;
+        case addressing_mode::zero_page_relative:
+            return control_flow::branch;
+        case addressing_mode::absolute_indexed_indirect:
+            return control_flow::indirect_jump;
+        default:
+            break;
+    }
+
+    switch (instruction.opcode)
+    {
+        case 0x4C:
+            return control_flow::jump;
+        case 0x6C:
+            return control_flow::indirect_jump;
+        case 0x20:
+            return control_flow::call;
+        case 0x00: // brk
+        case 0x40: // rti
+        case 0x60: // rts
+            return control_flow::exit;
+        default:
+            break;
+    }
+
+    // stp on the WDC 65C02, and the jam opcodes of the NMOS 6502.
+    if (instruction.mode == addressing_mode::implied &&
+        (instruction.opcode == 0xDB || (instruction.opcode & 0x0f) == 0x02))
+        return control_flow::exit;
+
+    return control_flow::sequential;
+}
+
+} // namespace disasm6502
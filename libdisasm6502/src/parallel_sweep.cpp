@@ -0,0 +1,117 @@
+#include <disasm6502/parallel_sweep.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace disasm6502
+{
+
+parallel_sweep::parallel_sweep(const aeon::common::span<const std::uint8_t> bytes, const std::uint16_t offset,
+                               const cpu_target target, const std::size_t thread_count,
+                               const std::size_t min_chunk_size)
+    : bytes_{bytes}
+    , offset_{offset}
+    , target_{target}
+    , chunks_{}
+{
+    const auto size = std::size(bytes_);
+    const auto threads =
+        std::max<std::size_t>(thread_count != 0 ? thread_count : std::thread::hardware_concurrency(), 1);
+
+    // A few chunks per thread even out chunks that decode slower than others.
+    const auto chunk_size =
+        std::max({min_chunk_size, (size + threads * 4 - 1) / (threads * 4), std::size_t{1}});
+
+    for (auto begin = std::size_t{0}; begin < size; begin += chunk_size)
+        chunks_.push_back(chunk{begin, std::min(begin + chunk_size, size), {}, {}, 0, 0});
+
+    std::atomic<std::size_t> next_chunk{0};
+
+    const auto worker = [this, &next_chunk]() {
+        for (auto index = next_chunk++; index < std::size(chunks_); index = next_chunk++)
+            decode_chunk(chunks_[index]);
+    };
+
+    std::vector<std::thread> workers;
+    for (auto i = std::size_t{1}; i < std::min(threads, std::size(chunks_)); ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (auto &thread : workers)
+        thread.join();
+
+    // Where the previous chunk really ended is only known once that chunk is fixed itself, so this runs in
+    // order. Linear sweep falls back into step within a few instructions, so it is cheap.
+    auto boundary = std::size_t{0};
+
+    for (auto &current_chunk : chunks_)
+    {
+        if (boundary != current_chunk.begin)
+            resynchronize(current_chunk, boundary);
+
+        boundary = current_chunk.next;
+    }
+}
+
+auto parallel_sweep::size() const noexcept -> std::size_t
+{
+    auto size = std::size_t{0};
+
+    for (const auto &current_chunk : chunks_)
+        size += std::size(current_chunk.head) + std::size(current_chunk.records) - current_chunk.first;
+
+    return size;
+}
+
+auto parallel_sweep::remaining(const std::size_t position) const noexcept -> aeon::common::span<const std::uint8_t>
+{
+    return aeon::common::span<const std::uint8_t>{std::data(bytes_) + position, std::size(bytes_) - position};
+}
+
+void parallel_sweep::decode_chunk(chunk &current_chunk) const noexcept
+{
+    current_chunk.records.reserve((current_chunk.end - current_chunk.begin) / 2);
+
+    // The decoder sees everything up to the end of the image, so the last instruction of the chunk may
+    // reach into the next one.
+    linear_decoder decoder{remaining(current_chunk.begin), static_cast<std::uint16_t>(offset_ + current_chunk.begin),
+                           target_};
+
+    decoded_instruction instruction;
+    while (current_chunk.begin + decoder.position() < current_chunk.end && decoder.next(instruction))
+        current_chunk.records.push_back(instruction);
+
+    current_chunk.next = current_chunk.begin + decoder.position();
+}
+
+void parallel_sweep::resynchronize(chunk &current_chunk, const std::size_t boundary) const
+{
+    linear_decoder decoder{remaining(boundary), static_cast<std::uint16_t>(offset_ + boundary), target_};
+
+    auto first = std::size_t{0};
+    auto speculative_position = current_chunk.begin;
+    decoded_instruction instruction;
+
+    for (auto position = boundary; position < current_chunk.end; position = boundary + decoder.position())
+    {
+        while (first < std::size(current_chunk.records) && speculative_position < position)
+            speculative_position += current_chunk.records[first++].length;
+
+        // Both decodes start an instruction here, so the rest of the speculative decode is correct.
+        if (first < std::size(current_chunk.records) && speculative_position == position)
+        {
+            current_chunk.first = first;
+            return;
+        }
+
+        decoder.next(instruction);
+        current_chunk.head.push_back(instruction);
+    }
+
+    // The real decode never met the speculative one, or the previous chunk already covered this one.
+    current_chunk.first = std::size(current_chunk.records);
+    current_chunk.next = std::max(current_chunk.end, boundary + decoder.position());
+}
+
+} // namespace disasm6502
@@ -0,0 +1,247 @@
+#include <disasm6502/recursive_analysis.h>
+#include <opcode_table.h>
+#include <algorithm>
+
+namespace disasm6502
+{
+
+static constexpr std::array<std::uint16_t, 3> vector_addresses{0xfffa, 0xfffc, 0xfffe};
+
+static auto is_interrupt_vector_address(const std::uint32_t address) noexcept
+{
+    return address == 0xfffa || address == 0xfffc || address == 0xfffe;
+}
+
+/*!
+ * The part of the image that fits in the address space. Bytes past $FFFF have no address.
+ */
+static auto clamp_to_address_space(const aeon::common::span<const std::uint8_t> image,
+                                   const std::uint16_t offset) noexcept
+{
+    const auto size = std::min<std::size_t>(std::size(image), 0x10000u - offset);
+    return aeon::common::span<const std::uint8_t>{std::data(image), size};
+}
+
+recursive_analysis::recursive_analysis(const aeon::common::span<const std::uint8_t> image, const std::uint16_t offset,
+                                       const cpu_target target, const std::vector<std::uint16_t> &entry_points,
+                                       const bool use_vectors)
+    : image_{clamp_to_address_space(image, offset)}
+    , offset_{offset}
+    , target_{target}
+    , code_{}
+    , instruction_start_{}
+    , label_{}
+    , leader_{}
+    , blocks_{}
+{
+    std::vector<std::uint16_t> worklist{entry_points};
+
+    if (use_vectors)
+    {
+        for (const auto vector : vector_addresses)
+        {
+            if (!contains(vector) || !contains(vector + 1u))
+                continue;
+
+            const auto *data = std::data(image_) + (vector - offset_);
+            worklist.push_back(static_cast<std::uint16_t>(data[0] | (data[1] << 8)));
+        }
+    }
+
+    for (const auto entry_point : worklist)
+        label_.set(entry_point);
+
+    while (!std::empty(worklist))
+    {
+        const auto address = worklist.back();
+        worklist.pop_back();
+        trace(address, worklist);
+    }
+
+    build_blocks();
+}
+
+auto recursive_analysis::contains(const std::uint32_t address) const noexcept -> bool
+{
+    return address >= offset_ && address - offset_ < std::size(image_);
+}
+
+void recursive_analysis::trace(const std::uint16_t entry_point, std::vector<std::uint16_t> &worklist) noexcept
+{
+    if (!contains(entry_point) || code_[entry_point])
+        return;
+
+    leader_.set(entry_point);
+
+    for (std::uint32_t address = entry_point; contains(address);)
+    {
+        // Running into code found earlier: that instruction starts a new block.
+        if (code_[address])
+        {
+            if (instruction_start_[address])
+                leader_.set(address);
+
+            return;
+        }
+
+        const auto position = address - offset_;
+        const auto instruction = decode(
+            aeon::common::span<const std::uint8_t>{std::data(image_) + position, std::size(image_) - position},
+            static_cast<std::uint16_t>(address), target_);
+
+        if (instruction.kind != record_kind::instruction)
+            return;
+
+        const auto next = address + instruction.length;
+
+        for (auto byte = address + 1; byte < next; ++byte)
+        {
+            if (code_[byte])
+                return;
+        }
+
+        for (auto byte = address; byte < next; ++byte)
+            code_.set(byte);
+
+        instruction_start_.set(address);
+
+        switch (control_flow_of(instruction))
+        {
+            case control_flow::branch:
+            {
+                const auto target = branch_target(instruction);
+                label_.set(target);
+                worklist.push_back(target);
+
+                if (next < 0x10000)
+                    leader_.set(next);
+                break;
+            }
+            case control_flow::call:
+            case control_flow::jump:
+            {
+                // An absolute address, or a relative one for bra.
+                const auto target = *referenced_address(instruction);
+                label_.set(target);
+                worklist.push_back(target);
+
+                if (control_flow_of(instruction) == control_flow::jump)
+                    return;
+
+                break;
+            }
+            case control_flow::indirect_jump:
+            case control_flow::exit:
+                return;
+            case control_flow::sequential:
+                break;
+        }
+
+        address = next;
+    }
+}
+
+void recursive_analysis::build_blocks()
+{
+    const auto end = offset_ + static_cast<std::uint32_t>(std::size(image_));
+
+    basic_block block{};
+    auto in_block = false;
+
+    const auto close_block = [this, &block, &in_block](const std::uint32_t block_end) {
+        block.end = block_end;
+        blocks_.push_back(block);
+        in_block = false;
+    };
+
+    for (std::uint32_t address = offset_; address < end;)
+    {
+        if (!instruction_start_[address])
+        {
+            if (in_block)
+                close_block(address);
+
+            ++address;
+            continue;
+        }
+
+        if (in_block && (leader_[address] || label_[address]))
+        {
+            block.successors[0] = static_cast<std::uint16_t>(address);
+            block.successor_count = 1;
+            close_block(address);
+        }
+
+        if (!in_block)
+        {
+            block = basic_block{static_cast<std::uint16_t>(address), 0, {}, 0};
+            in_block = true;
+        }
+
+        const auto *data = std::data(image_) + (address - offset_);
+        const auto instruction = decode(aeon::common::span<const std::uint8_t>{data, end - address},
+                                        static_cast<std::uint16_t>(address), target_);
+        const auto next = address + instruction.length;
+
+        switch (control_flow_of(instruction))
+        {
+            case control_flow::branch:
+                block.successors[0] = branch_target(instruction);
+                block.successors[1] = static_cast<std::uint16_t>(next);
+                block.successor_count = next < 0x10000 ? 2 : 1;
+                close_block(next);
+                break;
+            case control_flow::jump:
+                block.successors[0] = *referenced_address(instruction);
+                block.successor_count = 1;
+                close_block(next);
+                break;
+            case control_flow::indirect_jump:
+            case control_flow::exit:
+                close_block(next);
+                break;
+            case control_flow::call:
+            case control_flow::sequential:
+                break;
+        }
+
+        address = next;
+    }
+
+    if (in_block)
+        close_block(end);
+}
+
+recursive_decoder::recursive_decoder(const recursive_analysis &analysis) noexcept
+    : analysis_{analysis}
+    , position_{}
+{
+}
+
+auto recursive_decoder::next(decoded_instruction &instruction) noexcept -> bool
+{
+    const auto image = analysis_.image();
+    const auto size = std::size(image);
+
+    if (position_ >= size)
+        return false;
+
+    const auto *data = std::data(image) + position_;
+    const auto address = static_cast<std::uint16_t>(analysis_.offset() + position_);
+    const auto remaining = size - position_;
+
+    if (analysis_.is_instruction_start(address) ||
+        (is_interrupt_vector_address(address) && remaining >= 2 && !analysis_.is_code(address + 1u)))
+    {
+        instruction = decode(aeon::common::span<const std::uint8_t>{data, remaining}, address, analysis_.target());
+    }
+    else
+    {
+        instruction = {address, data[0], data[0], 1, addressing_mode::immediate, record_kind::data_byte};
+    }
+
+    position_ += instruction.length;
+    return true;
+}
+
+} // namespace disasm6502
@@ -0,0 +1,334 @@
+#include <disasm6502/symbol_table.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace disasm6502
+{
+
+static constexpr std::size_t address_count = 0x10000;
+
+static auto trim(std::string_view text) noexcept
+{
+    while (!std::empty(text) && (text.front() == ' ' || text.front() == '\t'))
+        text.remove_prefix(1);
+
+    while (!std::empty(text) && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+        text.remove_suffix(1);
+
+    return text;
+}
+
+/*!
+ * Split off the text up to the first separator. The separator itself is dropped.
+ */
+static auto next_token(std::string_view &text, const char separator) noexcept
+{
+    const auto end = text.find(separator);
+    const auto token = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? std::size(text) : end + 1);
+    return token;
+}
+
+template <typename function_t>
+static void for_each_line(std::string_view text, function_t &&function)
+{
+    for (auto line_number = 1; !std::empty(text); ++line_number)
+    {
+        const auto line = trim(next_token(text, '\n'));
+
+        if (!std::empty(line))
+            function(line, line_number);
+    }
+}
+
+/*!
+ * A number written as $hex, 0xhex or decimal.
+ */
+static auto parse_number(std::string_view text) noexcept -> std::optional<std::uint32_t>
+{
+    auto base = 10u;
+
+    if (!std::empty(text) && text.front() == '$')
+    {
+        text.remove_prefix(1);
+        base = 16;
+    }
+    else if (std::size(text) > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+    {
+        text.remove_prefix(2);
+        base = 16;
+    }
+
+    if (std::empty(text) || std::size(text) > 8)
+        return std::nullopt;
+
+    auto value = std::uint32_t{0};
+
+    for (const auto c : text)
+    {
+        auto digit = base;
+
+        if (c >= '0' && c <= '9')
+            digit = static_cast<unsigned>(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            digit = static_cast<unsigned>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            digit = static_cast<unsigned>(c - 'A' + 10);
+
+        if (digit >= base)
+            return std::nullopt;
+
+        value = value * base + digit;
+    }
+
+    return value;
+}
+
+static auto parse_address(const std::string_view text) noexcept -> std::optional<std::uint16_t>
+{
+    const auto value = parse_number(text);
+
+    if (!value || *value > 0xffff)
+        return std::nullopt;
+
+    return static_cast<std::uint16_t>(*value);
+}
+
+[[noreturn]] static void throw_parse_error(const int line_number, const std::string_view message)
+{
+    throw std::runtime_error{"Line " + std::to_string(line_number) + ": " + std::string{message}};
+}
+
+symbol_table::symbol_table(const std::uint16_t max_offset)
+    : max_offset_{max_offset}
+    , symbols_{}
+    , names_{}
+    , index_(address_count, no_symbol)
+{
+}
+
+void symbol_table::load(const std::filesystem::path &path)
+{
+    std::ifstream file{path, std::ios::binary};
+
+    if (!file)
+        throw std::runtime_error{"Could not open " + path.string() + "."};
+
+    const std::string text{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    const auto first_line = trim(std::string_view{text}.substr(0, text.find('\n')));
+
+    try
+    {
+        if (first_line.rfind("version", 0) == 0 && first_line.find("major=") != std::string_view::npos)
+            load_ca65_debug_info(text);
+        else if (first_line.rfind("al ", 0) == 0)
+            load_vice_labels(text);
+        else
+            load_assignments(text);
+    }
+    catch (const std::exception &e)
+    {
+        throw std::runtime_error{path.string() + ": " + e.what()};
+    }
+}
+
+void symbol_table::load_ca65_debug_info(const std::string_view text)
+{
+    // sym	id=0,name="reset",addrsize=absolute,scope=0,def=1,ref=3,val=0x8000,seg=0,type=lab
+    // Only labels are used; equates are often plain constants rather than addresses.
+    for_each_line(text, [this](std::string_view line, const int) {
+        const auto kind = next_token(line, '\t');
+
+        if (kind != "sym")
+            return;
+
+        std::string_view name;
+        std::optional<std::uint16_t> address;
+        auto is_label = false;
+
+        while (!std::empty(line))
+        {
+            auto value = next_token(line, ',');
+            const auto key = next_token(value, '=');
+
+            if (key == "name" && std::size(value) >= 2 && value.front() == '"' && value.back() == '"')
+                name = value.substr(1, std::size(value) - 2);
+            else if (key == "val")
+                address = parse_address(value);
+            else if (key == "type")
+                is_label = value == "lab";
+        }
+
+        if (is_label && address && !std::empty(name))
+            insert(name, *address);
+    });
+
+    build_index();
+}
+
+void symbol_table::load_vice_labels(const std::string_view text)
+{
+    // al C:080d .start
+    for_each_line(text, [this](std::string_view line, const int line_number) {
+        if (line.front() == '#' || line.front() == ';')
+            return;
+
+        if (trim(next_token(line, ' ')) != "al")
+            return;
+
+        line = trim(line);
+        auto address_text = trim(next_token(line, ' '));
+        auto name = trim(line);
+
+        // The memory space prefix, such as "C:", is optional.
+        if (const auto colon = address_text.find(':'); colon != std::string_view::npos)
+            address_text.remove_prefix(colon + 1);
+
+        if (!std::empty(name) && name.front() == '.')
+            name.remove_prefix(1);
+
+        const auto address = parse_number(std::string{"$"} + std::string{address_text});
+
+        if (!address || *address > 0xffff || std::empty(name))
+            throw_parse_error(line_number, "expected \"al <address> .<name>\"");
+
+        insert(name, static_cast<std::uint16_t>(*address));
+    });
+
+    build_index();
+}
+
+void symbol_table::load_assignments(const std::string_view text)
+{
+    // name = $1234 ; comment
+    for_each_line(text, [this](std::string_view line, const int line_number) {
+        line = trim(line.substr(0, line.find(';')));
+
+        if (std::empty(line))
+            return;
+
+        const auto separator = line.find('=');
+
+        if (separator == std::string_view::npos)
+            throw_parse_error(line_number, "expected \"<name> = <address>\"");
+
+        auto name = trim(line.substr(0, separator));
+
+        // ca65 style "name := $1234".
+        if (!std::empty(name) && name.back() == ':')
+            name = trim(name.substr(0, std::size(name) - 1));
+
+        const auto address = parse_address(trim(line.substr(separator + 1)));
+
+        if (!address || std::empty(name))
+            throw_parse_error(line_number, "expected \"<name> = <address>\"");
+
+        insert(name, *address);
+    });
+
+    build_index();
+}
+
+void symbol_table::add(const std::string_view name, const std::uint16_t address)
+{
+    insert(name, address);
+    build_index();
+}
+
+auto symbol_table::exact(const std::uint16_t address) const noexcept -> std::optional<std::string_view>
+{
+    const auto index = index_[address];
+
+    if (index == no_symbol || symbols_[index].address != address)
+        return std::nullopt;
+
+    return name(symbols_[index]);
+}
+
+auto symbol_table::find(const std::uint16_t address) const noexcept -> std::optional<symbol_match>
+{
+    const auto index = index_[address];
+
+    if (index == no_symbol)
+        return std::nullopt;
+
+    const auto &found_symbol = symbols_[index];
+    const auto offset = static_cast<std::uint16_t>(address - found_symbol.address);
+
+    if (offset > max_offset_)
+        return std::nullopt;
+
+    return symbol_match{name(found_symbol), offset};
+}
+
+void symbol_table::insert(const std::string_view name, const std::uint16_t address)
+{
+    symbols_.push_back({address, static_cast<std::uint32_t>(std::size(names_)),
+                        static_cast<std::uint32_t>(std::size(name))});
+    names_.append(name);
+}
+
+void symbol_table::build_index()
+{
+    // Stable, so the first symbol loaded for an address comes first.
+    std::stable_sort(std::begin(symbols_), std::end(symbols_),
+                     [](const auto &a, const auto &b) { return a.address < b.address; });
+
+    auto current = no_symbol;
+    auto next = std::size_t{0};
+
+    for (auto address = std::size_t{0}; address < address_count; ++address)
+    {
+        if (next < std::size(symbols_) && symbols_[next].address == address)
+        {
+            current = static_cast<std::uint32_t>(next);
+
+            while (next < std::size(symbols_) && symbols_[next].address == address)
+                ++next;
+        }
+
+        index_[address] = current;
+    }
+}
+
+auto format_symbol(const symbol_match &match, char *buffer, const std::size_t capacity) noexcept -> std::size_t
+{
+    auto length = std::min(std::size(match.name), capacity);
+    std::copy_n(std::data(match.name), length, buffer);
+
+    if (match.offset == 0 || length == capacity)
+        return length;
+
+    char digits[6];
+    auto count = 0;
+
+    for (auto value = match.offset; value != 0; value /= 10)
+        digits[count++] = static_cast<char>('0' + value % 10);
+
+    buffer[length++] = '+';
+
+    while (count > 0 && length < capacity)
+        buffer[length++] = digits[--count];
+
+    return length;
+}
+
+auto format_symbol(const decoded_instruction &instruction, const symbol_table &symbols, char *buffer,
+                   const std::size_t capacity) noexcept -> std::size_t
+{
+    const auto address = referenced_address(instruction);
+
+    if (!address)
+        return 0;
+
+    const auto match = symbols.find(*address);
+
+    if (!match)
+        return 0;
+
+    return format_symbol(*match, buffer, capacity);
+}
+
+} // namespace disasm6502
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace emu6502
+{
+
+/*!
+ * read: A data read through the bus.
+ * write: A write through the bus.
+ * fetch: An opcode or operand byte read by the cpu.
+ */
+enum class access_type
+{
+    read,
+    write,
+    fetch
+};
+
+inline constexpr std::size_t access_type_count = 3;
+
+/*!
+ * Number of accesses per address and type, counted by a bus that the counters are attached to.
+ *
+ * Only the emulation thread counts, with a relaxed load and store instead of an atomic increment, so
+ * counting costs about as much as a plain increment; any thread can read the counts while the machine
+ * runs. Counts wrap around, so readers should use the difference between two reads.
+ */
+class access_counters final
+{
+public:
+    access_counters() = default;
+    ~access_counters() = default;
+
+    access_counters(access_counters &&) noexcept = delete;
+    auto operator=(access_counters &&) noexcept -> access_counters & = delete;
+
+    access_counters(const access_counters &) noexcept = delete;
+    auto operator=(const access_counters &) noexcept -> access_counters & = delete;
+
+    void count(const access_type type, const std::uint16_t address) noexcept
+    {
+        auto &counter = counts_[static_cast<std::size_t>(type)][address];
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    auto get(const access_type type, const std::uint16_t address) const noexcept -> std::uint32_t
+    {
+        return counts_[static_cast<std::size_t>(type)][address].load(std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::array<std::atomic<std::uint32_t>, 0x10000>, access_type_count> counts_{};
+};
+
+} // namespace emu6502
@@ -2,12 +2,34 @@
 
 #include <emu6502/ibus_device.h>
 #include <emu6502/ic_register.h>
+#include <emu6502/spsc_ring_buffer.h>
+#include <atomic>
 #include <functional>
 
 namespace emu6502
 {
 
-using acia_6551_receive_func = std::function<void(std::uint8_t)>;
+class input_recorder;
+class input_player;
+
+/*!
+ * Called from the emulation thread when the first byte of a transmit burst was queued.
+ * It will not be called again until the host has drained the transmit FIFO through host_read.
+ */
+using acia_6551_transmit_notify_func = std::function<void()>;
+
+/*!
+ * accurate: Bytes are received and transmitted at the rate set in the control register, based on the bus clock.
+ * turbo: The next received byte is delivered as soon as the guest reads the previous one, and transmitting
+ *        completes instantly. Useful for bulk uploads.
+ *
+ * When the baud rate is unknown (external receiver clock), or the ACIA is not on a bus, turbo timing is used.
+ */
+enum class acia_6551_timing_mode
+{
+    accurate,
+    turbo
+};
 
 struct acia_6551_settings
 {
@@ -16,7 +38,9 @@ struct acia_6551_settings
     const std::uint16_t command_reg_address{};
     const std::uint16_t control_reg_address{};
     const bool simulate_wdc_bugs{};
-    acia_6551_receive_func receive_func;
+    const acia_6551_timing_mode timing_mode{acia_6551_timing_mode::turbo};
+    acia_6551_transmit_notify_func transmit_notify_func;
+    const std::size_t fifo_capacity{4096};
 };
 
 class acia_6551 : public ibus_device
@@ -51,21 +75,95 @@ public:
     acia_6551(const acia_6551 &) noexcept = delete;
     auto operator=(const acia_6551 &) noexcept -> acia_6551 & = delete;
 
+    /*!
+     * Place a byte directly in the receive data register, as if it was just shifted in.
+     * Must be called from the emulation thread.
+     */
     void recv_data(const std::uint8_t data, const recv_data_error error = recv_data_error::none) noexcept;
 
+    /*!
+     * Host side of the receive FIFO. Queues as many bytes as fit and returns the amount queued.
+     * Safe to call from a single host thread while the emulation is running.
+     */
+    auto host_write(const std::uint8_t *data, const std::size_t size) noexcept -> std::size_t;
+
+    /*!
+     * Host side of the transmit FIFO. Reads up to size bytes and returns the amount read.
+     * This re-arms the transmit notification, so the host should keep reading until
+     * less than size bytes are returned. Safe to call from a single host thread.
+     */
+    auto host_read(std::uint8_t *data, const std::size_t size) noexcept -> std::size_t;
+
+    /*!
+     * Replace the transmit notification. Must not be called while the emulation is running.
+     */
+    void set_transmit_notify_func(acia_6551_transmit_notify_func func);
+
+    /*!
+     * Discard everything in the receive and transmit FIFOs. Only safe while no host thread is using them.
+     */
+    void clear_fifos() noexcept;
+
+    /*!
+     * Log every byte the guest receives from the host, tagged with the given source. Pass nullptr to stop.
+     * Must not be called while the emulation is running.
+     */
+    void set_input_recorder(input_recorder *recorder, const std::uint8_t source) noexcept;
+
+    /*!
+     * Receive the bytes of the given source from a log instead of the host FIFO, at the cycles they were
+     * recorded at. Pass nullptr to go back to the host FIFO. Must not be called while the emulation is running.
+     */
+    void set_input_player(input_player *player, const std::uint8_t source) noexcept;
+
+    /*!
+     * Move the next byte from the receive FIFO into the data register if the register is empty.
+     * Must be called from the emulation thread.
+     */
+    void poll_receiver() noexcept;
+
+    /*!
+     * Switch between accurate and turbo timing. Safe to call from any thread; the emulation thread
+     * picks up the new mode on the next register access.
+     */
+    void set_timing_mode(const acia_6551_timing_mode mode) noexcept;
+    auto timing_mode() const noexcept -> acia_6551_timing_mode;
+
     auto baud_rate() const noexcept -> float;
     auto word_length() const noexcept -> int;
     auto stop_bits() const noexcept -> stop_bit_count;
     auto receiver_clock_source() const noexcept -> clock_source;
 
+    /*!
+     * Duration of one frame (start bit, data bits, parity and stop bits) in bus cycles,
+     * or 0 if it can't be determined.
+     */
+    auto frame_cycles() const noexcept -> std::uint64_t;
+
+    auto state_size() const noexcept -> std::size_t override;
+    void save_state(std::uint8_t *data) const noexcept override;
+    void load_state(const std::uint8_t *data) noexcept override;
+
 private:
     void hard_reset() noexcept;
     void soft_reset() noexcept;
 
+    auto next_received_byte(std::uint8_t &data) noexcept -> bool;
+
     void send_data(const std::uint8_t data) noexcept;
+    void start_transmit(const std::uint8_t data) noexcept;
+    void queue_transmit(const std::uint8_t data) noexcept;
+    void flush_transmitter() noexcept;
+
+    auto is_accurate_timing() const noexcept -> bool;
+    void update_clock_event() noexcept;
 
     void write(const std::uint16_t address, const std::uint8_t value) noexcept override;
     auto read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t> override;
+    auto peek(const std::uint16_t address) const noexcept -> std::tuple<bool, std::uint8_t> override;
+
+    void on_attached(bus &bus) noexcept override;
+    void on_clock_event(const std::uint64_t cycle) noexcept override;
 
     ic_register send_recv_data_register_;
     ic_register status_register_;
@@ -82,7 +180,31 @@ private:
      */
     bool simulate_wdc_bugs_;
 
-    acia_6551_receive_func receive_func_;
+    acia_6551_transmit_notify_func transmit_notify_func_;
+    std::atomic<bool> transmit_notify_pending_;
+
+    spsc_ring_buffer<std::uint8_t> receive_fifo_;
+    spsc_ring_buffer<std::uint8_t> transmit_fifo_;
+
+    std::atomic<acia_6551_timing_mode> timing_mode_;
+    bus *bus_;
+
+    input_recorder *input_recorder_;
+    input_player *input_player_;
+    std::uint8_t input_source_;
+
+    // Accurate timing state. The receiver samples the FIFO once per frame, the transmitter
+    // holds one byte in the shift register and one in the transmit data register.
+    bool receive_clock_active_;
+    std::uint64_t next_receive_cycle_;
+
+    bool transmit_shifting_;
+    std::uint8_t transmit_shift_register_;
+    std::uint64_t transmit_done_cycle_;
+    bool transmit_data_full_;
+    std::uint8_t transmit_data_;
+
+    std::uint64_t scheduled_cycle_;
 };
 
 } // namespace emu6502
@@ -1,17 +1,21 @@
 #pragma once
 
 #include <emu6502/ibus_interface.h>
+#include <array>
 #include <cstdint>
+#include <limits>
 #include <vector>
 
 namespace emu6502
 {
 
 class ibus_device;
+class access_counters;
 
 class bus final : public ibus_interface
 {
     friend class cpu_mos6502;
+    friend class machine_state;
 
 public:
     bus() = default;
@@ -28,14 +32,97 @@ public:
     void write(const std::uint16_t address, const std::uint8_t value) noexcept;
     auto read(const std::uint16_t) noexcept -> std::uint8_t;
 
+    /*!
+     * Read an opcode or operand byte. The same as read, except that it is counted as a fetch.
+     */
+    auto fetch(const std::uint16_t address) noexcept -> std::uint8_t;
+
+    /*!
+     * Read through ibus_device::peek, so no device changes state. Must be called from the emulation thread.
+     */
+    auto peek(const std::uint16_t address) const noexcept -> std::uint8_t;
+
+    /*!
+     * One bit per 256 byte page that was written through the bus since the last call, which clears them.
+     * Changes made without a bus write, such as loading device state, are not included.
+     */
+    auto take_written_pages() noexcept -> std::array<std::uint64_t, 4>;
+
+    /*!
+     * Count every read, write and fetch, or stop counting again with nullptr. Must be called from the
+     * emulation thread. While no counters are attached, counting costs a single check per access.
+     */
+    void set_access_counters(access_counters *counters) noexcept;
+
     void add(ibus_device &device);
 
+    /*!
+     * Detach a device again. Pending clock events of the device are cancelled.
+     */
+    void remove(ibus_device &device) noexcept;
+
+    auto devices() const noexcept -> const std::vector<ibus_device *> &
+    {
+        return devices_;
+    }
+
+    /*!
+     * Number of CPU cycles executed since the bus was created.
+     */
+    auto cycle() const noexcept
+    {
+        return cycle_;
+    }
+
+    /*!
+     * CPU clock in Hz. Used by devices to convert real time (like a baud rate) into cycles.
+     */
+    auto clock_frequency() const noexcept
+    {
+        return clock_frequency_;
+    }
+
+    void set_clock_frequency(const std::uint32_t frequency) noexcept;
+
+    /*!
+     * Request a call to device.on_clock_event once the clock reaches the given cycle.
+     * A device has at most one pending event; scheduling again replaces the previous one.
+     */
+    void schedule(ibus_device &device, const std::uint64_t cycle);
+    void cancel(ibus_device &device) noexcept;
+
 private:
+    struct clock_event
+    {
+        std::uint64_t cycle;
+        ibus_device *device;
+    };
+
     void set_cpu_bus_interface(ibus_interface *bus_interface) noexcept;
+    auto read_devices(const std::uint16_t address) noexcept -> std::uint8_t;
     void on_irq() noexcept override;
 
+    void tick(const std::uint32_t cycles) noexcept
+    {
+        cycle_ += cycles;
+
+        if (cycle_ >= next_event_cycle_)
+            run_clock_events();
+    }
+
+    void run_clock_events() noexcept;
+    void update_next_event_cycle() noexcept;
+
     std::vector<ibus_device *> devices_;
     ibus_interface *cpu_{};
+
+    std::uint64_t cycle_{};
+    std::uint32_t clock_frequency_{1000000};
+    std::uint64_t next_event_cycle_{std::numeric_limits<std::uint64_t>::max()};
+    std::vector<clock_event> clock_events_;
+
+    std::array<std::uint64_t, 4> written_pages_{};
+    access_counters *access_counters_{};
 };
 
 } // namespace emu6502
@@ -11,13 +11,44 @@
 #include <emu6502/ibus_interface.h>
 #include <cstdint>
 #include <array>
+#include <atomic>
 
 namespace emu6502
 {
 
 class icpu_debug_interface;
+class instruction_trace_writer;
 class bus;
 
+struct cpu_state
+{
+    std::uint8_t a{};
+    std::uint8_t x{};
+    std::uint8_t y{};
+    std::uint8_t sp{};
+    std::uint16_t pc{};
+    std::uint8_t status{};
+    std::uint32_t num_executed_instructions{};
+    std::uint64_t cycle{};
+    bool illegal_opcode{};
+};
+
+/*!
+ * Caller-owned memory that coverage is recorded into. Both maps are optional and may live in shared
+ * memory, for example a fuzzer's coverage map.
+ */
+struct cpu_coverage
+{
+    // AFL-style edge hit counters, indexed by a hash of the previous and the current branch target.
+    // The size must be a power of two.
+    std::uint8_t *edge_map{};
+    std::size_t edge_map_size{};
+
+    // One bit per address, set when an instruction at that address was executed. Must hold
+    // cpu_mos6502::executed_map_size bytes.
+    std::uint8_t *executed_map{};
+};
+
 class cpu_mos6502 final : public ibus_interface
 {
 public:
@@ -76,6 +107,41 @@ public:
 
     auto is_illegal_opcode_set() const noexcept -> bool;
 
+    /*!
+     * Copy of all registers and counters, including the bus cycle count.
+     */
+    auto state() const noexcept -> cpu_state;
+
+    /*!
+     * Restore registers and counters from a state. The cycle count belongs to the bus and is ignored.
+     */
+    void restore_state(const cpu_state &state) noexcept;
+
+    auto get_bus() const noexcept -> bus &
+    {
+        return bus_;
+    }
+
+    static constexpr std::size_t executed_map_size = 0x10000 / 8;
+
+    /*!
+     * Start recording coverage, or stop it again with a default constructed cpu_coverage. Must not be
+     * called while the cpu is executing. While disabled coverage costs nothing; edge coverage only adds
+     * a hash and an increment to instructions that change the flow of control.
+     */
+    void set_coverage(const cpu_coverage &coverage) noexcept;
+
+    /*!
+     * Forget the previous branch target, so the first edge of a run does not depend on the last run.
+     */
+    void reset_coverage_context() noexcept;
+
+    /*!
+     * Write every executed instruction to a trace, or stop tracing with nullptr. Must not be called while
+     * the cpu is executing. Like coverage, tracing is decided once per step call and costs nothing while off.
+     */
+    void set_trace(instruction_trace_writer *writer) noexcept;
+
 private:
     using opcode_exec_func = void (cpu_mos6502::*)(std::uint16_t) noexcept;
     using addr_exec_func = auto (cpu_mos6502::*)() noexcept -> std::uint16_t;
@@ -86,13 +152,28 @@ private:
         opcode_exec_func code;
     };
 
-    void exec(const instruction i) noexcept;
+    template <bool record_executed, bool trace>
+    void step_instructions(const std::uint32_t n) noexcept;
+
+    auto exec(const instruction i) noexcept -> std::uint16_t;
+
+    template <opcode_exec_func op>
+    void op_with_edge_coverage(std::uint16_t src) noexcept;
+    void record_edge() noexcept;
 
     void stack_push(std::uint8_t byte) noexcept;
     auto stack_pop() noexcept -> std::uint8_t;
 
     void bus_write(const std::uint16_t address, const std::uint8_t value) const noexcept;
     auto bus_read(const std::uint16_t address) const noexcept -> std::uint8_t;
+    auto bus_fetch(const std::uint16_t address) const noexcept -> std::uint8_t;
+
+    /*!
+     * Read the operand of an instruction that takes a value. An immediate operand is part of the
+     * instruction, so it is fetched rather than read.
+     */
+    template <bool immediate>
+    auto read_operand(const std::uint16_t src) const noexcept -> std::uint8_t;
 
     void on_irq() noexcept override;
 
@@ -112,7 +193,9 @@ private:
     auto addr_abi() noexcept -> std::uint16_t; // ABSOLUTE INDIRECT
 
     // opcodes (grouped as per datasheet)
+    template <bool immediate = false>
     void op_adc(std::uint16_t src) noexcept;
+    template <bool immediate = false>
     void op_and(std::uint16_t src) noexcept;
     void op_asl(std::uint16_t src) noexcept;
     void op_asl_acc(std::uint16_t src) noexcept;
@@ -133,13 +216,17 @@ private:
 
     void op_cli(std::uint16_t src) noexcept;
     void op_clv(std::uint16_t src) noexcept;
+    template <bool immediate = false>
     void op_cmp(std::uint16_t src) noexcept;
+    template <bool immediate = false>
     void op_cpx(std::uint16_t src) noexcept;
+    template <bool immediate = false>
     void op_cpy(std::uint16_t src) noexcept;
 
     void op_dec(std::uint16_t src) noexcept;
     void op_dex(std::uint16_t src) noexcept;
     void op_dey(std::uint16_t src) noexcept;
+    template <bool immediate = false>
     void op_eor(std::uint16_t src) noexcept;
     void op_inc(std::uint16_t src) noexcept;
 
@@ -147,13 +234,17 @@ private:
     void op_iny(std::uint16_t src) noexcept;
     void op_jmp(std::uint16_t src) noexcept;
     void op_jsr(std::uint16_t src) noexcept;
+    template <bool immediate = false>
     void op_lda(std::uint16_t src) noexcept;
 
+    template <bool immediate = false>
     void op_ldx(std::uint16_t src) noexcept;
+    template <bool immediate = false>
     void op_ldy(std::uint16_t src) noexcept;
     void op_lsr(std::uint16_t src) noexcept;
     void op_lsr_acc(std::uint16_t src) noexcept;
     void op_nop(std::uint16_t src) noexcept;
+    template <bool immediate = false>
     void op_ora(std::uint16_t src) noexcept;
 
     void op_pha(std::uint16_t src) noexcept;
@@ -167,6 +258,7 @@ private:
     void op_ror_acc(std::uint16_t src) noexcept;
     void op_rti(std::uint16_t src) noexcept;
     void op_rts(std::uint16_t src) noexcept;
+    template <bool immediate = false>
     void op_sbc(std::uint16_t src) noexcept;
     void op_sec(std::uint16_t src) noexcept;
     void op_sed(std::uint16_t src) noexcept;
@@ -190,7 +282,7 @@ private:
 
     std::array<instruction, 256> instruction_;
 
-    bool running_{};
+    std::atomic<bool> running_{};
 
     std::uint8_t register_a_{};
     std::uint8_t register_x_{};
@@ -203,6 +295,12 @@ private:
 
     bus &bus_;
     icpu_debug_interface *debug_interface_;
+
+    cpu_coverage coverage_{};
+    std::size_t edge_map_mask_{};
+    std::uint32_t previous_location_{};
+
+    instruction_trace_writer *trace_writer_{};
 };
 
 } // namespace emu6502
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <emu6502/cpu_mos6502.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace emu6502
+{
+
+enum class lockstep_page_access : std::uint8_t
+{
+    ram,
+    rom,
+    unmapped
+};
+
+/*!
+ * Experimental interpreter that runs up to max_lanes copies of the same program side by side.
+ *
+ * The registers of all lanes are kept in structure-of-arrays form. Every step the lanes are grouped
+ * by program counter and opcode; a group executes together, with the ALU and flag logic done on all
+ * lanes at once in SIMD registers and the lanes outside the group masked out. Lanes that diverged at
+ * a branch are picked up again once their program counters meet, because the lowest program counter
+ * always runs first.
+ *
+ * Every lane has its own flat 64KB address space instead of a bus. Pages can be marked as ROM (writes
+ * are ignored) or unmapped (reads return 0). With that memory layout the result of every lane is
+ * bit-identical to a cpu_mos6502 on a bus with ram and rom devices at the same places. There are no
+ * I/O devices and no interrupts.
+ */
+class cpu_mos6502_lockstep final
+{
+public:
+    static constexpr std::size_t max_lanes = 16;
+    static constexpr std::size_t memory_size = 0x10000;
+
+    explicit cpu_mos6502_lockstep(const std::size_t lane_count);
+    ~cpu_mos6502_lockstep() = default;
+
+    cpu_mos6502_lockstep(cpu_mos6502_lockstep &&) noexcept = delete;
+    auto operator=(cpu_mos6502_lockstep &&) noexcept -> cpu_mos6502_lockstep & = delete;
+
+    cpu_mos6502_lockstep(const cpu_mos6502_lockstep &) noexcept = delete;
+    auto operator=(const cpu_mos6502_lockstep &) noexcept -> cpu_mos6502_lockstep & = delete;
+
+    auto lane_count() const noexcept
+    {
+        return lane_count_;
+    }
+
+    /*!
+     * Set the access type of all 256 byte pages touched by [offset, offset + size). Pages are RAM by default.
+     */
+    void map(const std::uint16_t offset, const std::uint32_t size, const lockstep_page_access access) noexcept;
+
+    auto page_access(const std::uint8_t page) const noexcept
+    {
+        return pages_[page];
+    }
+
+    /*!
+     * Copy data into the memory of one lane, ignoring the page access types. Data in unmapped pages is
+     * dropped, so those keep reading as 0.
+     */
+    void load(const std::size_t lane, const std::uint16_t offset, const std::uint8_t *data,
+              const std::size_t size) noexcept;
+
+    /*!
+     * Copy the same data into the memory of every lane.
+     */
+    void load_all(const std::uint16_t offset, const std::uint8_t *data, const std::size_t size) noexcept;
+
+    auto memory(const std::size_t lane) const noexcept -> const std::uint8_t *
+    {
+        return std::data(memory_) + lane * memory_size;
+    }
+
+    /*!
+     * Reset all lanes, like cpu_mos6502::reset. The cycle counters are not touched.
+     */
+    void reset() noexcept;
+
+    /*!
+     * Execute n instructions on every lane. A lane stops early when it hits an illegal opcode.
+     */
+    void step(const std::uint32_t n = 1) noexcept;
+
+    /*!
+     * Registers and counters of one lane. The cycle count is the number of cycles executed by the lane.
+     */
+    auto state(const std::size_t lane) const noexcept -> cpu_state;
+    void restore_state(const std::size_t lane, const cpu_state &state) noexcept;
+
+    auto is_illegal_opcode_set(const std::size_t lane) const noexcept -> bool
+    {
+        return illegal_opcode_[lane] != 0;
+    }
+
+    /*!
+     * Number of groups executed so far. Compared with the executed instructions this shows how well the
+     * lanes stayed together.
+     */
+    auto num_executed_groups() const noexcept
+    {
+        return num_executed_groups_;
+    }
+
+private:
+    using lane_mask = std::uint32_t;
+
+    auto read(const std::size_t lane, const std::uint16_t address) const noexcept -> std::uint8_t;
+    void write(const std::size_t lane, const std::uint16_t address, const std::uint8_t value) noexcept;
+    void stack_push(const std::size_t lane, const std::uint8_t value) noexcept;
+    auto stack_pop(const std::size_t lane) noexcept -> std::uint8_t;
+
+    auto next_group(const lane_mask active, std::uint8_t &opcode) const noexcept -> lane_mask;
+    void execute(const lane_mask group, const std::uint8_t opcode) noexcept;
+    void resolve_addresses(const lane_mask group, const std::uint8_t opcode) noexcept;
+    void read_operands(const lane_mask group) noexcept;
+    void write_operands(const lane_mask group) noexcept;
+    void execute_adc(const lane_mask group) noexcept;
+    void execute_sbc(const lane_mask group) noexcept;
+
+    std::size_t lane_count_;
+
+    // One register per lane, padded to the vector width so it can be loaded in one go.
+    alignas(16) std::array<std::uint8_t, max_lanes> register_a_;
+    alignas(16) std::array<std::uint8_t, max_lanes> register_x_;
+    alignas(16) std::array<std::uint8_t, max_lanes> register_y_;
+    alignas(16) std::array<std::uint8_t, max_lanes> register_sp_;
+    alignas(16) std::array<std::uint8_t, max_lanes> register_status_;
+    alignas(16) std::array<std::uint8_t, max_lanes> illegal_opcode_;
+    std::array<std::uint16_t, max_lanes> register_pc_;
+    std::array<std::uint32_t, max_lanes> num_executed_instructions_;
+    std::array<std::uint64_t, max_lanes> cycles_;
+
+    // Scratch space for the instruction currently being executed.
+    alignas(16) std::array<std::uint8_t, max_lanes> operand_;
+    std::array<std::uint16_t, max_lanes> address_;
+
+    std::uint64_t num_executed_groups_;
+
+    std::array<lockstep_page_access, 256> pages_;
+    std::vector<std::uint8_t> memory_;
+};
+
+} // namespace emu6502
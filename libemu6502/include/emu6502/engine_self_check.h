@@ -0,0 +1,242 @@
+#pragma once
+
+#include <emu6502/cpu_mos6502.h>
+#include <emu6502/cpu_mos6502_lockstep.h>
+#include <emu6502/bus.h>
+#include <emu6502/ibus_device.h>
+#include <emu6502/machine_state.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace emu6502
+{
+
+/*!
+ * An execution engine that engine_self_check can run against the reference interpreter. The engine
+ * works on a flat 64KB address space without I/O devices.
+ */
+class iexecution_engine
+{
+public:
+    iexecution_engine(iexecution_engine &&) noexcept = delete;
+    auto operator=(iexecution_engine &&) noexcept -> iexecution_engine & = delete;
+
+    iexecution_engine(const iexecution_engine &) noexcept = delete;
+    auto operator=(const iexecution_engine &) noexcept -> iexecution_engine & = delete;
+
+    /*!
+     * Execute exactly n instructions.
+     */
+    virtual void step(const std::uint32_t n) noexcept = 0;
+
+    /*!
+     * Registers and counters. The cycle count only has to advance like the bus clock of the reference;
+     * its starting value doesn't matter.
+     */
+    virtual auto state() const noexcept -> cpu_state = 0;
+    virtual void restore_state(const cpu_state &state) noexcept = 0;
+
+    /*!
+     * The whole 64KB address space, and a way to overwrite it again from a copy taken earlier.
+     */
+    virtual auto memory() const noexcept -> const std::uint8_t * = 0;
+    virtual void restore_memory(const std::uint8_t *data) noexcept = 0;
+
+    /*!
+     * How every 256 byte page behaves, so the reference machine can be built with the same layout.
+     */
+    virtual auto page_access(const std::uint8_t page) const noexcept -> lockstep_page_access = 0;
+
+protected:
+    iexecution_engine() = default;
+    virtual ~iexecution_engine() = default;
+};
+
+/*!
+ * One lane of a cpu_mos6502_lockstep as an execution engine. Stepping runs all lanes, but only the
+ * selected one is checked and restored.
+ */
+class lockstep_lane_engine final : public iexecution_engine
+{
+public:
+    explicit lockstep_lane_engine(cpu_mos6502_lockstep &cpu, const std::size_t lane = 0);
+    ~lockstep_lane_engine() final = default;
+
+    lockstep_lane_engine(lockstep_lane_engine &&) noexcept = delete;
+    auto operator=(lockstep_lane_engine &&) noexcept -> lockstep_lane_engine & = delete;
+
+    lockstep_lane_engine(const lockstep_lane_engine &) noexcept = delete;
+    auto operator=(const lockstep_lane_engine &) noexcept -> lockstep_lane_engine & = delete;
+
+    void step(const std::uint32_t n) noexcept final;
+    auto state() const noexcept -> cpu_state final;
+    void restore_state(const cpu_state &state) noexcept final;
+    auto memory() const noexcept -> const std::uint8_t * final;
+    void restore_memory(const std::uint8_t *data) noexcept final;
+    auto page_access(const std::uint8_t page) const noexcept -> lockstep_page_access final;
+
+private:
+    cpu_mos6502_lockstep &cpu_;
+    std::size_t lane_;
+};
+
+struct self_check_settings
+{
+    // Registers are compared after every this many instructions.
+    std::uint32_t register_interval{1000};
+
+    // Memory is compared after every this many instructions: every page the reference wrote to since the
+    // last comparison, plus a few pages that take turns, to catch writes that only the engine made.
+    std::uint32_t memory_interval{100000};
+    std::uint32_t sampled_pages{4};
+
+    // After every this many instructions the whole address space is compared and both machines are
+    // saved. A mismatch is tracked down by replaying from the last of these checkpoints.
+    std::uint64_t checkpoint_interval{10000000};
+
+    // At most this many differing addresses are listed in a mismatch.
+    std::size_t max_memory_differences{32};
+};
+
+struct self_check_memory_difference
+{
+    std::uint16_t address;
+    std::uint8_t expected;
+    std::uint8_t actual;
+};
+
+/*!
+ * The first instruction after which the engine no longer matched the reference. Expected is the state
+ * of the reference, actual the state of the engine; both cycle counts are relative to the start of the
+ * check.
+ */
+struct self_check_mismatch
+{
+    std::uint64_t instruction{};
+    cpu_state before{};
+    std::uint8_t opcode{};
+    cpu_state expected{};
+    cpu_state actual{};
+    std::vector<self_check_memory_difference> memory;
+    std::size_t memory_difference_count{};
+};
+
+/*!
+ * Human readable description of a mismatch, listing every differing register and address.
+ */
+auto to_string(const self_check_mismatch &mismatch) -> std::string;
+
+/*!
+ * Runs an execution engine in lockstep with a reference cpu_mos6502 and stops at the first instruction
+ * where the two disagree.
+ *
+ * The reference machine is a clone of the engine at construction: the same registers, memory and page
+ * layout. Checks are tiered so long runs stay cheap: registers are compared often, memory only where
+ * it can have changed plus a rotating sample, and everything only at checkpoints. When any check fails,
+ * both machines go back to the last checkpoint and the run is repeated with full comparisons, first in
+ * steps of register_interval instructions and then instruction by instruction, to find the exact
+ * instruction that went wrong.
+ */
+class engine_self_check final
+{
+public:
+    explicit engine_self_check(iexecution_engine &engine, const self_check_settings &settings = {});
+    ~engine_self_check() = default;
+
+    engine_self_check(engine_self_check &&) noexcept = delete;
+    auto operator=(engine_self_check &&) noexcept -> engine_self_check & = delete;
+
+    engine_self_check(const engine_self_check &) noexcept = delete;
+    auto operator=(const engine_self_check &) noexcept -> engine_self_check & = delete;
+
+    /*!
+     * Run up to the given number of instructions. Returns the mismatch if one was found; the run then
+     * stops, and both machines are left right after the offending instruction. A run also stops early
+     * once the reference hits an illegal opcode.
+     */
+    auto run(const std::uint64_t instructions) -> std::optional<self_check_mismatch>;
+
+    /*!
+     * Number of instructions executed and checked so far.
+     */
+    auto executed() const noexcept
+    {
+        return executed_;
+    }
+
+private:
+    /*!
+     * Flat memory of the reference machine, laid out like the engine's. Remembers which pages were
+     * written, so only those have to be compared.
+     */
+    class reference_memory final : public ibus_device
+    {
+    public:
+        explicit reference_memory(const iexecution_engine &engine);
+        ~reference_memory() = default;
+
+        reference_memory(reference_memory &&) noexcept = delete;
+        auto operator=(reference_memory &&) noexcept -> reference_memory & = delete;
+
+        reference_memory(const reference_memory &) noexcept = delete;
+        auto operator=(const reference_memory &) noexcept -> reference_memory & = delete;
+
+        void write(const std::uint16_t address, const std::uint8_t value) noexcept final;
+        auto read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t> final;
+        auto peek(const std::uint16_t address) const noexcept -> std::tuple<bool, std::uint8_t> final;
+
+        auto state_size() const noexcept -> std::size_t final;
+        void save_state(std::uint8_t *data) const noexcept final;
+        void load_state(const std::uint8_t *data) noexcept final;
+
+        auto data() const noexcept
+        {
+            return std::data(data_);
+        }
+
+        auto written_pages() const noexcept -> const std::array<std::uint64_t, 4> &
+        {
+            return written_pages_;
+        }
+
+        void clear_written_pages() noexcept;
+
+    private:
+        std::array<lockstep_page_access, 256> pages_;
+        std::vector<std::uint8_t> data_;
+        std::array<std::uint64_t, 4> written_pages_;
+    };
+
+    void step(const std::uint32_t n) noexcept;
+    auto registers_match() const noexcept -> bool;
+    auto sampled_memory_matches() noexcept -> bool;
+    auto memory_matches() const noexcept -> bool;
+    void save_checkpoint();
+    void restore_checkpoint(const machine_state &reference, const cpu_state &engine_state,
+                            const std::vector<std::uint8_t> &engine_memory, const std::uint64_t executed);
+    auto locate_mismatch() -> self_check_mismatch;
+
+    iexecution_engine &engine_;
+    self_check_settings settings_;
+
+    reference_memory memory_;
+    bus bus_;
+    cpu_mos6502 cpu_;
+
+    std::uint64_t reference_cycle_base_;
+    std::uint64_t engine_cycle_base_;
+    std::uint64_t executed_;
+    std::uint64_t next_memory_check_;
+    std::uint64_t next_checkpoint_;
+    std::uint32_t next_sampled_page_;
+
+    machine_state checkpoint_reference_;
+    cpu_state checkpoint_engine_state_;
+    std::vector<std::uint8_t> checkpoint_engine_memory_;
+    std::uint64_t checkpoint_executed_;
+};
+
+} // namespace emu6502
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <tuple>
 
 namespace emu6502
 {
 
+class bus;
+
 class ibus_device
 {
 public:
@@ -18,6 +21,49 @@ public:
     virtual void write(const std::uint16_t address, const std::uint8_t value) noexcept = 0;
     virtual auto read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t> = 0;
 
+    /*!
+     * Like read, but without side effects such as clearing status flags, for debuggers and tracers.
+     * Devices that don't override it are invisible to peeking.
+     */
+    virtual auto peek([[maybe_unused]] const std::uint16_t address) const noexcept -> std::tuple<bool, std::uint8_t>
+    {
+        return {false, 0};
+    }
+
+    /*!
+     * Called when the device is added to a bus. Devices that need the bus clock can keep the reference.
+     */
+    virtual void on_attached([[maybe_unused]] bus &bus) noexcept
+    {
+    }
+
+    /*!
+     * Called from the emulation thread when the bus clock reached a cycle requested through bus::schedule.
+     */
+    virtual void on_clock_event([[maybe_unused]] const std::uint64_t cycle) noexcept
+    {
+    }
+
+    /*!
+     * Size in bytes of the state written by save_state. Must stay the same for the lifetime of the device.
+     */
+    virtual auto state_size() const noexcept -> std::size_t
+    {
+        return 0;
+    }
+
+    /*!
+     * Write the device state into a buffer of state_size() bytes, and restore it again. Only the emulated
+     * state is included; host-side buffers such as serial FIFOs are not.
+     */
+    virtual void save_state([[maybe_unused]] std::uint8_t *data) const noexcept
+    {
+    }
+
+    virtual void load_state([[maybe_unused]] const std::uint8_t *data) noexcept
+    {
+    }
+
 protected:
     ibus_device() = default;
     ~ibus_device() = default;
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <aeon/streams/stream_fwd.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace emu6502
+{
+
+enum class input_event_type : std::uint8_t
+{
+    acia_receive,
+    irq,
+    nmi,
+    reset
+};
+
+/*!
+ * Input that reached the machine from outside. The cycle is the bus cycle at which the machine took the
+ * input; source tells devices of the same type apart and value holds the received byte.
+ */
+struct input_event
+{
+    std::uint64_t cycle{};
+    input_event_type type{};
+    std::uint8_t source{};
+    std::uint8_t value{};
+};
+
+/*!
+ * Appends input events to a stream in a compact binary format: a small header, followed by one tag
+ * byte per event, the distance in cycles to the previous event as a variable-length integer and the
+ * value for received bytes. Most events take 3 or 4 bytes.
+ *
+ * Events are collected in a buffer that is written to the stream whenever it fills up, so recording
+ * costs a few instructions per event. Everything is called from the emulation thread.
+ */
+class input_recorder final
+{
+public:
+    static constexpr std::uint32_t format_version = 1;
+    static constexpr std::uint8_t max_source = 63;
+
+    explicit input_recorder(aeon::streams::stream &stream, const std::size_t buffer_size = 64 * 1024);
+    ~input_recorder();
+
+    input_recorder(input_recorder &&) noexcept = delete;
+    auto operator=(input_recorder &&) noexcept -> input_recorder & = delete;
+
+    input_recorder(const input_recorder &) noexcept = delete;
+    auto operator=(const input_recorder &) noexcept -> input_recorder & = delete;
+
+    /*!
+     * Append an event. Events must be recorded in cycle order. If the stream stopped accepting data,
+     * events are dropped and failed() returns true.
+     */
+    void record(const input_event &event) noexcept;
+
+    /*!
+     * Write all buffered events to the stream.
+     */
+    void flush() noexcept;
+
+    auto failed() const noexcept
+    {
+        return failed_;
+    }
+
+    auto event_count() const noexcept
+    {
+        return event_count_;
+    }
+
+private:
+    void write(const std::uint8_t *data, const std::size_t size) noexcept;
+
+    aeon::streams::stream &stream_;
+    std::vector<std::uint8_t> buffer_;
+    std::size_t used_;
+    std::uint64_t previous_cycle_;
+    std::uint64_t event_count_;
+    bool failed_;
+};
+
+/*!
+ * Reads a log written by input_recorder back, one event at a time, without loading the whole file.
+ *
+ * Replaying is deterministic as long as the machine starts from the same state as when recording
+ * started, with the same devices and settings. The devices and the machine_runner take the events at
+ * the recorded cycles instead of taking input from the host.
+ */
+class input_player final
+{
+public:
+    /*!
+     * Throws if the stream does not start with an input log header of the supported version.
+     */
+    explicit input_player(aeon::streams::stream &stream, const std::size_t buffer_size = 64 * 1024);
+    ~input_player() = default;
+
+    input_player(input_player &&) noexcept = delete;
+    auto operator=(input_player &&) noexcept -> input_player & = delete;
+
+    input_player(const input_player &) noexcept = delete;
+    auto operator=(const input_player &) noexcept -> input_player & = delete;
+
+    /*!
+     * The next event, or nullptr once the log is exhausted. A truncated last event is ignored.
+     */
+    auto peek() const noexcept -> const input_event *
+    {
+        return has_event_ ? &event_ : nullptr;
+    }
+
+    void pop() noexcept;
+
+    /*!
+     * Pop the next event if it has the given type and source and is due at the given cycle. An event
+     * that is taken later than its recorded cycle marks the replay as desynchronized.
+     */
+    auto take(const input_event_type type, const std::uint8_t source, const std::uint64_t cycle,
+              std::uint8_t &value) noexcept -> bool;
+
+    /*!
+     * Drop the next event because it can no longer be delivered at its cycle.
+     */
+    void skip() noexcept;
+
+    /*!
+     * True once the machine did not follow the recording; from there on the replay is not exact.
+     */
+    auto desynchronized() const noexcept
+    {
+        return desynchronized_;
+    }
+
+private:
+    auto read_byte(std::uint8_t &value) noexcept -> bool;
+    void decode_next() noexcept;
+
+    aeon::streams::stream &stream_;
+    std::vector<std::uint8_t> buffer_;
+    std::size_t position_;
+    std::size_t size_;
+
+    input_event event_;
+    bool has_event_;
+    bool desynchronized_;
+};
+
+} // namespace emu6502
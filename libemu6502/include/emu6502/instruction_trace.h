@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace emu6502
+{
+
+class mapped_file;
+
+/*!
+ * One executed instruction. The registers and the cycle are the values right before the instruction
+ * executed; the effective address is the one computed by its addressing mode (0 for implied modes).
+ * Operand bytes beyond the length of the instruction are 0.
+ */
+struct trace_record
+{
+    std::uint64_t cycle{};
+    std::uint16_t pc{};
+    std::uint16_t effective_address{};
+    std::uint8_t opcode{};
+    std::array<std::uint8_t, 2> operand{};
+    std::uint8_t a{};
+    std::uint8_t x{};
+    std::uint8_t y{};
+    std::uint8_t sp{};
+    std::uint8_t status{};
+};
+
+inline auto operator==(const trace_record &lhs, const trace_record &rhs) noexcept
+{
+    return lhs.cycle == rhs.cycle && lhs.pc == rhs.pc && lhs.effective_address == rhs.effective_address &&
+           lhs.opcode == rhs.opcode && lhs.operand == rhs.operand && lhs.a == rhs.a && lhs.x == rhs.x &&
+           lhs.y == rhs.y && lhs.sp == rhs.sp && lhs.status == rhs.status;
+}
+
+inline auto operator!=(const trace_record &lhs, const trace_record &rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+/*!
+ * append: The file grows as records are written and holds the complete trace.
+ * ring: The file has a fixed number of blocks. Once full, the oldest block is overwritten, so the file
+ *       holds the most recent instructions.
+ */
+enum class trace_file_mode : std::uint32_t
+{
+    append,
+    ring
+};
+
+struct trace_writer_settings
+{
+    trace_file_mode mode{trace_file_mode::append};
+
+    // Records are stored in blocks of this many bytes. Every block starts with a complete record, so
+    // a block can be decoded on its own; this bounds the cost of reading one record at random.
+    std::uint32_t block_size{64 * 1024};
+
+    // Size of a ring file, or the number of blocks an append file grows by at a time.
+    std::uint64_t block_count{1024};
+};
+
+/*!
+ * Writes executed instructions into a memory-mapped trace file.
+ *
+ * Each record is stored relative to the one before it: a byte of flags, the opcode and operand bytes,
+ * and then only the fields that differ from what the previous instruction predicts. The program
+ * counter, cycle and effective address usually follow from the previous record and the operands, so
+ * the common case takes 3 to 6 bytes.
+ *
+ * Attach it to a cpu with cpu_mos6502::set_trace. Only called from the emulation thread.
+ */
+class instruction_trace_writer final
+{
+public:
+    static constexpr std::uint32_t format_version = 1;
+
+    /*!
+     * Create or overwrite a trace file. Throws if the file can't be created or mapped.
+     */
+    explicit instruction_trace_writer(const std::filesystem::path &path, const trace_writer_settings &settings = {});
+    ~instruction_trace_writer();
+
+    instruction_trace_writer(instruction_trace_writer &&) noexcept = delete;
+    auto operator=(instruction_trace_writer &&) noexcept -> instruction_trace_writer & = delete;
+
+    instruction_trace_writer(const instruction_trace_writer &) noexcept = delete;
+    auto operator=(const instruction_trace_writer &) noexcept -> instruction_trace_writer & = delete;
+
+    /*!
+     * Append a record. If an append file can't grow any further, records are dropped and failed()
+     * returns true.
+     */
+    void append(const trace_record &record) noexcept;
+
+    /*!
+     * Make all records written so far visible to a reader that opens the file.
+     */
+    void flush() noexcept;
+
+    auto record_count() const noexcept
+    {
+        return next_index_;
+    }
+
+    auto failed() const noexcept
+    {
+        return failed_;
+    }
+
+private:
+    auto block_data(const std::uint64_t block) const noexcept -> std::uint8_t *;
+    void begin_block(const std::uint64_t block) noexcept;
+    void next_block() noexcept;
+    void write_block_header() noexcept;
+    void write_file_header() noexcept;
+
+    std::unique_ptr<mapped_file> file_;
+    trace_writer_settings settings_;
+    std::uint64_t block_count_;
+
+    std::uint64_t block_;
+    std::uint8_t *block_begin_;
+    std::size_t block_used_;
+    std::uint32_t block_records_;
+    std::uint64_t block_first_index_;
+
+    std::uint64_t next_index_;
+    trace_record previous_;
+    bool failed_;
+};
+
+/*!
+ * Decodes a trace file written by instruction_trace_writer. Records are addressed by their index in the
+ * trace; in a ring file the oldest ones are gone, so the first available index can be above 0.
+ */
+class instruction_trace_reader final
+{
+public:
+    /*!
+     * Encoded records as stored in the file. Data points to the first used bytes of the block, including
+     * its header. Traces written with the same block size store the same records in identical bytes.
+     */
+    struct block
+    {
+        std::uint64_t first_index;
+        std::uint32_t record_count;
+        std::uint32_t used;
+        const std::uint8_t *data;
+    };
+
+    /*!
+     * Throws if the file can't be mapped or is not a trace file of a supported version.
+     */
+    explicit instruction_trace_reader(const std::filesystem::path &path);
+    ~instruction_trace_reader();
+
+    instruction_trace_reader(instruction_trace_reader &&) noexcept = delete;
+    auto operator=(instruction_trace_reader &&) noexcept -> instruction_trace_reader & = delete;
+
+    instruction_trace_reader(const instruction_trace_reader &) noexcept = delete;
+    auto operator=(const instruction_trace_reader &) noexcept -> instruction_trace_reader & = delete;
+
+    auto first_index() const noexcept
+    {
+        return first_index_;
+    }
+
+    auto record_count() const noexcept
+    {
+        return record_count_;
+    }
+
+    /*!
+     * Read one record. Throws std::out_of_range if the index is not in the trace.
+     */
+    auto read(const std::uint64_t index) const -> trace_record;
+
+    /*!
+     * Decode up to count consecutive records starting at index. Returns the number of records read.
+     */
+    auto read(const std::uint64_t index, trace_record *records, const std::size_t count) const noexcept
+        -> std::size_t;
+
+    /*!
+     * The blocks that hold the records of the trace, ordered by their first index.
+     */
+    const auto &blocks() const noexcept
+    {
+        return blocks_;
+    }
+
+private:
+    std::unique_ptr<mapped_file> file_;
+    std::vector<block> blocks_;
+    std::uint64_t first_index_;
+    std::uint64_t record_count_;
+};
+
+} // namespace emu6502
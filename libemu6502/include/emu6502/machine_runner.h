@@ -0,0 +1,241 @@
+#pragma once
+
+#include <emu6502/access_counters.h>
+#include <emu6502/cpu_mos6502.h>
+#include <emu6502/input_log.h>
+#include <emu6502/memory_mirror.h>
+#include <emu6502/seqlock.h>
+#include <emu6502/spsc_ring_buffer.h>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace emu6502
+{
+
+enum class machine_command_type
+{
+    run,
+    stop,
+    step,
+    reset,
+    irq,
+    nmi,
+    add_breakpoint,
+    remove_breakpoint,
+    clear_breakpoints,
+    watch_memory,
+    unwatch_memory,
+    watch_accesses,
+    unwatch_accesses
+};
+
+struct machine_command
+{
+    machine_command_type type{};
+
+    // Instruction count for step, address for breakpoints.
+    std::uint32_t argument{};
+};
+
+enum class machine_event_type
+{
+    started,
+    stopped,
+    step_completed,
+    reset,
+    breakpoint_hit,
+    illegal_opcode
+};
+
+struct machine_event
+{
+    machine_event_type type{};
+    cpu_state state{};
+};
+
+/*!
+ * Continuously published view of the machine, for displays that poll at a fixed rate.
+ */
+struct machine_snapshot
+{
+    cpu_state state{};
+    bool running{};
+
+    // Page 1, peeked through the bus.
+    std::array<std::uint8_t, 256> stack{};
+};
+
+/*!
+ * Called from the runner thread when the first event after the last poll_event was published.
+ * It will not be called again until the consumer has polled.
+ */
+using machine_event_notify_func = std::function<void()>;
+
+/*!
+ * Executes a cpu on a dedicated thread. Once started, the runner thread is the only thread that
+ * may touch the cpu, its bus and the devices on it.
+ *
+ * Commands are passed in through a lock-free queue that is checked between batches of instructions.
+ * State changes are published through a second lock-free queue; if the consumer falls behind, events
+ * are dropped rather than stalling emulation.
+ */
+class machine_runner final
+{
+public:
+    explicit machine_runner(cpu_mos6502 &cpu, machine_event_notify_func notify_func = {});
+    ~machine_runner();
+
+    machine_runner(machine_runner &&) noexcept = delete;
+    auto operator=(machine_runner &&) noexcept -> machine_runner & = delete;
+
+    machine_runner(const machine_runner &) noexcept = delete;
+    auto operator=(const machine_runner &) noexcept -> machine_runner & = delete;
+
+    void start();
+    void shutdown();
+
+    /*!
+     * Queue a command. Must always be called from the same thread. Returns false if the queue is full.
+     */
+    auto send(const machine_command command) -> bool;
+
+    auto run() -> bool;
+    auto stop() -> bool;
+    auto step(const std::uint32_t count = 1) -> bool;
+    auto reset() -> bool;
+    auto irq() -> bool;
+    auto nmi() -> bool;
+    auto add_breakpoint(const std::uint16_t address) -> bool;
+    auto remove_breakpoint(const std::uint16_t address) -> bool;
+    auto clear_breakpoints() -> bool;
+
+    /*!
+     * Keep memory() up to date while at least one watcher is registered. Watching starts with a copy of
+     * every page; from then on only the pages written through the bus are copied again, at most once per
+     * display frame while running, and always after the runner stops or finishes a step.
+     */
+    auto watch_memory() -> bool;
+    auto unwatch_memory() -> bool;
+
+    /*!
+     * Count the accesses to every address in accesses() while at least one watcher is registered. The
+     * counts keep their values while nobody watches, so watchers should only look at how they change.
+     */
+    auto watch_accesses() -> bool;
+    auto unwatch_accesses() -> bool;
+
+    /*!
+     * Log the reset, IRQ and NMI commands with the cycle they were executed at. The log is flushed
+     * whenever the runner goes idle. Must be called before start.
+     */
+    void set_input_recorder(input_recorder *recorder) noexcept;
+
+    /*!
+     * Take resets, IRQs and NMIs from a log at their recorded cycles; the matching commands are ignored
+     * while a player is set. Devices that replay their own input from the same log must use the same
+     * player. Must be called before start.
+     */
+    void set_input_player(input_player *player) noexcept;
+
+    /*!
+     * Take the next published event. This re-arms the notification, so the consumer should keep
+     * polling until false is returned. Must always be called from the same thread.
+     */
+    auto poll_event(machine_event &event) noexcept -> bool;
+
+    /*!
+     * Drop every published event and re-arm the notification, for consumers that only need to know
+     * that something changed. Returns the number of events dropped. Must be called from the thread that
+     * polls events.
+     */
+    auto discard_events() noexcept -> std::size_t;
+
+    /*!
+     * True while instructions are being executed. Safe to call from any thread.
+     */
+    auto is_running() const noexcept -> bool;
+
+    /*!
+     * Latest snapshot. While running it is refreshed at most once per millisecond, and always
+     * after the runner stops or finishes a step. Safe to call from any thread; never blocks the runner.
+     */
+    auto snapshot() const noexcept -> machine_snapshot;
+
+    /*!
+     * Changes whenever a new snapshot is published.
+     */
+    auto snapshot_version() const noexcept -> std::uint32_t;
+
+    /*!
+     * Copy of the address space, kept up to date while memory is watched. Safe to read from any thread.
+     */
+    auto memory() const noexcept -> const memory_mirror &
+    {
+        return memory_;
+    }
+
+    /*!
+     * Access counts, updated while accesses are watched. Safe to read from any thread.
+     */
+    auto accesses() const noexcept -> const access_counters &
+    {
+        return *accesses_;
+    }
+
+private:
+    void thread_main();
+    void execute(const machine_command &command);
+    void execute_batch();
+    void record_input(const input_event_type type) noexcept;
+    void replay_inputs() noexcept;
+    auto steps_until_next_input() const noexcept -> std::uint64_t;
+    void set_steps_remaining(const std::uint64_t steps) noexcept;
+    void publish(const machine_event_type type) noexcept;
+    void publish_snapshot() noexcept;
+    void publish_memory() noexcept;
+
+    cpu_mos6502 &cpu_;
+
+    spsc_ring_buffer<machine_command> commands_;
+    spsc_ring_buffer<machine_event> events_;
+
+    machine_event_notify_func notify_func_;
+    std::atomic<bool> notify_pending_;
+
+    seqlock<machine_snapshot> snapshot_;
+    std::chrono::steady_clock::time_point last_snapshot_time_;
+
+    memory_mirror memory_;
+    std::chrono::steady_clock::time_point last_memory_time_;
+
+    std::unique_ptr<access_counters> accesses_;
+
+    // Only touched by the runner thread.
+    std::bitset<65536> breakpoints_;
+    std::size_t breakpoint_count_;
+    bool skip_breakpoint_;
+    std::uint64_t steps_remaining_;
+    input_recorder *input_recorder_;
+    input_player *input_player_;
+    std::uint32_t memory_watchers_;
+    std::uint32_t access_watchers_;
+
+    std::atomic<bool> running_;
+    std::atomic<bool> quit_;
+
+    // Only used to put the runner thread to sleep while it has nothing to execute.
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+
+    std::thread thread_;
+};
+
+} // namespace emu6502
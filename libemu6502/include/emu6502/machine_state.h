@@ -0,0 +1,74 @@
+#pragma once
+
+#include <emu6502/cpu_mos6502.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace emu6502
+{
+
+/*!
+ * Flat, versioned snapshot of a cpu, its bus and the state of every device on that bus.
+ *
+ * The layout is computed once when the object is created, so saving and restoring are a handful of
+ * memcpy calls into and out of one contiguous buffer. The buffer can be written to disk as-is, and
+ * can only be restored into a machine with the same devices in the same order.
+ */
+class machine_state final
+{
+public:
+    static constexpr std::uint32_t format_version = 1;
+
+    explicit machine_state(const cpu_mos6502 &cpu);
+    ~machine_state() = default;
+
+    machine_state(machine_state &&) noexcept = default;
+    auto operator=(machine_state &&) noexcept -> machine_state & = default;
+
+    machine_state(const machine_state &) = default;
+    auto operator=(const machine_state &) -> machine_state & = default;
+
+    /*!
+     * Capture the machine. Must be called from the thread that runs it, while it is not executing.
+     */
+    void save(const cpu_mos6502 &cpu) noexcept;
+
+    /*!
+     * Restore a previously saved machine. Throws if the buffer was made for a different machine layout.
+     */
+    void restore(cpu_mos6502 &cpu) const;
+
+    /*!
+     * Replace the buffer, for example with data that was read from a file. Throws if the data is not a
+     * machine state of the same format version and size, or if any of its sections does not fit.
+     */
+    void assign(const std::uint8_t *data, const std::size_t size);
+
+    auto data() const noexcept
+    {
+        return std::data(buffer_);
+    }
+
+    auto size() const noexcept
+    {
+        return std::size(buffer_);
+    }
+
+private:
+    void validate(const cpu_mos6502 &cpu) const;
+
+    /*!
+     * Check that the device sections match the layout and that every clock event refers to a device, so
+     * restoring never reads past a section or looks up a device that does not exist.
+     */
+    void validate_sections(const std::uint8_t *data) const;
+
+    std::size_t cpu_offset_;
+    std::size_t bus_offset_;
+    std::size_t device_table_offset_;
+    std::vector<std::size_t> device_offsets_;
+    std::vector<std::uint8_t> buffer_;
+};
+
+} // namespace emu6502
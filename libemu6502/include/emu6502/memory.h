@@ -35,11 +35,16 @@ public:
         return std::size(data_);
     }
 
+    auto state_size() const noexcept -> std::size_t override;
+    void save_state(std::uint8_t *data) const noexcept override;
+    void load_state(const std::uint8_t *data) noexcept override;
+
 protected:
     explicit memory(const std::uint16_t offset, const std::uint16_t size);
 
     void write(const std::uint16_t address, const std::uint8_t value) noexcept override;
     auto read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t> override;
+    auto peek(const std::uint16_t address) const noexcept -> std::tuple<bool, std::uint8_t> override;
 
     std::uint16_t offset_;
     std::vector<std::uint8_t> data_;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <emu6502/seqlock.h>
+#include <array>
+#include <cstdint>
+
+namespace emu6502
+{
+
+class bus;
+
+using memory_page = std::array<std::uint8_t, 256>;
+
+/*!
+ * A copy of the whole address space as seen through bus::peek, which other threads can read while the
+ * machine is running.
+ *
+ * Every page is stored separately with its own version, so the emulation thread only copies the pages
+ * that were written since its last update, and a reader only has to look at the pages whose version
+ * changed since it last read them.
+ */
+class memory_mirror final
+{
+public:
+    memory_mirror() = default;
+    ~memory_mirror() = default;
+
+    memory_mirror(memory_mirror &&) noexcept = delete;
+    auto operator=(memory_mirror &&) noexcept -> memory_mirror & = delete;
+
+    memory_mirror(const memory_mirror &) noexcept = delete;
+    auto operator=(const memory_mirror &) noexcept -> memory_mirror & = delete;
+
+    /*!
+     * Writer side, called from the emulation thread: copy the pages that have their bit set, as returned
+     * by bus::take_written_pages.
+     */
+    void update(const bus &bus, const std::array<std::uint64_t, 4> &pages) noexcept;
+
+    /*!
+     * Writer side: copy every page.
+     */
+    void update_all(const bus &bus) noexcept;
+
+    /*!
+     * Changes whenever the page is updated. Safe to call from any thread.
+     */
+    auto version(const std::uint8_t page) const noexcept
+    {
+        return pages_[page].version();
+    }
+
+    /*!
+     * Consistent copy of a page. Safe to call from any thread.
+     */
+    auto page(const std::uint8_t page) const noexcept -> memory_page
+    {
+        return pages_[page].load();
+    }
+
+private:
+    void update_page(const bus &bus, const std::uint8_t page) noexcept;
+
+    std::array<seqlock<memory_page>, 256> pages_;
+};
+
+} // namespace emu6502
@@ -17,6 +17,11 @@ public:
     rom(const rom &) noexcept = delete;
     auto operator=(const rom &) noexcept -> rom & = delete;
 
+    // The contents can't change while emulating, so they are left out of machine snapshots.
+    auto state_size() const noexcept -> std::size_t override;
+    void save_state(std::uint8_t *data) const noexcept override;
+    void load_state(const std::uint8_t *data) noexcept override;
+
 private:
     void write(const std::uint16_t address, const std::uint8_t value) noexcept override;
 };
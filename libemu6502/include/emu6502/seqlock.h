@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace emu6502
+{
+
+/*!
+ * Single writer, multiple reader sequence lock for small trivially copyable values.
+ *
+ * The writer never waits. Readers retry while a write is in progress, so a reader always gets a
+ * consistent copy. The value is stored as relaxed atomic words, so concurrent access is well defined.
+ */
+template <typename T>
+class seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "seqlock requires a trivially copyable type.");
+
+public:
+    seqlock() noexcept
+        : sequence_{0}
+        , data_{}
+    {
+        store(T{});
+    }
+
+    ~seqlock() = default;
+
+    seqlock(seqlock &&) noexcept = delete;
+    auto operator=(seqlock &&) noexcept -> seqlock & = delete;
+
+    seqlock(const seqlock &) noexcept = delete;
+    auto operator=(const seqlock &) noexcept -> seqlock & = delete;
+
+    /*!
+     * Writer side. Must always be called from the same thread.
+     */
+    void store(const T &value) noexcept
+    {
+        std::array<std::uint64_t, word_count> words{};
+        std::memcpy(std::data(words), &value, sizeof(T));
+
+        const auto sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (auto i = 0u; i < word_count; ++i)
+            data_[i].store(words[i], std::memory_order_relaxed);
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /*!
+     * Reader side. Safe to call from any thread.
+     */
+    auto load() const noexcept -> T
+    {
+        std::array<std::uint64_t, word_count> words{};
+
+        while (true)
+        {
+            const auto before = sequence_.load(std::memory_order_acquire);
+
+            if (before & 1)
+                continue;
+
+            for (auto i = 0u; i < word_count; ++i)
+                words[i] = data_[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence_.load(std::memory_order_relaxed) == before)
+                break;
+        }
+
+        T value;
+        std::memcpy(static_cast<void *>(&value), std::data(words), sizeof(T));
+        return value;
+    }
+
+    /*!
+     * Increases by 2 for every store. Readers can compare it to skip work when nothing changed.
+     */
+    auto version() const noexcept
+    {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr auto word_count = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint32_t> sequence_;
+    std::array<std::atomic<std::uint64_t>, word_count> data_;
+};
+
+} // namespace emu6502
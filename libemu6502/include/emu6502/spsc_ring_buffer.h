@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace emu6502
+{
+
+/*!
+ * Lock-free ring buffer for exactly one producer thread and one consumer thread.
+ *
+ * The capacity is rounded up to a power of two. The read and write indices live on separate
+ * cache lines, and each side caches the other side's index so that the shared atomics are only
+ * touched when the cached value says the buffer is full (producer) or empty (consumer).
+ */
+template <typename T>
+class spsc_ring_buffer
+{
+public:
+    explicit spsc_ring_buffer(const std::size_t capacity)
+        : buffer_(round_up_to_power_of_two(capacity))
+        , mask_{std::size(buffer_) - 1}
+    {
+    }
+
+    ~spsc_ring_buffer() = default;
+
+    spsc_ring_buffer(spsc_ring_buffer &&) noexcept = delete;
+    auto operator=(spsc_ring_buffer &&) noexcept -> spsc_ring_buffer & = delete;
+
+    spsc_ring_buffer(const spsc_ring_buffer &) noexcept = delete;
+    auto operator=(const spsc_ring_buffer &) noexcept -> spsc_ring_buffer & = delete;
+
+    /*!
+     * Producer side. Returns false if the buffer is full.
+     */
+    auto push(const T &value) noexcept -> bool
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+
+        if (head - cached_tail_ == std::size(buffer_))
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+
+            if (head - cached_tail_ == std::size(buffer_))
+                return false;
+        }
+
+        buffer_[head & mask_] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+     * Producer side. Copies as many elements as fit and returns the amount written.
+     */
+    auto write(const T *data, const std::size_t count) noexcept -> std::size_t
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        auto free = std::size(buffer_) - (head - cached_tail_);
+
+        if (free < count)
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            free = std::size(buffer_) - (head - cached_tail_);
+        }
+
+        const auto n = std::min(free, count);
+        copy_in(head, data, n);
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /*!
+     * Consumer side. Returns false if the buffer is empty.
+     */
+    auto pop(T &value) noexcept -> bool
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+
+        if (cached_head_ == tail)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+
+            if (cached_head_ == tail)
+                return false;
+        }
+
+        value = buffer_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*!
+     * Consumer side. Copies up to count elements and returns the amount read.
+     */
+    auto read(T *data, const std::size_t count) noexcept -> std::size_t
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        auto available = cached_head_ - tail;
+
+        if (available < count)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            available = cached_head_ - tail;
+        }
+
+        const auto n = std::min(available, count);
+        copy_out(tail, data, n);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /*!
+     * Consumer side. Returns true if there is nothing to read.
+     */
+    auto empty() const noexcept
+    {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * Approximate number of queued elements. Exact when called from either side while the
+     * other side is idle.
+     */
+    auto size() const noexcept
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    auto capacity() const noexcept
+    {
+        return std::size(buffer_);
+    }
+
+    /*!
+     * Discard all queued elements. Only safe while neither side is accessing the buffer.
+     */
+    void clear() noexcept
+    {
+        const auto head = head_.load(std::memory_order_acquire);
+        tail_.store(head, std::memory_order_release);
+        cached_head_ = head;
+        cached_tail_ = head;
+    }
+
+private:
+    static constexpr std::size_t cache_line_size = 64;
+
+    static auto round_up_to_power_of_two(const std::size_t value) noexcept -> std::size_t
+    {
+        std::size_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    void copy_in(const std::size_t head, const T *data, const std::size_t count) noexcept
+    {
+        const auto offset = head & mask_;
+        const auto first = std::min(count, std::size(buffer_) - offset);
+        std::copy_n(data, first, std::data(buffer_) + offset);
+        std::copy_n(data + first, count - first, std::data(buffer_));
+    }
+
+    void copy_out(const std::size_t tail, T *data, const std::size_t count) const noexcept
+    {
+        const auto offset = tail & mask_;
+        const auto first = std::min(count, std::size(buffer_) - offset);
+        std::copy_n(std::data(buffer_) + offset, first, data);
+        std::copy_n(std::data(buffer_), count - first, data + first);
+    }
+
+    std::vector<T> buffer_;
+    std::size_t mask_;
+
+    // Written by the producer.
+    alignas(cache_line_size) std::atomic<std::size_t> head_{};
+    std::size_t cached_tail_{};
+
+    // Written by the consumer.
+    alignas(cache_line_size) std::atomic<std::size_t> tail_{};
+    std::size_t cached_head_{};
+};
+
+} // namespace emu6502
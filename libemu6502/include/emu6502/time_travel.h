@@ -0,0 +1,221 @@
+#pragma once
+
+#include <emu6502/ibus_device.h>
+#include <emu6502/machine_state.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace emu6502
+{
+
+class cpu_mos6502;
+class input_recorder;
+
+struct time_travel_settings
+{
+    // Upper bound for the memory used by checkpoints. The oldest checkpoints are dropped to stay below it,
+    // which limits how far back in time one can go.
+    std::size_t memory_budget{64 * 1024 * 1024};
+
+    // Number of memory writes kept in the journal, rounded up to a power of two.
+    std::size_t journal_capacity{1024 * 1024};
+
+    // Fraction of the forward execution time that may be spent on taking checkpoints. The checkpoint
+    // interval is adjusted continuously to stay below it.
+    double max_overhead{0.05};
+
+    // Checkpoint interval in instructions. The interval starts at the minimum and grows as needed.
+    std::uint64_t min_checkpoint_interval{10000};
+    std::uint64_t max_checkpoint_interval{10000000};
+
+    // Every n-th checkpoint holds the complete machine; the ones in between only hold the 256 byte pages
+    // of the machine state that changed since the checkpoint before them.
+    std::uint32_t keyframe_interval{16};
+};
+
+/*!
+ * One memory write in the journal; position is the index of the instruction that did the write.
+ */
+struct time_travel_write
+{
+    std::uint64_t position;
+    std::uint16_t address;
+    std::uint8_t value;
+};
+
+/*!
+ * Reverse execution for a cpu and the devices on its bus.
+ *
+ * While running forward the machine state is saved every few thousand instructions. Going back in time
+ * restores the nearest checkpoint before the requested position and executes forward from there; the
+ * machine is deterministic, so this ends up in exactly the state it had the first time. Every write on
+ * the bus is also recorded in a journal, which is used to find the last write to an address.
+ *
+ * Positions count the instructions executed through this class. The cpu must only be stepped through
+ * step() while the object exists, and devices must not be added to the bus. Input that enters the
+ * machine from the host, like serial data, is not part of the checkpoints. Watch the input recorder of
+ * the devices with set_input_recorder() to make seek() refuse to replay across such input; without it,
+ * going back past such input replays without it.
+ */
+class time_travel final
+{
+public:
+    explicit time_travel(cpu_mos6502 &cpu, const time_travel_settings &settings = {});
+    ~time_travel();
+
+    time_travel(time_travel &&) noexcept = delete;
+    auto operator=(time_travel &&) noexcept -> time_travel & = delete;
+
+    time_travel(const time_travel &) noexcept = delete;
+    auto operator=(const time_travel &) noexcept -> time_travel & = delete;
+
+    /*!
+     * Execute n instructions forward, taking checkpoints and journaling writes on the way. Stops early
+     * on an illegal opcode. Returns the number of instructions executed.
+     */
+    auto step(const std::uint64_t n = 1) -> std::uint64_t;
+
+    /*!
+     * Go back n instructions. Returns false, without changing anything, if that is before the oldest
+     * checkpoint.
+     */
+    auto step_back(const std::uint64_t n = 1) -> bool;
+
+    /*!
+     * Go back to an absolute position between oldest_position() and position(). Everything recorded after
+     * the target is discarded; running forward again records it anew. Returns false, without changing
+     * anything, if host input was delivered between the checkpoint before the target and the target.
+     */
+    auto seek(const std::uint64_t target) -> bool;
+
+    /*!
+     * Go back to the state right after the most recent write to the given address, not counting a write
+     * by the instruction that was just executed, so repeated calls walk back through the writes. Returns
+     * false if the journal has no such write, or if it lies before the oldest checkpoint.
+     */
+    auto run_back_to_last_write(const std::uint16_t address) -> bool;
+
+    /*!
+     * The most recent write to an address before the current position, if it is still in the journal.
+     */
+    auto find_last_write(const std::uint16_t address) const noexcept -> std::optional<time_travel_write>;
+
+    /*!
+     * Watch the recorder the devices log host input to; the instructions during which it recorded an
+     * event can not be replayed. Pass nullptr to stop watching. Input dropped by a failed recorder is
+     * not noticed.
+     */
+    void set_input_recorder(const input_recorder *recorder) noexcept;
+
+    auto position() const noexcept
+    {
+        return position_;
+    }
+
+    auto oldest_position() const noexcept
+    {
+        return std::empty(checkpoints_) ? position_ : checkpoints_.front().position;
+    }
+
+    auto checkpoint_interval() const noexcept
+    {
+        return checkpoint_interval_;
+    }
+
+    auto checkpoint_count() const noexcept
+    {
+        return std::size(checkpoints_);
+    }
+
+    /*!
+     * Bytes used by all checkpoints, not counting the journal.
+     */
+    auto memory_usage() const noexcept
+    {
+        return memory_usage_;
+    }
+
+private:
+    class write_journal final : public ibus_device
+    {
+    public:
+        explicit write_journal(time_travel &owner);
+        ~write_journal() = default;
+
+        write_journal(write_journal &&) noexcept = delete;
+        auto operator=(write_journal &&) noexcept -> write_journal & = delete;
+
+        write_journal(const write_journal &) noexcept = delete;
+        auto operator=(const write_journal &) noexcept -> write_journal & = delete;
+
+        void write(const std::uint16_t address, const std::uint8_t value) noexcept override;
+        auto read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t> override;
+
+        auto find_last(const std::uint16_t address, const std::uint64_t before) const noexcept
+            -> std::optional<time_travel_write>;
+        void truncate(const std::uint64_t position) noexcept;
+
+        bool recording_;
+
+    private:
+        time_travel &owner_;
+        std::vector<time_travel_write> entries_;
+        std::size_t mask_;
+        std::size_t head_;
+        std::size_t count_;
+    };
+
+    struct checkpoint
+    {
+        std::uint64_t position;
+        bool keyframe;
+
+        // The whole machine state for a keyframe; otherwise a list of changed pages, each stored as
+        // a 32-bit page index followed by the page data.
+        std::vector<std::uint8_t> data;
+    };
+
+    // Instructions, first and last inclusive, during which host input was delivered.
+    struct input_range
+    {
+        std::uint64_t first;
+        std::uint64_t last;
+    };
+
+    auto current_position() const noexcept -> std::uint64_t;
+    auto execute(const std::uint64_t n) -> std::uint64_t;
+    auto input_delivered(const std::uint64_t begin, const std::uint64_t end) const noexcept -> bool;
+
+    void take_checkpoint();
+    void restore_checkpoint(const std::size_t index);
+    void truncate(const std::uint64_t position);
+    void enforce_memory_budget() noexcept;
+    void tune_interval(const std::uint64_t instructions, const double checkpoint_seconds) noexcept;
+
+    cpu_mos6502 &cpu_;
+    time_travel_settings settings_;
+    write_journal journal_;
+
+    std::uint64_t position_;
+    std::uint32_t chunk_start_count_;
+
+    machine_state state_;
+    std::vector<std::uint8_t> previous_state_;
+    std::deque<checkpoint> checkpoints_;
+    std::uint32_t checkpoints_since_keyframe_;
+    std::size_t memory_usage_;
+
+    const input_recorder *input_recorder_;
+    std::vector<input_range> input_ranges_;
+
+    std::uint64_t checkpoint_interval_;
+    std::uint64_t next_checkpoint_;
+    double execute_seconds_;
+    double seconds_per_instruction_;
+    double seconds_per_checkpoint_;
+};
+
+} // namespace emu6502
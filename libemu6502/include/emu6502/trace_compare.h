@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace emu6502
+{
+
+class instruction_trace_reader;
+
+struct trace_compare_settings
+{
+    // Number of threads that compare chunks of the traces; 0 uses one per hardware thread.
+    std::size_t thread_count{0};
+
+    // Encoded blocks compared by a thread at a time, while both traces have the same block layout.
+    std::size_t chunk_blocks{16};
+
+    // Records decoded and compared by a thread at a time, where the block layouts differ.
+    std::size_t chunk_records{64 * 1024};
+};
+
+/*!
+ * Find the index of the first record in which two traces differ.
+ *
+ * Only the indices present in both traces are compared, so ring traces that lost different amounts
+ * of history can still be compared. If those records are equal but one trace continues past the end
+ * of the other, the first index beyond the shorter trace is returned. Returns nothing if the traces
+ * hold the same records.
+ *
+ * As long as both traces consist of blocks of the same layout, the encoded bytes are compared
+ * directly, so identical runs are never decoded. The differing block, and any part of the traces
+ * where the blocks don't line up, is decoded and compared record by record. Both steps split the
+ * work into chunks that are compared in parallel.
+ */
+auto find_trace_divergence(const instruction_trace_reader &a, const instruction_trace_reader &b,
+                           const trace_compare_settings &settings = {}) -> std::optional<std::uint64_t>;
+
+} // namespace emu6502
@@ -2,6 +2,7 @@
 
 #include <emu6502/ibus_device.h>
 #include <emu6502/ic_register.h>
+#include <array>
 
 namespace emu6502
 {
@@ -38,7 +39,14 @@ public:
     via_6522(const via_6522 &) noexcept = delete;
     auto operator=(const via_6522 &) noexcept -> via_6522 & = delete;
 
+    auto state_size() const noexcept -> std::size_t override;
+    void save_state(std::uint8_t *data) const noexcept override;
+    void load_state(const std::uint8_t *data) noexcept override;
+
 private:
+    template <typename via_t>
+    static auto registers(via_t &via) noexcept;
+
     void write(const std::uint16_t address, const std::uint8_t value) noexcept override;
     auto read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t> override;
 
@@ -1,5 +1,10 @@
 #include <emu6502/acia_6551.h>
+#include <emu6502/bus.h>
+#include <emu6502/input_log.h>
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
 #include <utility>
 
 namespace emu6502
@@ -15,13 +20,49 @@ static constexpr std::uint8_t status_interrupt_bit = 0x80;
 static constexpr std::uint8_t control_receiver_clock_source_bit = 0x10;
 static constexpr std::uint8_t control_stop_bit_number_bit = 0x80;
 
+static constexpr std::uint8_t command_parity_mode_enabled_bit = 0x20;
+
+static constexpr std::uint64_t no_clock_event = std::numeric_limits<std::uint64_t>::max();
+
+struct acia_6551_state
+{
+    std::uint64_t next_receive_cycle;
+    std::uint64_t transmit_done_cycle;
+    std::uint64_t scheduled_cycle;
+    std::uint8_t send_recv_data;
+    std::uint8_t status;
+    std::uint8_t command;
+    std::uint8_t control;
+    bool receive_clock_active;
+    bool transmit_shifting;
+    std::uint8_t transmit_shift_register;
+    bool transmit_data_full;
+    std::uint8_t transmit_data;
+};
+
 acia_6551::acia_6551(const acia_6551_settings settings) noexcept
     : send_recv_data_register_{settings.send_recv_address}
     , status_register_{settings.status_reg_address}
     , command_register_{settings.command_reg_address}
     , control_register_{settings.control_reg_address}
     , simulate_wdc_bugs_{settings.simulate_wdc_bugs}
-    , receive_func_{settings.receive_func}
+    , transmit_notify_func_{settings.transmit_notify_func}
+    , transmit_notify_pending_{false}
+    , receive_fifo_{settings.fifo_capacity}
+    , transmit_fifo_{settings.fifo_capacity}
+    , timing_mode_{settings.timing_mode}
+    , bus_{nullptr}
+    , input_recorder_{nullptr}
+    , input_player_{nullptr}
+    , input_source_{}
+    , receive_clock_active_{false}
+    , next_receive_cycle_{}
+    , transmit_shifting_{false}
+    , transmit_shift_register_{}
+    , transmit_done_cycle_{}
+    , transmit_data_full_{false}
+    , transmit_data_{}
+    , scheduled_cycle_{no_clock_event}
 {
     hard_reset();
 }
@@ -41,10 +82,66 @@ void acia_6551::recv_data(const std::uint8_t data, const recv_data_error error)
     send_recv_data_register_ = data;
 }
 
+auto acia_6551::host_write(const std::uint8_t *data, const std::size_t size) noexcept -> std::size_t
+{
+    return receive_fifo_.write(data, size);
+}
+
+auto acia_6551::host_read(std::uint8_t *data, const std::size_t size) noexcept -> std::size_t
+{
+    // Clear the pending flag before draining, so a byte queued after the drain always notifies again.
+    transmit_notify_pending_.store(false);
+    return transmit_fifo_.read(data, size);
+}
+
+void acia_6551::set_transmit_notify_func(acia_6551_transmit_notify_func func)
+{
+    transmit_notify_func_ = std::move(func);
+}
+
+void acia_6551::clear_fifos() noexcept
+{
+    receive_fifo_.clear();
+    transmit_fifo_.clear();
+    transmit_notify_pending_.store(false);
+}
+
+void acia_6551::poll_receiver() noexcept
+{
+    if (status_register_.check_bit_flags(status_receiver_data_register_full_bit))
+        return;
+
+    std::uint8_t data = 0;
+    if (next_received_byte(data))
+        recv_data(data);
+}
+
+void acia_6551::set_input_recorder(input_recorder *recorder, const std::uint8_t source) noexcept
+{
+    input_recorder_ = recorder;
+    input_source_ = source;
+}
+
+void acia_6551::set_input_player(input_player *player, const std::uint8_t source) noexcept
+{
+    input_player_ = player;
+    input_source_ = source;
+}
+
+void acia_6551::set_timing_mode(const acia_6551_timing_mode mode) noexcept
+{
+    timing_mode_.store(mode, std::memory_order_relaxed);
+}
+
+auto acia_6551::timing_mode() const noexcept -> acia_6551_timing_mode
+{
+    return timing_mode_.load(std::memory_order_relaxed);
+}
+
 auto acia_6551::baud_rate() const noexcept -> float
 {
     // If an external clock source is used, the baud rate is not known.
-    if (aeon::common::check_bit_flag(control_register_.get(), control_receiver_clock_source_bit))
+    if (receiver_clock_source() == clock_source::external_receiver_clock)
         return 0;
 
     const auto baud_index = control_register_.get_low_nibble();
@@ -112,33 +209,105 @@ auto acia_6551::word_length() const noexcept -> int
 
 auto acia_6551::stop_bits() const noexcept -> stop_bit_count
 {
-    if (control_register_.check_bit_flags(control_stop_bit_number_bit))
+    if (!control_register_.check_bit_flags(control_stop_bit_number_bit))
         return stop_bit_count::one;
-    else
-    {
-        if (word_length() == 5)
-            return stop_bit_count::one_and_a_half;
 
-        return stop_bit_count::two;
-    }
+    if (word_length() == 5 && !command_register_.check_bit_flags(command_parity_mode_enabled_bit))
+        return stop_bit_count::one_and_a_half;
+
+    if (word_length() == 8 && command_register_.check_bit_flags(command_parity_mode_enabled_bit))
+        return stop_bit_count::one;
+
+    return stop_bit_count::two;
 }
 
 auto acia_6551::receiver_clock_source() const noexcept -> clock_source
 {
     if (control_register_.check_bit_flags(control_receiver_clock_source_bit))
-        return clock_source::external_receiver_clock;
+        return clock_source::baud_rate;
+
+    return clock_source::external_receiver_clock;
+}
+
+auto acia_6551::frame_cycles() const noexcept -> std::uint64_t
+{
+    const auto baud = baud_rate();
+
+    // Index 0 selects the external 16x clock, so the actual rate is unknown.
+    if (!bus_ || baud <= 16.0f)
+        return 0;
+
+    // Counted in half bits to account for 1.5 stop bits.
+    auto half_bits = 2 * (1 + word_length());
+
+    if (command_register_.check_bit_flags(command_parity_mode_enabled_bit))
+        half_bits += 2;
+
+    switch (stop_bits())
+    {
+        case stop_bit_count::one:
+            half_bits += 2;
+            break;
+        case stop_bit_count::one_and_a_half:
+            half_bits += 3;
+            break;
+        case stop_bit_count::two:
+            half_bits += 4;
+            break;
+    }
+
+    const auto cycles = static_cast<double>(bus_->clock_frequency()) * half_bits / (2.0 * baud);
+    return std::max(static_cast<std::uint64_t>(cycles), std::uint64_t{1});
+}
+
+auto acia_6551::state_size() const noexcept -> std::size_t
+{
+    return sizeof(acia_6551_state);
+}
+
+void acia_6551::save_state(std::uint8_t *data) const noexcept
+{
+    acia_6551_state state{};
+    state.next_receive_cycle = next_receive_cycle_;
+    state.transmit_done_cycle = transmit_done_cycle_;
+    state.scheduled_cycle = scheduled_cycle_;
+    state.send_recv_data = send_recv_data_register_.get();
+    state.status = status_register_.get();
+    state.command = command_register_.get();
+    state.control = control_register_.get();
+    state.receive_clock_active = receive_clock_active_;
+    state.transmit_shifting = transmit_shifting_;
+    state.transmit_shift_register = transmit_shift_register_;
+    state.transmit_data_full = transmit_data_full_;
+    state.transmit_data = transmit_data_;
+    std::memcpy(data, &state, sizeof(state));
+}
 
-    return clock_source::baud_rate;
+void acia_6551::load_state(const std::uint8_t *data) noexcept
+{
+    // The bus restores its own event schedule, so scheduled_cycle_ is taken over as-is.
+    acia_6551_state state;
+    std::memcpy(&state, data, sizeof(state));
+    next_receive_cycle_ = state.next_receive_cycle;
+    transmit_done_cycle_ = state.transmit_done_cycle;
+    scheduled_cycle_ = state.scheduled_cycle;
+    send_recv_data_register_ = state.send_recv_data;
+    status_register_ = state.status;
+    command_register_ = state.command;
+    control_register_ = state.control;
+    receive_clock_active_ = state.receive_clock_active;
+    transmit_shifting_ = state.transmit_shifting;
+    transmit_shift_register_ = state.transmit_shift_register;
+    transmit_data_full_ = state.transmit_data_full;
+    transmit_data_ = state.transmit_data;
 }
 
 void acia_6551::hard_reset() noexcept
 {
-    status_register_ = 0;
+    // The transmit data register is empty after reset; the WDC part simply never clears the flag.
+    status_register_ = status_transmitter_data_empty_bit;
     control_register_ = 0;
     command_register_ = 0;
-
-    if (simulate_wdc_bugs_)
-        status_register_.set_bit_flags(status_transmitter_data_empty_bit);
 }
 
 void acia_6551::soft_reset() noexcept
@@ -150,16 +319,121 @@ void acia_6551::soft_reset() noexcept
         status_register_.set_bit_flags(status_transmitter_data_empty_bit);
 }
 
-void acia_6551::send_data(const std::uint8_t data) noexcept
+auto acia_6551::next_received_byte(std::uint8_t &data) noexcept -> bool
 {
-    receive_func_(data);
+    // Data from the host is the only input of the ACIA that is not deterministic, so this is where it
+    // is recorded and replayed.
+    const auto cycle = bus_ ? bus_->cycle() : 0;
 
-    if (simulate_wdc_bugs_)
+    if (input_player_)
+        return input_player_->take(input_event_type::acia_receive, input_source_, cycle, data);
+
+    if (!receive_fifo_.pop(data))
+        return false;
+
+    if (input_recorder_)
+        input_recorder_->record({cycle, input_event_type::acia_receive, input_source_, data});
+
+    return true;
+}
+
+void acia_6551::send_data(const std::uint8_t data) noexcept
+{
+    if (!is_accurate_timing())
+    {
+        flush_transmitter();
+        queue_transmit(data);
         status_register_.set_bit_flags(status_transmitter_data_empty_bit);
-    else
+        return;
+    }
+
+    if (!transmit_shifting_)
+    {
+        start_transmit(data);
+        update_clock_event();
+        return;
+    }
+
+    // Writing a full data register overwrites the byte that was waiting, like on the real chip.
+    transmit_data_ = data;
+    transmit_data_full_ = true;
+
+    if (!simulate_wdc_bugs_)
         status_register_.clear_bit_flags(status_transmitter_data_empty_bit);
 }
 
+void acia_6551::start_transmit(const std::uint8_t data) noexcept
+{
+    assert(bus_);
+    transmit_shifting_ = true;
+    transmit_shift_register_ = data;
+    transmit_done_cycle_ = bus_->cycle() + frame_cycles();
+    status_register_.set_bit_flags(status_transmitter_data_empty_bit);
+}
+
+void acia_6551::queue_transmit(const std::uint8_t data) noexcept
+{
+    // If the host stops draining, the FIFO fills up and further bytes are lost like on a real line.
+    transmit_fifo_.push(data);
+
+    if (!transmit_notify_pending_.exchange(true) && transmit_notify_func_)
+        transmit_notify_func_();
+}
+
+void acia_6551::flush_transmitter() noexcept
+{
+    if (transmit_shifting_)
+        queue_transmit(transmit_shift_register_);
+
+    if (transmit_data_full_)
+        queue_transmit(transmit_data_);
+
+    transmit_shifting_ = false;
+    transmit_data_full_ = false;
+}
+
+auto acia_6551::is_accurate_timing() const noexcept -> bool
+{
+    return timing_mode() == acia_6551_timing_mode::accurate && frame_cycles() != 0;
+}
+
+void acia_6551::update_clock_event() noexcept
+{
+    if (!bus_)
+        return;
+
+    auto next_cycle = no_clock_event;
+
+    if (is_accurate_timing())
+    {
+        if (!receive_clock_active_)
+        {
+            next_receive_cycle_ = bus_->cycle() + frame_cycles();
+            receive_clock_active_ = true;
+        }
+
+        next_cycle = next_receive_cycle_;
+
+        if (transmit_shifting_)
+            next_cycle = std::min(next_cycle, transmit_done_cycle_);
+    }
+    else
+    {
+        receive_clock_active_ = false;
+        flush_transmitter();
+    }
+
+    if (next_cycle == scheduled_cycle_)
+        return;
+
+    scheduled_cycle_ = next_cycle;
+
+    if (next_cycle == no_clock_event)
+        bus_->cancel(*this);
+    else
+        bus_->schedule(*this, next_cycle);
+}
+
 void acia_6551::write(const std::uint16_t address, const std::uint8_t value) noexcept
 {
     if (address == send_recv_data_register_.address())
@@ -178,6 +452,8 @@ void acia_6551::write(const std::uint16_t address, const std::uint8_t value) noe
     {
         control_register_ = value;
     }
+
+    update_clock_event();
 }
 
 auto acia_6551::read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t>
@@ -185,11 +461,23 @@ auto acia_6551::read(const std::uint16_t address) noexcept -> std::tuple<bool, s
     if (address == send_recv_data_register_.address())
     {
         // On read, all error flags are cleared, and the buffer is empty.
+        const auto value = send_recv_data_register_.get();
         status_register_.mask_bit_flags(0xF0);
-        return {true, send_recv_data_register_.get()};
+
+        if (is_accurate_timing())
+            update_clock_event();
+        else
+            poll_receiver();
+
+        return {true, value};
     }
     else if (address == status_register_.address())
     {
+        if (is_accurate_timing())
+            update_clock_event();
+        else
+            poll_receiver();
+
         const auto value = status_register_.get();
         status_register_.clear_bit_flags(status_interrupt_bit);
         return {true, value};
@@ -206,4 +494,62 @@ auto acia_6551::read(const std::uint16_t address) noexcept -> std::tuple<bool, s
     return {false, static_cast<std::uint8_t>(0)};
 }
 
+auto acia_6551::peek(const std::uint16_t address) const noexcept -> std::tuple<bool, std::uint8_t>
+{
+    if (address == send_recv_data_register_.address())
+        return {true, send_recv_data_register_.get()};
+
+    if (address == status_register_.address())
+        return {true, status_register_.get()};
+
+    if (address == command_register_.address())
+        return {true, command_register_.get()};
+
+    if (address == control_register_.address())
+        return {true, control_register_.get()};
+
+    return {false, static_cast<std::uint8_t>(0)};
+}
+
+void acia_6551::on_attached(bus &bus) noexcept
+{
+    bus_ = &bus;
+}
+
+void acia_6551::on_clock_event(const std::uint64_t cycle) noexcept
+{
+    scheduled_cycle_ = no_clock_event;
+
+    if (!is_accurate_timing())
+    {
+        update_clock_event();
+        return;
+    }
+
+    if (transmit_shifting_ && cycle >= transmit_done_cycle_)
+    {
+        queue_transmit(transmit_shift_register_);
+        transmit_shifting_ = false;
+
+        if (transmit_data_full_)
+        {
+            transmit_data_full_ = false;
+            start_transmit(transmit_data_);
+        }
+    }
+
+    // The line is sampled once per frame. A byte that arrives while the previous one was not read yet
+    // causes an overrun, like on the real chip.
+    if (receive_clock_active_ && cycle >= next_receive_cycle_)
+    {
+        std::uint8_t data = 0;
+        if (next_received_byte(data))
+            recv_data(data);
+
+        next_receive_cycle_ = cycle + frame_cycles();
+    }
+
+    update_clock_event();
+}
+
 } // namespace emu6502
@@ -1,5 +1,7 @@
 #include <emu6502/bus.h>
 #include <emu6502/ibus_device.h>
+#include <emu6502/access_counters.h>
+#include <algorithm>
 #include <cassert>
 
 namespace emu6502
@@ -8,15 +10,24 @@ namespace emu6502
 bus::bus(std::vector<ibus_device *> devices)
     : devices_{std::move(devices)}
 {
+    for (auto device : devices_)
+        device->on_attached(*this);
 }
 
 bus::bus(std::vector<ibus_device *> &&devices)
     : devices_{std::move(devices)}
 {
+    for (auto device : devices_)
+        device->on_attached(*this);
 }
 
 void bus::write(const std::uint16_t address, const std::uint8_t value) noexcept
 {
+    written_pages_[address >> 14] |= std::uint64_t{1} << (address >> 8 & 63);
+
+    if (access_counters_)
+        access_counters_->count(access_type::write, address);
+
     for (auto device : devices_)
     {
         device->write(address, value);
@@ -24,6 +35,22 @@ void bus::write(const std::uint16_t address, const std::uint8_t value) noexcept
 }
 
 auto bus::read(const std::uint16_t address) noexcept -> std::uint8_t
+{
+    if (access_counters_)
+        access_counters_->count(access_type::read, address);
+
+    return read_devices(address);
+}
+
+auto bus::fetch(const std::uint16_t address) noexcept -> std::uint8_t
+{
+    if (access_counters_)
+        access_counters_->count(access_type::fetch, address);
+
+    return read_devices(address);
+}
+
+auto bus::read_devices(const std::uint16_t address) noexcept -> std::uint8_t
 {
     for (auto device : devices_)
     {
@@ -36,9 +63,68 @@ auto bus::read(const std::uint16_t address) noexcept -> std::uint8_t
     return 0;
 }
 
+auto bus::peek(const std::uint16_t address) const noexcept -> std::uint8_t
+{
+    for (const auto device : devices_)
+    {
+        auto [valid, value] = device->peek(address);
+
+        if (valid)
+            return value;
+    }
+
+    return 0;
+}
+
+auto bus::take_written_pages() noexcept -> std::array<std::uint64_t, 4>
+{
+    const auto pages = written_pages_;
+    written_pages_.fill(0);
+    return pages;
+}
+
+void bus::set_access_counters(access_counters *counters) noexcept
+{
+    access_counters_ = counters;
+}
+
 void bus::add(ibus_device &device)
 {
     devices_.emplace_back(&device);
+    device.on_attached(*this);
+}
+
+void bus::remove(ibus_device &device) noexcept
+{
+    cancel(device);
+    devices_.erase(std::remove(std::begin(devices_), std::end(devices_), &device), std::end(devices_));
+}
+
+void bus::set_clock_frequency(const std::uint32_t frequency) noexcept
+{
+    assert(frequency != 0);
+    clock_frequency_ = frequency;
+}
+
+void bus::schedule(ibus_device &device, const std::uint64_t cycle)
+{
+    const auto result = std::find_if(std::begin(clock_events_), std::end(clock_events_),
+                                     [&device](const auto &event) { return event.device == &device; });
+
+    if (result != std::end(clock_events_))
+        result->cycle = cycle;
+    else
+        clock_events_.push_back({cycle, &device});
+
+    update_next_event_cycle();
+}
+
+void bus::cancel(ibus_device &device) noexcept
+{
+    clock_events_.erase(std::remove_if(std::begin(clock_events_), std::end(clock_events_),
+                                       [&device](const auto &event) { return event.device == &device; }),
+                        std::end(clock_events_));
+    update_next_event_cycle();
 }
 
 void bus::set_cpu_bus_interface(ibus_interface *bus_interface) noexcept
@@ -53,4 +139,27 @@ void bus::on_irq() noexcept
     cpu_->on_irq();
 }
 
+void bus::run_clock_events() noexcept
+{
+    // The event is removed before its callback runs, so the device is free to schedule a new one.
+    while (cycle_ >= next_event_cycle_)
+    {
+        const auto result = std::min_element(std::begin(clock_events_), std::end(clock_events_),
+                                             [](const auto &lhs, const auto &rhs) { return lhs.cycle < rhs.cycle; });
+        const auto event = *result;
+        clock_events_.erase(result);
+        update_next_event_cycle();
+
+        event.device->on_clock_event(event.cycle);
+    }
+}
+
+void bus::update_next_event_cycle() noexcept
+{
+    next_event_cycle_ = std::numeric_limits<std::uint64_t>::max();
+
+    for (const auto &event : clock_events_)
+        next_event_cycle_ = std::min(next_event_cycle_, event.cycle);
+}
+
 } // namespace emu6502
@@ -1,8 +1,12 @@
 #include <emu6502/cpu_mos6502.h>
 #include <emu6502/bus.h>
 #include <emu6502/icpu_debug_interface.h>
+#include <emu6502/instruction_trace.h>
 #include <status_registers.h>
+#include <opcode_addressing.h>
+#include <opcode_cycles.h>
 #include <functional>
+#include <cassert>
 
 namespace emu6502
 {
@@ -15,6 +19,8 @@ static constexpr std::uint16_t rst_vector_l = 0xFFFC;
 static constexpr std::uint16_t nmi_vector_h = 0xFFFB;
 static constexpr std::uint16_t nmi_vector_l = 0xFFFA;
 
+static constexpr std::uint32_t interrupt_cycles = 7;
+
 cpu_mos6502::cpu_mos6502(bus &bus, icpu_debug_interface *debug_interface)
     : instruction_{}
     , bus_{bus}
@@ -38,6 +44,10 @@ void cpu_mos6502::trigger_nmi() noexcept
     stack_push(register_status_);
     status::set_interrupt(register_status_, 1);
     register_pc_ = (bus_read(nmi_vector_h) << 8) + bus_read(nmi_vector_l);
+    bus_.tick(interrupt_cycles);
+
+    if (coverage_.edge_map)
+        record_edge();
 }
 
 void cpu_mos6502::trigger_irq() noexcept
@@ -53,6 +63,10 @@ void cpu_mos6502::trigger_irq() noexcept
         stack_push(register_status_);
         status::set_interrupt(register_status_, 1);
         register_pc_ = (bus_read(irq_vector_h) << 8) + bus_read(irq_vector_l);
+        bus_.tick(interrupt_cycles);
+
+        if (coverage_.edge_map)
+            record_edge();
     }
 }
 
@@ -92,21 +106,75 @@ void cpu_mos6502::stop() noexcept
 }
 
 void cpu_mos6502::step(const std::uint32_t n) noexcept
+{
+    // Decided once per call, so the instruction loop itself has no coverage or trace check.
+    if (trace_writer_)
+    {
+        if (coverage_.executed_map)
+            step_instructions<true, true>(n);
+        else
+            step_instructions<false, true>(n);
+    }
+    else
+    {
+        if (coverage_.executed_map)
+            step_instructions<true, false>(n);
+        else
+            step_instructions<false, false>(n);
+    }
+}
+
+template <bool record_executed, bool trace>
+void cpu_mos6502::step_instructions(const std::uint32_t n) noexcept
 {
     const auto start = num_executed_instructions_;
 
     while (start + n > num_executed_instructions_ && !illegal_opcode_)
     {
+        if constexpr (record_executed)
+            coverage_.executed_map[register_pc_ >> 3] |= static_cast<std::uint8_t>(1 << (register_pc_ & 7));
+
+        [[maybe_unused]] trace_record record;
+        if constexpr (trace)
+        {
+            record.cycle = bus_.cycle();
+            record.pc = register_pc_;
+            record.a = register_a_;
+            record.x = register_x_;
+            record.y = register_y_;
+            record.sp = register_sp_;
+            record.status = register_status_;
+        }
+
         // fetch
-        const auto opcode = bus_read(register_pc_++);
+        const auto opcode = bus_fetch(register_pc_++);
 
         // decode
         const auto instr = instruction_[opcode];
 
+        if constexpr (trace)
+        {
+            // Peeked before executing, so self-modifying code shows the bytes that actually ran.
+            const auto length = opcode_addressing::lengths[opcode];
+            record.opcode = opcode;
+
+            if (length > 1)
+                record.operand[0] = bus_.peek(register_pc_);
+            if (length > 2)
+                record.operand[1] = bus_.peek(static_cast<std::uint16_t>(register_pc_ + 1));
+        }
+
         // execute
-        exec(instr);
+        const auto effective_address = exec(instr);
 
         num_executed_instructions_++;
+        bus_.tick(opcode_cycles[opcode]);
+
+        if constexpr (trace)
+        {
+            record.effective_address = effective_address;
+            trace_writer_->append(record);
+        }
 
         if (debug_interface_)
             debug_interface_->on_cpu_instruction_executed();
@@ -118,10 +186,105 @@ auto cpu_mos6502::is_illegal_opcode_set() const noexcept -> bool
     return illegal_opcode_;
 }
 
-void cpu_mos6502::exec(const instruction i) noexcept
+auto cpu_mos6502::state() const noexcept -> cpu_state
+{
+    cpu_state state;
+    state.a = register_a_;
+    state.x = register_x_;
+    state.y = register_y_;
+    state.sp = register_sp_;
+    state.pc = register_pc_;
+    state.status = register_status_;
+    state.num_executed_instructions = num_executed_instructions_;
+    state.cycle = bus_.cycle();
+    state.illegal_opcode = illegal_opcode_;
+    return state;
+}
+
+void cpu_mos6502::restore_state(const cpu_state &state) noexcept
+{
+    register_a_ = state.a;
+    register_x_ = state.x;
+    register_y_ = state.y;
+    register_sp_ = state.sp;
+    register_pc_ = state.pc;
+    register_status_ = state.status;
+    num_executed_instructions_ = state.num_executed_instructions;
+    illegal_opcode_ = state.illegal_opcode;
+}
+
+auto cpu_mos6502::exec(const instruction i) noexcept -> std::uint16_t
 {
     const auto src = std::invoke(i.addr, *this);
     std::invoke(i.code, *this, src);
+    return src;
+}
+
+void cpu_mos6502::set_coverage(const cpu_coverage &coverage) noexcept
+{
+    assert(!coverage.edge_map || (coverage.edge_map_size & (coverage.edge_map_size - 1)) == 0);
+
+    // Edge coverage swaps the control flow instructions for recording versions, so all other
+    // instructions run exactly as without coverage.
+    static constexpr std::array<std::pair<opcode_exec_func, opcode_exec_func>, 13> control_flow_ops{{
+        {&cpu_mos6502::op_bcc, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_bcc>},
+        {&cpu_mos6502::op_bcs, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_bcs>},
+        {&cpu_mos6502::op_beq, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_beq>},
+        {&cpu_mos6502::op_bmi, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_bmi>},
+        {&cpu_mos6502::op_bne, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_bne>},
+        {&cpu_mos6502::op_bpl, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_bpl>},
+        {&cpu_mos6502::op_bvc, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_bvc>},
+        {&cpu_mos6502::op_bvs, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_bvs>},
+        {&cpu_mos6502::op_brk, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_brk>},
+        {&cpu_mos6502::op_jmp, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_jmp>},
+        {&cpu_mos6502::op_jsr, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_jsr>},
+        {&cpu_mos6502::op_rti, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_rti>},
+        {&cpu_mos6502::op_rts, &cpu_mos6502::op_with_edge_coverage<&cpu_mos6502::op_rts>}}};
+
+    const auto edges_enabled = coverage.edge_map != nullptr;
+
+    for (auto &i : instruction_)
+    {
+        for (const auto &[plain, recording] : control_flow_ops)
+        {
+            if (edges_enabled && i.code == plain)
+                i.code = recording;
+            else if (!edges_enabled && i.code == recording)
+                i.code = plain;
+        }
+    }
+
+    coverage_ = coverage;
+    edge_map_mask_ = edges_enabled ? coverage.edge_map_size - 1 : 0;
+    previous_location_ = 0;
+}
+
+void cpu_mos6502::reset_coverage_context() noexcept
+{
+    previous_location_ = 0;
+}
+
+void cpu_mos6502::set_trace(instruction_trace_writer *writer) noexcept
+{
+    trace_writer_ = writer;
+}
+
+template <cpu_mos6502::opcode_exec_func op>
+void cpu_mos6502::op_with_edge_coverage(std::uint16_t src) noexcept
+{
+    const auto pc = register_pc_;
+    std::invoke(op, *this, src);
+
+    if (register_pc_ != pc)
+        record_edge();
+}
+
+void cpu_mos6502::record_edge() noexcept
+{
+    // Spread neighbouring addresses over the map; shifting the previous location keeps A->B and B->A apart.
+    const auto location = (register_pc_ * 0x9E3779B1u) >> 16;
+    ++coverage_.edge_map[(location ^ previous_location_) & edge_map_mask_];
+    previous_location_ = location >> 1;
 }
 
 void cpu_mos6502::stack_push(std::uint8_t byte) noexcept
@@ -160,6 +323,20 @@ auto cpu_mos6502::bus_read(const std::uint16_t address) const noexcept -> std::u
     return bus_.read(address);
 }
 
+auto cpu_mos6502::bus_fetch(const std::uint16_t address) const noexcept -> std::uint8_t
+{
+    return bus_.fetch(address);
+}
+
+template <bool immediate>
+auto cpu_mos6502::read_operand(const std::uint16_t src) const noexcept -> std::uint8_t
+{
+    if constexpr (immediate)
+        return bus_fetch(src);
+    else
+        return bus_read(src);
+}
+
 void cpu_mos6502::on_irq() noexcept
 {
     trigger_irq();
@@ -177,14 +354,14 @@ auto cpu_mos6502::addr_imm() noexcept -> std::uint16_t
 
 auto cpu_mos6502::addr_abs() noexcept -> std::uint16_t
 {
-    const std::uint16_t addr_l = bus_read(register_pc_++);
-    const std::uint16_t addr_h = bus_read(register_pc_++);
+    const std::uint16_t addr_l = bus_fetch(register_pc_++);
+    const std::uint16_t addr_h = bus_fetch(register_pc_++);
     return addr_l + (addr_h << 8);
 }
 
 auto cpu_mos6502::addr_zer() noexcept -> std::uint16_t
 {
-    return bus_read(register_pc_++);
+    return bus_fetch(register_pc_++);
 }
 
 auto cpu_mos6502::addr_imp() noexcept -> std::uint16_t
@@ -194,7 +371,7 @@ auto cpu_mos6502::addr_imp() noexcept -> std::uint16_t
 
 auto cpu_mos6502::addr_rel() noexcept -> std::uint16_t
 {
-    auto offset = static_cast<uint16_t>(bus_read(register_pc_++));
+    auto offset = static_cast<uint16_t>(bus_fetch(register_pc_++));
 
     if (offset & 0x80)
         offset |= 0xFF00;
@@ -204,8 +381,8 @@ auto cpu_mos6502::addr_rel() noexcept -> std::uint16_t
 
 auto cpu_mos6502::addr_abi() noexcept -> std::uint16_t
 {
-    const std::uint16_t addr_l = bus_read(register_pc_++);
-    const std::uint16_t addr_h = bus_read(register_pc_++);
+    const std::uint16_t addr_l = bus_fetch(register_pc_++);
+    const std::uint16_t addr_h = bus_fetch(register_pc_++);
 
     const std::uint16_t abs = (addr_h << 8) | addr_l;
 
@@ -217,45 +394,46 @@ auto cpu_mos6502::addr_abi() noexcept -> std::uint16_t
 
 auto cpu_mos6502::addr_zex() noexcept -> std::uint16_t
 {
-    return (bus_read(register_pc_++) + register_x_) % 256;
+    return (bus_fetch(register_pc_++) + register_x_) % 256;
 }
 
 auto cpu_mos6502::addr_zey() noexcept -> std::uint16_t
 {
-    return (bus_read(register_pc_++) + register_y_) % 256;
+    return (bus_fetch(register_pc_++) + register_y_) % 256;
 }
 
 auto cpu_mos6502::addr_abx() noexcept -> std::uint16_t
 {
-    const std::uint16_t addr_l = bus_read(register_pc_++);
-    const std::uint16_t addr_h = bus_read(register_pc_++);
+    const std::uint16_t addr_l = bus_fetch(register_pc_++);
+    const std::uint16_t addr_h = bus_fetch(register_pc_++);
     return addr_l + (addr_h << 8) + register_x_;
 }
 
 auto cpu_mos6502::addr_aby() noexcept -> std::uint16_t
 {
-    const std::uint16_t addr_l = bus_read(register_pc_++);
-    const std::uint16_t addr_h = bus_read(register_pc_++);
+    const std::uint16_t addr_l = bus_fetch(register_pc_++);
+    const std::uint16_t addr_h = bus_fetch(register_pc_++);
     return addr_l + (addr_h << 8) + register_y_;
 }
 
 auto cpu_mos6502::addr_inx() noexcept -> std::uint16_t
 {
-    const std::uint16_t zero_l = (bus_read(register_pc_++) + register_x_) % 256;
+    const std::uint16_t zero_l = (bus_fetch(register_pc_++) + register_x_) % 256;
     const std::uint16_t zero_h = (zero_l + 1) % 256;
     return bus_read(zero_l) + (bus_read(zero_h) << 8);
 }
 
 auto cpu_mos6502::addr_iny() noexcept -> std::uint16_t
 {
-    const std::uint16_t zero_l = bus_read(register_pc_++);
+    const std::uint16_t zero_l = bus_fetch(register_pc_++);
     const std::uint16_t zero_h = (zero_l + 1) % 256;
     return bus_read(zero_l) + (bus_read(zero_h) << 8) + register_y_;
 }
 
+template <bool immediate>
 void cpu_mos6502::op_adc(std::uint16_t src) noexcept
 {
-    const auto m = bus_read(src);
+    const auto m = read_operand<immediate>(src);
     unsigned int tmp = m + register_a_ + (status::is_carry_flag_set(register_status_) ? 1 : 0);
     status::set_zero(register_status_, !(tmp & 0xFF));
     if (status::is_decimal_flag_set(register_status_))
@@ -280,9 +458,10 @@ void cpu_mos6502::op_adc(std::uint16_t src) noexcept
     register_a_ = tmp & 0xFF;
 }
 
+template <bool immediate>
 void cpu_mos6502::op_and(std::uint16_t src) noexcept
 {
-    const auto m = bus_read(src);
+    const auto m = read_operand<immediate>(src);
     const std::uint8_t res = m & register_a_;
     status::set_negative(register_status_, res & 0x80);
     status::set_zero(register_status_, !res);
@@ -414,25 +593,28 @@ void cpu_mos6502::op_clv(std::uint16_t src) noexcept
     status::set_overflow(register_status_, 0);
 }
 
+template <bool immediate>
 void cpu_mos6502::op_cmp(std::uint16_t src) noexcept
 {
-    const unsigned int tmp = register_a_ - bus_read(src);
+    const unsigned int tmp = register_a_ - read_operand<immediate>(src);
     status::set_carry(register_status_, tmp < 0x100);
     status::set_negative(register_status_, tmp & 0x80);
     status::set_zero(register_status_, !(tmp & 0xFF));
 }
 
+template <bool immediate>
 void cpu_mos6502::op_cpx(std::uint16_t src) noexcept
 {
-    const unsigned int tmp = register_x_ - bus_read(src);
+    const unsigned int tmp = register_x_ - read_operand<immediate>(src);
     status::set_carry(register_status_, tmp < 0x100);
     status::set_negative(register_status_, tmp & 0x80);
     status::set_zero(register_status_, !(tmp & 0xFF));
 }
 
+template <bool immediate>
 void cpu_mos6502::op_cpy(std::uint16_t src) noexcept
 {
-    const unsigned int tmp = register_y_ - bus_read(src);
+    const unsigned int tmp = register_y_ - read_operand<immediate>(src);
     status::set_carry(register_status_, tmp < 0x100);
     status::set_negative(register_status_, tmp & 0x80);
     status::set_zero(register_status_, !(tmp & 0xFF));
@@ -465,9 +647,10 @@ void cpu_mos6502::op_dey(std::uint16_t src) noexcept
     register_y_ = m;
 }
 
+template <bool immediate>
 void cpu_mos6502::op_eor(std::uint16_t src) noexcept
 {
-    auto m = bus_read(src);
+    auto m = read_operand<immediate>(src);
     m = register_a_ ^ m;
     status::set_negative(register_status_, m & 0x80);
     status::set_zero(register_status_, !m);
@@ -514,25 +697,28 @@ void cpu_mos6502::op_jsr(std::uint16_t src) noexcept
     register_pc_ = src;
 }
 
+template <bool immediate>
 void cpu_mos6502::op_lda(std::uint16_t src) noexcept
 {
-    const auto m = bus_read(src);
+    const auto m = read_operand<immediate>(src);
     status::set_negative(register_status_, m & 0x80);
     status::set_zero(register_status_, !m);
     register_a_ = m;
 }
 
+template <bool immediate>
 void cpu_mos6502::op_ldx(std::uint16_t src) noexcept
 {
-    const auto m = bus_read(src);
+    const auto m = read_operand<immediate>(src);
     status::set_negative(register_status_, m & 0x80);
     status::set_zero(register_status_, !m);
     register_x_ = m;
 }
 
+template <bool immediate>
 void cpu_mos6502::op_ldy(std::uint16_t src) noexcept
 {
-    const auto m = bus_read(src);
+    const auto m = read_operand<immediate>(src);
     status::set_negative(register_status_, m & 0x80);
     status::set_zero(register_status_, !m);
     register_y_ = m;
@@ -562,9 +748,10 @@ void cpu_mos6502::op_nop(std::uint16_t src) noexcept
 {
 }
 
+template <bool immediate>
 void cpu_mos6502::op_ora(std::uint16_t src) noexcept
 {
-    auto m = bus_read(src);
+    auto m = read_operand<immediate>(src);
     m = register_a_ | m;
     status::set_negative(register_status_, m & 0x80);
     status::set_zero(register_status_, !m);
@@ -661,9 +848,10 @@ void cpu_mos6502::op_rts(std::uint16_t src) noexcept
     register_pc_ = ((hi << 8) | lo) + 1;
 }
 
+template <bool immediate>
 void cpu_mos6502::op_sbc(std::uint16_t src) noexcept
 {
-    const auto m = bus_read(src);
+    const auto m = read_operand<immediate>(src);
     unsigned int tmp = register_a_ - m - (status::is_carry_flag_set(register_status_) ? 0 : 1);
     status::set_negative(register_status_, tmp & 0x80);
     status::set_zero(register_status_, !(tmp & 0xFF));
@@ -775,7 +963,7 @@ void cpu_mos6502::initialize_illegal_opcodes() noexcept
 
 void cpu_mos6502::initialize_opcodes() noexcept
 {
-    instruction_[0x69] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_adc};
+    instruction_[0x69] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_adc<true>};
     instruction_[0x6D] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_adc};
     instruction_[0x65] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_adc};
     instruction_[0x61] = {&cpu_mos6502::addr_inx, &cpu_mos6502::op_adc};
@@ -784,7 +972,7 @@ void cpu_mos6502::initialize_opcodes() noexcept
     instruction_[0x7D] = {&cpu_mos6502::addr_abx, &cpu_mos6502::op_adc};
     instruction_[0x79] = {&cpu_mos6502::addr_aby, &cpu_mos6502::op_adc};
 
-    instruction_[0x29] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_and};
+    instruction_[0x29] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_and<true>};
     instruction_[0x2D] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_and};
     instruction_[0x25] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_and};
     instruction_[0x21] = {&cpu_mos6502::addr_inx, &cpu_mos6502::op_and};
@@ -828,7 +1016,7 @@ void cpu_mos6502::initialize_opcodes() noexcept
 
     instruction_[0xB8] = {&cpu_mos6502::addr_imp, &cpu_mos6502::op_clv};
 
-    instruction_[0xC9] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_cmp};
+    instruction_[0xC9] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_cmp<true>};
     instruction_[0xCD] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_cmp};
     instruction_[0xC5] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_cmp};
     instruction_[0xC1] = {&cpu_mos6502::addr_inx, &cpu_mos6502::op_cmp};
@@ -837,11 +1025,11 @@ void cpu_mos6502::initialize_opcodes() noexcept
     instruction_[0xDD] = {&cpu_mos6502::addr_abx, &cpu_mos6502::op_cmp};
     instruction_[0xD9] = {&cpu_mos6502::addr_aby, &cpu_mos6502::op_cmp};
 
-    instruction_[0xE0] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_cpx};
+    instruction_[0xE0] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_cpx<true>};
     instruction_[0xEC] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_cpx};
     instruction_[0xE4] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_cpx};
 
-    instruction_[0xC0] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_cpy};
+    instruction_[0xC0] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_cpy<true>};
     instruction_[0xCC] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_cpy};
     instruction_[0xC4] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_cpy};
 
@@ -854,7 +1042,7 @@ void cpu_mos6502::initialize_opcodes() noexcept
 
     instruction_[0x88] = {&cpu_mos6502::addr_imp, &cpu_mos6502::op_dey};
 
-    instruction_[0x49] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_eor};
+    instruction_[0x49] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_eor<true>};
     instruction_[0x4D] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_eor};
     instruction_[0x45] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_eor};
     instruction_[0x41] = {&cpu_mos6502::addr_inx, &cpu_mos6502::op_eor};
@@ -877,7 +1065,7 @@ void cpu_mos6502::initialize_opcodes() noexcept
 
     instruction_[0x20] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_jsr};
 
-    instruction_[0xA9] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_lda};
+    instruction_[0xA9] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_lda<true>};
     instruction_[0xAD] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_lda};
     instruction_[0xA5] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_lda};
     instruction_[0xA1] = {&cpu_mos6502::addr_inx, &cpu_mos6502::op_lda};
@@ -886,13 +1074,13 @@ void cpu_mos6502::initialize_opcodes() noexcept
     instruction_[0xBD] = {&cpu_mos6502::addr_abx, &cpu_mos6502::op_lda};
     instruction_[0xB9] = {&cpu_mos6502::addr_aby, &cpu_mos6502::op_lda};
 
-    instruction_[0xA2] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_ldx};
+    instruction_[0xA2] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_ldx<true>};
     instruction_[0xAE] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_ldx};
     instruction_[0xA6] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_ldx};
     instruction_[0xBE] = {&cpu_mos6502::addr_aby, &cpu_mos6502::op_ldx};
     instruction_[0xB6] = {&cpu_mos6502::addr_zey, &cpu_mos6502::op_ldx};
 
-    instruction_[0xA0] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_ldy};
+    instruction_[0xA0] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_ldy<true>};
     instruction_[0xAC] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_ldy};
     instruction_[0xA4] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_ldy};
     instruction_[0xB4] = {&cpu_mos6502::addr_zex, &cpu_mos6502::op_ldy};
@@ -906,7 +1094,7 @@ void cpu_mos6502::initialize_opcodes() noexcept
 
     instruction_[0xEA] = {&cpu_mos6502::addr_imp, &cpu_mos6502::op_nop};
 
-    instruction_[0x09] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_ora};
+    instruction_[0x09] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_ora<true>};
     instruction_[0x0D] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_ora};
     instruction_[0x05] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_ora};
     instruction_[0x01] = {&cpu_mos6502::addr_inx, &cpu_mos6502::op_ora};
@@ -939,7 +1127,7 @@ void cpu_mos6502::initialize_opcodes() noexcept
 
     instruction_[0x60] = {&cpu_mos6502::addr_imp, &cpu_mos6502::op_rts};
 
-    instruction_[0xE9] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_sbc};
+    instruction_[0xE9] = {&cpu_mos6502::addr_imm, &cpu_mos6502::op_sbc<true>};
     instruction_[0xED] = {&cpu_mos6502::addr_abs, &cpu_mos6502::op_sbc};
     instruction_[0xE5] = {&cpu_mos6502::addr_zer, &cpu_mos6502::op_sbc};
     instruction_[0xE1] = {&cpu_mos6502::addr_inx, &cpu_mos6502::op_sbc};
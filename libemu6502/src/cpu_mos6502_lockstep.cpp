@@ -0,0 +1,1009 @@
+#include <emu6502/cpu_mos6502_lockstep.h>
+#include <status_registers.h>
+#include <opcode_cycles.h>
+#include <lane_vector.h>
+#include <stdexcept>
+
+namespace emu6502
+{
+
+static constexpr std::uint16_t irq_vector_h = 0xFFFF;
+static constexpr std::uint16_t irq_vector_l = 0xFFFE;
+static constexpr std::uint16_t rst_vector_h = 0xFFFD;
+static constexpr std::uint16_t rst_vector_l = 0xFFFC;
+
+static_assert(cpu_mos6502_lockstep::max_lanes == lane_vector_width);
+
+// Addressing modes and operations mirror the addr_ and op_ members of cpu_mos6502.
+enum class addressing_mode : std::uint8_t
+{
+    addr_acc,
+    addr_imm,
+    addr_abs,
+    addr_zer,
+    addr_zex,
+    addr_zey,
+    addr_abx,
+    addr_aby,
+    addr_imp,
+    addr_rel,
+    addr_inx,
+    addr_iny,
+    addr_abi
+};
+
+enum class operation : std::uint8_t
+{
+    op_adc,
+    op_and,
+    op_asl,
+    op_asl_acc,
+    op_bcc,
+    op_bcs,
+    op_beq,
+    op_bit,
+    op_bmi,
+    op_bne,
+    op_bpl,
+    op_brk,
+    op_bvc,
+    op_bvs,
+    op_clc,
+    op_cld,
+    op_cli,
+    op_clv,
+    op_cmp,
+    op_cpx,
+    op_cpy,
+    op_dec,
+    op_dex,
+    op_dey,
+    op_eor,
+    op_inc,
+    op_inx,
+    op_iny,
+    op_jmp,
+    op_jsr,
+    op_lda,
+    op_ldx,
+    op_ldy,
+    op_lsr,
+    op_lsr_acc,
+    op_nop,
+    op_ora,
+    op_pha,
+    op_php,
+    op_pla,
+    op_plp,
+    op_rol,
+    op_rol_acc,
+    op_ror,
+    op_ror_acc,
+    op_rti,
+    op_rts,
+    op_sbc,
+    op_sec,
+    op_sed,
+    op_sei,
+    op_sta,
+    op_stx,
+    op_sty,
+    op_tax,
+    op_tay,
+    op_tsx,
+    op_txa,
+    op_txs,
+    op_tya,
+    op_illegal
+};
+
+struct decoded_opcode
+{
+    addressing_mode mode{addressing_mode::addr_imp};
+    operation op{operation::op_illegal};
+};
+
+// Same mapping as cpu_mos6502::initialize_opcodes; everything else is illegal.
+static constexpr auto make_decode_table() noexcept
+{
+    std::array<decoded_opcode, 256> table{};
+
+    table[0x00] = {addressing_mode::addr_imp, operation::op_brk};
+    table[0x01] = {addressing_mode::addr_inx, operation::op_ora};
+    table[0x05] = {addressing_mode::addr_zer, operation::op_ora};
+    table[0x06] = {addressing_mode::addr_zer, operation::op_asl};
+    table[0x08] = {addressing_mode::addr_imp, operation::op_php};
+    table[0x09] = {addressing_mode::addr_imm, operation::op_ora};
+    table[0x0A] = {addressing_mode::addr_acc, operation::op_asl_acc};
+    table[0x0D] = {addressing_mode::addr_abs, operation::op_ora};
+    table[0x0E] = {addressing_mode::addr_abs, operation::op_asl};
+    table[0x10] = {addressing_mode::addr_rel, operation::op_bpl};
+    table[0x11] = {addressing_mode::addr_iny, operation::op_ora};
+    table[0x15] = {addressing_mode::addr_zex, operation::op_ora};
+    table[0x16] = {addressing_mode::addr_zex, operation::op_asl};
+    table[0x18] = {addressing_mode::addr_imp, operation::op_clc};
+    table[0x19] = {addressing_mode::addr_aby, operation::op_ora};
+    table[0x1D] = {addressing_mode::addr_abx, operation::op_ora};
+    table[0x1E] = {addressing_mode::addr_abx, operation::op_asl};
+    table[0x20] = {addressing_mode::addr_abs, operation::op_jsr};
+    table[0x21] = {addressing_mode::addr_inx, operation::op_and};
+    table[0x24] = {addressing_mode::addr_zer, operation::op_bit};
+    table[0x25] = {addressing_mode::addr_zer, operation::op_and};
+    table[0x26] = {addressing_mode::addr_zer, operation::op_rol};
+    table[0x28] = {addressing_mode::addr_imp, operation::op_plp};
+    table[0x29] = {addressing_mode::addr_imm, operation::op_and};
+    table[0x2A] = {addressing_mode::addr_acc, operation::op_rol_acc};
+    table[0x2C] = {addressing_mode::addr_abs, operation::op_bit};
+    table[0x2D] = {addressing_mode::addr_abs, operation::op_and};
+    table[0x2E] = {addressing_mode::addr_abs, operation::op_rol};
+    table[0x30] = {addressing_mode::addr_rel, operation::op_bmi};
+    table[0x31] = {addressing_mode::addr_iny, operation::op_and};
+    table[0x35] = {addressing_mode::addr_zex, operation::op_and};
+    table[0x36] = {addressing_mode::addr_zex, operation::op_rol};
+    table[0x38] = {addressing_mode::addr_imp, operation::op_sec};
+    table[0x39] = {addressing_mode::addr_aby, operation::op_and};
+    table[0x3D] = {addressing_mode::addr_abx, operation::op_and};
+    table[0x3E] = {addressing_mode::addr_abx, operation::op_rol};
+    table[0x40] = {addressing_mode::addr_imp, operation::op_rti};
+    table[0x41] = {addressing_mode::addr_inx, operation::op_eor};
+    table[0x45] = {addressing_mode::addr_zer, operation::op_eor};
+    table[0x46] = {addressing_mode::addr_zer, operation::op_lsr};
+    table[0x48] = {addressing_mode::addr_imp, operation::op_pha};
+    table[0x49] = {addressing_mode::addr_imm, operation::op_eor};
+    table[0x4A] = {addressing_mode::addr_acc, operation::op_lsr_acc};
+    table[0x4C] = {addressing_mode::addr_abs, operation::op_jmp};
+    table[0x4D] = {addressing_mode::addr_abs, operation::op_eor};
+    table[0x4E] = {addressing_mode::addr_abs, operation::op_lsr};
+    table[0x50] = {addressing_mode::addr_rel, operation::op_bvc};
+    table[0x51] = {addressing_mode::addr_iny, operation::op_eor};
+    table[0x55] = {addressing_mode::addr_zex, operation::op_eor};
+    table[0x56] = {addressing_mode::addr_zex, operation::op_lsr};
+    table[0x58] = {addressing_mode::addr_imp, operation::op_cli};
+    table[0x59] = {addressing_mode::addr_aby, operation::op_eor};
+    table[0x5D] = {addressing_mode::addr_abx, operation::op_eor};
+    table[0x5E] = {addressing_mode::addr_abx, operation::op_lsr};
+    table[0x60] = {addressing_mode::addr_imp, operation::op_rts};
+    table[0x61] = {addressing_mode::addr_inx, operation::op_adc};
+    table[0x65] = {addressing_mode::addr_zer, operation::op_adc};
+    table[0x66] = {addressing_mode::addr_zer, operation::op_ror};
+    table[0x68] = {addressing_mode::addr_imp, operation::op_pla};
+    table[0x69] = {addressing_mode::addr_imm, operation::op_adc};
+    table[0x6A] = {addressing_mode::addr_acc, operation::op_ror_acc};
+    table[0x6C] = {addressing_mode::addr_abi, operation::op_jmp};
+    table[0x6D] = {addressing_mode::addr_abs, operation::op_adc};
+    table[0x6E] = {addressing_mode::addr_abs, operation::op_ror};
+    table[0x70] = {addressing_mode::addr_rel, operation::op_bvs};
+    table[0x71] = {addressing_mode::addr_iny, operation::op_adc};
+    table[0x75] = {addressing_mode::addr_zex, operation::op_adc};
+    table[0x76] = {addressing_mode::addr_zex, operation::op_ror};
+    table[0x78] = {addressing_mode::addr_imp, operation::op_sei};
+    table[0x79] = {addressing_mode::addr_aby, operation::op_adc};
+    table[0x7D] = {addressing_mode::addr_abx, operation::op_adc};
+    table[0x7E] = {addressing_mode::addr_abx, operation::op_ror};
+    table[0x81] = {addressing_mode::addr_inx, operation::op_sta};
+    table[0x84] = {addressing_mode::addr_zer, operation::op_sty};
+    table[0x85] = {addressing_mode::addr_zer, operation::op_sta};
+    table[0x86] = {addressing_mode::addr_zer, operation::op_stx};
+    table[0x88] = {addressing_mode::addr_imp, operation::op_dey};
+    table[0x8A] = {addressing_mode::addr_imp, operation::op_txa};
+    table[0x8C] = {addressing_mode::addr_abs, operation::op_sty};
+    table[0x8D] = {addressing_mode::addr_abs, operation::op_sta};
+    table[0x8E] = {addressing_mode::addr_abs, operation::op_stx};
+    table[0x90] = {addressing_mode::addr_rel, operation::op_bcc};
+    table[0x91] = {addressing_mode::addr_iny, operation::op_sta};
+    table[0x94] = {addressing_mode::addr_zex, operation::op_sty};
+    table[0x95] = {addressing_mode::addr_zex, operation::op_sta};
+    table[0x96] = {addressing_mode::addr_zey, operation::op_stx};
+    table[0x98] = {addressing_mode::addr_imp, operation::op_tya};
+    table[0x99] = {addressing_mode::addr_aby, operation::op_sta};
+    table[0x9A] = {addressing_mode::addr_imp, operation::op_txs};
+    table[0x9D] = {addressing_mode::addr_abx, operation::op_sta};
+    table[0xA0] = {addressing_mode::addr_imm, operation::op_ldy};
+    table[0xA1] = {addressing_mode::addr_inx, operation::op_lda};
+    table[0xA2] = {addressing_mode::addr_imm, operation::op_ldx};
+    table[0xA4] = {addressing_mode::addr_zer, operation::op_ldy};
+    table[0xA5] = {addressing_mode::addr_zer, operation::op_lda};
+    table[0xA6] = {addressing_mode::addr_zer, operation::op_ldx};
+    table[0xA8] = {addressing_mode::addr_imp, operation::op_tay};
+    table[0xA9] = {addressing_mode::addr_imm, operation::op_lda};
+    table[0xAA] = {addressing_mode::addr_imp, operation::op_tax};
+    table[0xAC] = {addressing_mode::addr_abs, operation::op_ldy};
+    table[0xAD] = {addressing_mode::addr_abs, operation::op_lda};
+    table[0xAE] = {addressing_mode::addr_abs, operation::op_ldx};
+    table[0xB0] = {addressing_mode::addr_rel, operation::op_bcs};
+    table[0xB1] = {addressing_mode::addr_iny, operation::op_lda};
+    table[0xB4] = {addressing_mode::addr_zex, operation::op_ldy};
+    table[0xB5] = {addressing_mode::addr_zex, operation::op_lda};
+    table[0xB6] = {addressing_mode::addr_zey, operation::op_ldx};
+    table[0xB8] = {addressing_mode::addr_imp, operation::op_clv};
+    table[0xB9] = {addressing_mode::addr_aby, operation::op_lda};
+    table[0xBA] = {addressing_mode::addr_imp, operation::op_tsx};
+    table[0xBC] = {addressing_mode::addr_abx, operation::op_ldy};
+    table[0xBD] = {addressing_mode::addr_abx, operation::op_lda};
+    table[0xBE] = {addressing_mode::addr_aby, operation::op_ldx};
+    table[0xC0] = {addressing_mode::addr_imm, operation::op_cpy};
+    table[0xC1] = {addressing_mode::addr_inx, operation::op_cmp};
+    table[0xC4] = {addressing_mode::addr_zer, operation::op_cpy};
+    table[0xC5] = {addressing_mode::addr_zer, operation::op_cmp};
+    table[0xC6] = {addressing_mode::addr_zer, operation::op_dec};
+    table[0xC8] = {addressing_mode::addr_imp, operation::op_iny};
+    table[0xC9] = {addressing_mode::addr_imm, operation::op_cmp};
+    table[0xCA] = {addressing_mode::addr_imp, operation::op_dex};
+    table[0xCC] = {addressing_mode::addr_abs, operation::op_cpy};
+    table[0xCD] = {addressing_mode::addr_abs, operation::op_cmp};
+    table[0xCE] = {addressing_mode::addr_abs, operation::op_dec};
+    table[0xD0] = {addressing_mode::addr_rel, operation::op_bne};
+    table[0xD1] = {addressing_mode::addr_iny, operation::op_cmp};
+    table[0xD5] = {addressing_mode::addr_zex, operation::op_cmp};
+    table[0xD6] = {addressing_mode::addr_zex, operation::op_dec};
+    table[0xD8] = {addressing_mode::addr_imp, operation::op_cld};
+    table[0xD9] = {addressing_mode::addr_aby, operation::op_cmp};
+    table[0xDD] = {addressing_mode::addr_abx, operation::op_cmp};
+    table[0xDE] = {addressing_mode::addr_abx, operation::op_dec};
+    table[0xE0] = {addressing_mode::addr_imm, operation::op_cpx};
+    table[0xE1] = {addressing_mode::addr_inx, operation::op_sbc};
+    table[0xE4] = {addressing_mode::addr_zer, operation::op_cpx};
+    table[0xE5] = {addressing_mode::addr_zer, operation::op_sbc};
+    table[0xE6] = {addressing_mode::addr_zer, operation::op_inc};
+    table[0xE8] = {addressing_mode::addr_imp, operation::op_inx};
+    table[0xE9] = {addressing_mode::addr_imm, operation::op_sbc};
+    table[0xEA] = {addressing_mode::addr_imp, operation::op_nop};
+    table[0xEC] = {addressing_mode::addr_abs, operation::op_cpx};
+    table[0xED] = {addressing_mode::addr_abs, operation::op_sbc};
+    table[0xEE] = {addressing_mode::addr_abs, operation::op_inc};
+    table[0xF0] = {addressing_mode::addr_rel, operation::op_beq};
+    table[0xF1] = {addressing_mode::addr_iny, operation::op_sbc};
+    table[0xF5] = {addressing_mode::addr_zex, operation::op_sbc};
+    table[0xF6] = {addressing_mode::addr_zex, operation::op_inc};
+    table[0xF8] = {addressing_mode::addr_imp, operation::op_sed};
+    table[0xF9] = {addressing_mode::addr_aby, operation::op_sbc};
+    table[0xFD] = {addressing_mode::addr_abx, operation::op_sbc};
+    table[0xFE] = {addressing_mode::addr_abx, operation::op_inc};
+
+    return table;
+}
+
+static constexpr auto decode_table = make_decode_table();
+
+static auto make_mask(const std::uint32_t group) noexcept
+{
+    alignas(16) std::array<std::uint8_t, lane_vector_width> bytes{};
+
+    for (auto lane = 0u; lane < lane_vector_width; ++lane)
+        bytes[lane] = (group & (1u << lane)) ? 0xFF : 0x00;
+
+    return lane_vector::load(std::data(bytes));
+}
+
+static auto load_lanes(const std::array<std::uint8_t, cpu_mos6502_lockstep::max_lanes> &reg) noexcept
+{
+    return lane_vector::load(std::data(reg));
+}
+
+static void store_lanes(std::array<std::uint8_t, cpu_mos6502_lockstep::max_lanes> &reg, const lane_vector mask,
+                  const lane_vector value) noexcept
+{
+    select(mask, value, load_lanes(reg)).store(std::data(reg));
+}
+
+// Negative and zero flags of a result, in their status register positions.
+static auto nz_flags(const lane_vector value) noexcept
+{
+    return to_bits(value, status::negative_flag) | to_bits(equal(value, lane_vector::splat(0)), status::zero_flag);
+}
+
+static auto clear_flags(const lane_vector status, const std::uint8_t flags) noexcept
+{
+    return status & lane_vector::splat(static_cast<std::uint8_t>(~flags));
+}
+
+// Decimal mode is rare, so it is handled one lane at a time with the exact cpu_mos6502 logic.
+static void adc_decimal(std::uint8_t &a, std::uint8_t &p, const std::uint8_t m) noexcept
+{
+    unsigned int tmp = m + a + (status::is_carry_flag_set(p) ? 1 : 0);
+    status::set_zero(p, !(tmp & 0xFF));
+
+    if (((a & 0xF) + (m & 0xF) + (status::is_carry_flag_set(p) ? 1 : 0)) > 9)
+        tmp += 6;
+
+    status::set_negative(p, tmp & 0x80);
+    status::set_overflow(p, !((a ^ m) & 0x80) && ((a ^ tmp) & 0x80));
+
+    if (tmp > 0x99)
+        tmp += 96;
+
+    status::set_carry(p, tmp > 0x99);
+    a = tmp & 0xFF;
+}
+
+static void sbc_decimal(std::uint8_t &a, std::uint8_t &p, const std::uint8_t m) noexcept
+{
+    unsigned int tmp = a - m - (status::is_carry_flag_set(p) ? 0 : 1);
+    status::set_negative(p, tmp & 0x80);
+    status::set_zero(p, !(tmp & 0xFF));
+    status::set_overflow(p, ((a ^ tmp) & 0x80) && ((a ^ m) & 0x80));
+
+    if (((a & 0x0F) - (status::is_carry_flag_set(p) ? 0 : 1)) < (m & 0x0F))
+        tmp -= 6;
+
+    if (tmp > 0x99)
+        tmp -= 0x60;
+
+    status::set_carry(p, tmp < 0x100);
+    a = (tmp & 0xFF);
+}
+
+cpu_mos6502_lockstep::cpu_mos6502_lockstep(const std::size_t lane_count)
+    : lane_count_{lane_count}
+    , register_a_{}
+    , register_x_{}
+    , register_y_{}
+    , register_sp_{}
+    , register_status_{}
+    , illegal_opcode_{}
+    , register_pc_{}
+    , num_executed_instructions_{}
+    , cycles_{}
+    , operand_{}
+    , address_{}
+    , num_executed_groups_{}
+    , pages_{}
+    , memory_(lane_count * memory_size)
+{
+    if (lane_count == 0 || lane_count > max_lanes)
+        throw std::runtime_error{"Lockstep lane count must be between 1 and 16."};
+
+    pages_.fill(lockstep_page_access::ram);
+    reset();
+}
+
+void cpu_mos6502_lockstep::map(const std::uint16_t offset, const std::uint32_t size,
+                               const lockstep_page_access access) noexcept
+{
+    if (size == 0)
+        return;
+
+    const std::uint32_t first = offset >> 8;
+    const auto last = std::min<std::uint32_t>((offset + size - 1) >> 8, 0xFF);
+
+    for (auto page = first; page <= last; ++page)
+        pages_[page] = access;
+}
+
+void cpu_mos6502_lockstep::load(const std::size_t lane, const std::uint16_t offset, const std::uint8_t *data,
+                                const std::size_t size) noexcept
+{
+    auto lane_memory = std::data(memory_) + lane * memory_size;
+
+    for (auto i = 0u; i < size && offset + i < memory_size; ++i)
+    {
+        const auto address = offset + i;
+
+        if (pages_[address >> 8] != lockstep_page_access::unmapped)
+            lane_memory[address] = data[i];
+    }
+}
+
+void cpu_mos6502_lockstep::load_all(const std::uint16_t offset, const std::uint8_t *data,
+                                    const std::size_t size) noexcept
+{
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+        load(lane, offset, data, size);
+}
+
+void cpu_mos6502_lockstep::reset() noexcept
+{
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        register_a_[lane] = 0x00;
+        register_y_[lane] = 0x00;
+        register_x_[lane] = 0x00;
+        register_pc_[lane] = static_cast<std::uint16_t>((read(lane, rst_vector_h) << 8) + read(lane, rst_vector_l));
+        register_sp_[lane] = 0xFD;
+        register_status_[lane] |= status::constant_flag;
+        num_executed_instructions_[lane] = 0;
+        illegal_opcode_[lane] = 0;
+    }
+}
+
+void cpu_mos6502_lockstep::step(const std::uint32_t n) noexcept
+{
+    if (n == 0)
+        return;
+
+    std::array<std::uint32_t, max_lanes> remaining{};
+    lane_mask active = 0;
+
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        if (illegal_opcode_[lane])
+            continue;
+
+        remaining[lane] = n;
+        active |= 1u << lane;
+    }
+
+    while (active)
+    {
+        std::uint8_t opcode = 0;
+        const auto group = next_group(active, opcode);
+        execute(group, opcode);
+
+        for (auto lane = 0u; lane < lane_count_; ++lane)
+        {
+            if (!(group & (1u << lane)))
+                continue;
+
+            if (--remaining[lane] == 0 || illegal_opcode_[lane])
+                active &= ~(1u << lane);
+        }
+    }
+}
+
+auto cpu_mos6502_lockstep::state(const std::size_t lane) const noexcept -> cpu_state
+{
+    cpu_state state;
+    state.a = register_a_[lane];
+    state.x = register_x_[lane];
+    state.y = register_y_[lane];
+    state.sp = register_sp_[lane];
+    state.pc = register_pc_[lane];
+    state.status = register_status_[lane];
+    state.num_executed_instructions = num_executed_instructions_[lane];
+    state.cycle = cycles_[lane];
+    state.illegal_opcode = illegal_opcode_[lane] != 0;
+    return state;
+}
+
+void cpu_mos6502_lockstep::restore_state(const std::size_t lane, const cpu_state &state) noexcept
+{
+    register_a_[lane] = state.a;
+    register_x_[lane] = state.x;
+    register_y_[lane] = state.y;
+    register_sp_[lane] = state.sp;
+    register_pc_[lane] = state.pc;
+    register_status_[lane] = state.status;
+    num_executed_instructions_[lane] = state.num_executed_instructions;
+    cycles_[lane] = state.cycle;
+    illegal_opcode_[lane] = state.illegal_opcode ? 1 : 0;
+}
+
+auto cpu_mos6502_lockstep::read(const std::size_t lane, const std::uint16_t address) const noexcept -> std::uint8_t
+{
+    // Unmapped pages are never written, so they read as 0 like an empty spot on the bus.
+    return memory_[lane * memory_size + address];
+}
+
+void cpu_mos6502_lockstep::write(const std::size_t lane, const std::uint16_t address,
+                                 const std::uint8_t value) noexcept
+{
+    if (pages_[address >> 8] == lockstep_page_access::ram)
+        memory_[lane * memory_size + address] = value;
+}
+
+void cpu_mos6502_lockstep::stack_push(const std::size_t lane, const std::uint8_t value) noexcept
+{
+    auto &sp = register_sp_[lane];
+    write(lane, static_cast<std::uint16_t>(0x0100 + sp), value);
+    sp = static_cast<std::uint8_t>(sp - 1);
+}
+
+auto cpu_mos6502_lockstep::stack_pop(const std::size_t lane) noexcept -> std::uint8_t
+{
+    auto &sp = register_sp_[lane];
+    sp = static_cast<std::uint8_t>(sp + 1);
+    return read(lane, static_cast<std::uint16_t>(0x0100 + sp));
+}
+
+auto cpu_mos6502_lockstep::next_group(const lane_mask active, std::uint8_t &opcode) const noexcept -> lane_mask
+{
+    // Running the lowest program counter first lets lanes that skipped ahead at a forward branch wait
+    // for the others at the join point.
+    std::size_t first = max_lanes;
+
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        if ((active & (1u << lane)) && (first == max_lanes || register_pc_[lane] < register_pc_[first]))
+            first = lane;
+    }
+
+    const auto pc = register_pc_[first];
+    opcode = read(first, pc);
+
+    // Lanes can hold different code at the same address, for example after self-modifying code.
+    lane_mask group = 0;
+    for (auto lane = first; lane < lane_count_; ++lane)
+    {
+        if ((active & (1u << lane)) && register_pc_[lane] == pc && read(lane, pc) == opcode)
+            group |= 1u << lane;
+    }
+
+    return group;
+}
+
+void cpu_mos6502_lockstep::resolve_addresses(const lane_mask group, const std::uint8_t opcode) noexcept
+{
+    const auto mode = decode_table[opcode].mode;
+
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        if (!(group & (1u << lane)))
+            continue;
+
+        auto &pc = register_pc_[lane];
+        std::uint16_t address = 0;
+
+        switch (mode)
+        {
+            case addressing_mode::addr_imm:
+                address = pc++;
+                break;
+            case addressing_mode::addr_abs:
+            {
+                const std::uint16_t addr_l = read(lane, pc++);
+                const std::uint16_t addr_h = read(lane, pc++);
+                address = static_cast<std::uint16_t>(addr_l + (addr_h << 8));
+                break;
+            }
+            case addressing_mode::addr_zer:
+                address = read(lane, pc++);
+                break;
+            case addressing_mode::addr_zex:
+                address = (read(lane, pc++) + register_x_[lane]) % 256;
+                break;
+            case addressing_mode::addr_zey:
+                address = (read(lane, pc++) + register_y_[lane]) % 256;
+                break;
+            case addressing_mode::addr_abx:
+            case addressing_mode::addr_aby:
+            {
+                const std::uint16_t addr_l = read(lane, pc++);
+                const std::uint16_t addr_h = read(lane, pc++);
+                const auto index = mode == addressing_mode::addr_abx ? register_x_[lane] : register_y_[lane];
+                address = static_cast<std::uint16_t>(addr_l + (addr_h << 8) + index);
+                break;
+            }
+            case addressing_mode::addr_rel:
+            {
+                auto offset = static_cast<std::uint16_t>(read(lane, pc++));
+
+                if (offset & 0x80)
+                    offset |= 0xFF00;
+
+                address = static_cast<std::uint16_t>(pc + static_cast<std::int16_t>(offset));
+                break;
+            }
+            case addressing_mode::addr_inx:
+            {
+                const std::uint16_t zero_l = (read(lane, pc++) + register_x_[lane]) % 256;
+                const std::uint16_t zero_h = (zero_l + 1) % 256;
+                address = static_cast<std::uint16_t>(read(lane, zero_l) + (read(lane, zero_h) << 8));
+                break;
+            }
+            case addressing_mode::addr_iny:
+            {
+                const std::uint16_t zero_l = read(lane, pc++);
+                const std::uint16_t zero_h = (zero_l + 1) % 256;
+                address = static_cast<std::uint16_t>(read(lane, zero_l) + (read(lane, zero_h) << 8) +
+                                                     register_y_[lane]);
+                break;
+            }
+            case addressing_mode::addr_abi:
+            {
+                const std::uint16_t addr_l = read(lane, pc++);
+                const std::uint16_t addr_h = read(lane, pc++);
+                const std::uint16_t abs = (addr_h << 8) | addr_l;
+                const std::uint16_t eff_l = read(lane, abs);
+                const auto eff_h_address = static_cast<std::uint16_t>((abs & 0xFF00) + ((abs + 1) & 0x00FF));
+                const std::uint16_t eff_h = read(lane, eff_h_address);
+                address = static_cast<std::uint16_t>(eff_l + 0x100 * eff_h);
+                break;
+            }
+            case addressing_mode::addr_acc:
+            case addressing_mode::addr_imp:
+            default:
+                break;
+        }
+
+        address_[lane] = address;
+    }
+}
+
+void cpu_mos6502_lockstep::read_operands(const lane_mask group) noexcept
+{
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        if (group & (1u << lane))
+            operand_[lane] = read(lane, address_[lane]);
+    }
+}
+
+void cpu_mos6502_lockstep::write_operands(const lane_mask group) noexcept
+{
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        if (group & (1u << lane))
+            write(lane, address_[lane], operand_[lane]);
+    }
+}
+
+void cpu_mos6502_lockstep::execute_adc(const lane_mask group) noexcept
+{
+    read_operands(group);
+
+    const auto p = load_lanes(register_status_);
+    const auto decimal = lane_bits(any_set(p, status::decimal_flag)) & group;
+    const auto binary = make_mask(group & ~decimal);
+
+    const auto a = load_lanes(register_a_);
+    const auto m = load_lanes(operand_);
+    const auto carry_in = any_set(p, status::carry_flag);
+    const auto partial = a + m;
+    const auto sum = partial + to_bits(carry_in, 1);
+    const auto carry = greater(a, ~m) | (equal(partial, lane_vector::splat(0xFF)) & carry_in);
+    const auto overflow = shift_right_1(~(a ^ m) & (a ^ sum) & lane_vector::splat(0x80));
+
+    const auto flags = status::negative_flag | status::overflow_flag | status::zero_flag | status::carry_flag;
+    store_lanes(register_status_, binary,
+          clear_flags(p, flags) | nz_flags(sum) | overflow | to_bits(carry, status::carry_flag));
+    store_lanes(register_a_, binary, sum);
+
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        if (decimal & (1u << lane))
+            adc_decimal(register_a_[lane], register_status_[lane], operand_[lane]);
+    }
+}
+
+void cpu_mos6502_lockstep::execute_sbc(const lane_mask group) noexcept
+{
+    read_operands(group);
+
+    const auto p = load_lanes(register_status_);
+    const auto decimal = lane_bits(any_set(p, status::decimal_flag)) & group;
+    const auto binary = make_mask(group & ~decimal);
+
+    const auto a = load_lanes(register_a_);
+    const auto m = load_lanes(operand_);
+    const auto borrow_in = ~any_set(p, status::carry_flag);
+    const auto partial = a - m;
+    const auto difference = partial - to_bits(borrow_in, 1);
+    const auto borrow = greater(m, a) | (equal(partial, lane_vector::splat(0)) & borrow_in);
+    const auto overflow = shift_right_1((a ^ difference) & (a ^ m) & lane_vector::splat(0x80));
+
+    const auto flags = status::negative_flag | status::overflow_flag | status::zero_flag | status::carry_flag;
+    store_lanes(register_status_, binary,
+          clear_flags(p, flags) | nz_flags(difference) | overflow | to_bits(~borrow, status::carry_flag));
+    store_lanes(register_a_, binary, difference);
+
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        if (decimal & (1u << lane))
+            sbc_decimal(register_a_[lane], register_status_[lane], operand_[lane]);
+    }
+}
+
+void cpu_mos6502_lockstep::execute(const lane_mask group, const std::uint8_t opcode) noexcept
+{
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        if (group & (1u << lane))
+            ++register_pc_[lane];
+    }
+
+    resolve_addresses(group, opcode);
+
+    const auto mask = make_mask(group);
+    const auto p = load_lanes(register_status_);
+    const auto one = lane_vector::splat(1);
+    constexpr std::uint8_t nz = status::negative_flag | status::zero_flag;
+    constexpr std::uint8_t nzc = nz | status::carry_flag;
+
+    // Register loads and transfers, which only set N and Z.
+    const auto load_register = [&](auto &reg, const lane_vector value) {
+        store_lanes(reg, mask, value);
+        store_lanes(register_status_, mask, clear_flags(p, nz) | nz_flags(value));
+    };
+
+    const auto compare = [&](const lane_vector reg) {
+        read_operands(group);
+        const auto m = load_lanes(operand_);
+        const auto carry = to_bits(~greater(m, reg), status::carry_flag);
+        store_lanes(register_status_, mask, clear_flags(p, nzc) | nz_flags(reg - m) | carry);
+    };
+
+    const auto branch = [&](const std::uint8_t flag, const bool set) {
+        const auto flag_set = lane_bits(any_set(p, flag));
+        const auto taken = group & (set ? flag_set : ~flag_set);
+
+        for (auto lane = 0u; lane < lane_count_; ++lane)
+        {
+            if (taken & (1u << lane))
+                register_pc_[lane] = address_[lane];
+        }
+    };
+
+    // Shifts and rotates on memory go through the operand scratch, on the accumulator directly.
+    const auto shift = [&](auto &reg, const bool left, const bool rotate) {
+        const auto value = load_lanes(reg);
+        const auto carry_bit = static_cast<std::uint8_t>(left ? 0x01 : 0x80);
+        const auto carry_in = rotate ? to_bits(any_set(p, status::carry_flag), carry_bit) : lane_vector::splat(0);
+        const auto result = (left ? shift_left_1(value) : shift_right_1(value)) | carry_in;
+        const auto carry = to_bits(any_set(value, left ? 0x80 : 0x01), status::carry_flag);
+        store_lanes(reg, mask, result);
+        store_lanes(register_status_, mask, clear_flags(p, nzc) | nz_flags(result) | carry);
+    };
+
+    const auto modify = [&](const bool increment) {
+        read_operands(group);
+        const auto result = increment ? load_lanes(operand_) + one : load_lanes(operand_) - one;
+        store_lanes(operand_, mask, result);
+        store_lanes(register_status_, mask, clear_flags(p, nz) | nz_flags(result));
+        write_operands(group);
+    };
+
+    const auto store_register = [&](const auto &reg) {
+        store_lanes(operand_, mask, load_lanes(reg));
+        write_operands(group);
+    };
+
+    const auto set_flag = [&](const std::uint8_t flag, const bool set) {
+        store_lanes(register_status_, mask, set ? (p | lane_vector::splat(flag)) : clear_flags(p, flag));
+    };
+
+    const auto for_each_lane = [&](auto func) {
+        for (auto lane = 0u; lane < lane_count_; ++lane)
+        {
+            if (group & (1u << lane))
+                func(lane);
+        }
+    };
+
+    switch (decode_table[opcode].op)
+    {
+        case operation::op_adc:
+            execute_adc(group);
+            break;
+        case operation::op_sbc:
+            execute_sbc(group);
+            break;
+        case operation::op_and:
+            read_operands(group);
+            load_register(register_a_, load_lanes(register_a_) & load_lanes(operand_));
+            break;
+        case operation::op_ora:
+            read_operands(group);
+            load_register(register_a_, load_lanes(register_a_) | load_lanes(operand_));
+            break;
+        case operation::op_eor:
+            read_operands(group);
+            load_register(register_a_, load_lanes(register_a_) ^ load_lanes(operand_));
+            break;
+        case operation::op_asl:
+            read_operands(group);
+            shift(operand_, true, false);
+            write_operands(group);
+            break;
+        case operation::op_asl_acc:
+            shift(register_a_, true, false);
+            break;
+        case operation::op_lsr:
+            read_operands(group);
+            shift(operand_, false, false);
+            write_operands(group);
+            break;
+        case operation::op_lsr_acc:
+            shift(register_a_, false, false);
+            break;
+        case operation::op_rol:
+            read_operands(group);
+            shift(operand_, true, true);
+            write_operands(group);
+            break;
+        case operation::op_rol_acc:
+            shift(register_a_, true, true);
+            break;
+        case operation::op_ror:
+            read_operands(group);
+            shift(operand_, false, true);
+            write_operands(group);
+            break;
+        case operation::op_ror_acc:
+            shift(register_a_, false, true);
+            break;
+        case operation::op_bcc:
+            branch(status::carry_flag, false);
+            break;
+        case operation::op_bcs:
+            branch(status::carry_flag, true);
+            break;
+        case operation::op_beq:
+            branch(status::zero_flag, true);
+            break;
+        case operation::op_bne:
+            branch(status::zero_flag, false);
+            break;
+        case operation::op_bmi:
+            branch(status::negative_flag, true);
+            break;
+        case operation::op_bpl:
+            branch(status::negative_flag, false);
+            break;
+        case operation::op_bvc:
+            branch(status::overflow_flag, false);
+            break;
+        case operation::op_bvs:
+            branch(status::overflow_flag, true);
+            break;
+        case operation::op_bit:
+        {
+            read_operands(group);
+            const auto m = load_lanes(operand_);
+            const auto zero = to_bits(equal(m & load_lanes(register_a_), lane_vector::splat(0)), status::zero_flag);
+            const auto flags = status::negative_flag | status::overflow_flag | status::zero_flag;
+            store_lanes(register_status_, mask, clear_flags(p, flags) | (m & lane_vector::splat(0xC0)) | zero);
+            break;
+        }
+        case operation::op_brk:
+            for_each_lane([this](const std::size_t lane) {
+                auto &pc = register_pc_[lane];
+                pc++;
+                stack_push(lane, (pc >> 8) & 0xFF);
+                stack_push(lane, pc & 0xFF);
+                stack_push(lane, register_status_[lane] | status::break_flag);
+                status::set_interrupt(register_status_[lane], 1);
+                pc = static_cast<std::uint16_t>((read(lane, irq_vector_h) << 8) + read(lane, irq_vector_l));
+            });
+            break;
+        case operation::op_clc:
+            set_flag(status::carry_flag, false);
+            break;
+        case operation::op_cld:
+            set_flag(status::decimal_flag, false);
+            break;
+        case operation::op_cli:
+            set_flag(status::interrupt_flag, false);
+            break;
+        case operation::op_clv:
+            set_flag(status::overflow_flag, false);
+            break;
+        case operation::op_sec:
+            set_flag(status::carry_flag, true);
+            break;
+        case operation::op_sed:
+            set_flag(status::decimal_flag, true);
+            break;
+        case operation::op_sei:
+            set_flag(status::interrupt_flag, true);
+            break;
+        case operation::op_cmp:
+            compare(load_lanes(register_a_));
+            break;
+        case operation::op_cpx:
+            compare(load_lanes(register_x_));
+            break;
+        case operation::op_cpy:
+            compare(load_lanes(register_y_));
+            break;
+        case operation::op_dec:
+            modify(false);
+            break;
+        case operation::op_inc:
+            modify(true);
+            break;
+        case operation::op_dex:
+            load_register(register_x_, load_lanes(register_x_) - one);
+            break;
+        case operation::op_dey:
+            load_register(register_y_, load_lanes(register_y_) - one);
+            break;
+        case operation::op_inx:
+            load_register(register_x_, load_lanes(register_x_) + one);
+            break;
+        case operation::op_iny:
+            load_register(register_y_, load_lanes(register_y_) + one);
+            break;
+        case operation::op_jmp:
+            for_each_lane([this](const std::size_t lane) { register_pc_[lane] = address_[lane]; });
+            break;
+        case operation::op_jsr:
+            for_each_lane([this](const std::size_t lane) {
+                auto &pc = register_pc_[lane];
+                pc--;
+                stack_push(lane, (pc >> 8) & 0xFF);
+                stack_push(lane, pc & 0xFF);
+                pc = address_[lane];
+            });
+            break;
+        case operation::op_lda:
+            read_operands(group);
+            load_register(register_a_, load_lanes(operand_));
+            break;
+        case operation::op_ldx:
+            read_operands(group);
+            load_register(register_x_, load_lanes(operand_));
+            break;
+        case operation::op_ldy:
+            read_operands(group);
+            load_register(register_y_, load_lanes(operand_));
+            break;
+        case operation::op_pha:
+            for_each_lane([this](const std::size_t lane) { stack_push(lane, register_a_[lane]); });
+            break;
+        case operation::op_php:
+            for_each_lane([this](const std::size_t lane) {
+                stack_push(lane, register_status_[lane] | status::break_flag);
+            });
+            break;
+        case operation::op_pla:
+            for_each_lane([this](const std::size_t lane) { operand_[lane] = stack_pop(lane); });
+            load_register(register_a_, load_lanes(operand_));
+            break;
+        case operation::op_plp:
+            for_each_lane([this](const std::size_t lane) {
+                register_status_[lane] = stack_pop(lane) | status::constant_flag;
+            });
+            break;
+        case operation::op_rti:
+            for_each_lane([this](const std::size_t lane) {
+                register_status_[lane] = stack_pop(lane);
+                const auto lo = stack_pop(lane);
+                const auto hi = stack_pop(lane);
+                register_pc_[lane] = static_cast<std::uint16_t>((hi << 8) | lo);
+            });
+            break;
+        case operation::op_rts:
+            for_each_lane([this](const std::size_t lane) {
+                const auto lo = stack_pop(lane);
+                const auto hi = stack_pop(lane);
+                register_pc_[lane] = static_cast<std::uint16_t>(((hi << 8) | lo) + 1);
+            });
+            break;
+        case operation::op_sta:
+            store_register(register_a_);
+            break;
+        case operation::op_stx:
+            store_register(register_x_);
+            break;
+        case operation::op_sty:
+            store_register(register_y_);
+            break;
+        case operation::op_tax:
+            load_register(register_x_, load_lanes(register_a_));
+            break;
+        case operation::op_tay:
+            load_register(register_y_, load_lanes(register_a_));
+            break;
+        case operation::op_tsx:
+            load_register(register_x_, load_lanes(register_sp_));
+            break;
+        case operation::op_txa:
+            load_register(register_a_, load_lanes(register_x_));
+            break;
+        case operation::op_tya:
+            load_register(register_a_, load_lanes(register_y_));
+            break;
+        case operation::op_txs:
+            store_lanes(register_sp_, mask, load_lanes(register_x_));
+            break;
+        case operation::op_nop:
+            break;
+        case operation::op_illegal:
+        default:
+            store_lanes(illegal_opcode_, mask, one);
+            break;
+    }
+
+    for (auto lane = 0u; lane < lane_count_; ++lane)
+    {
+        if (!(group & (1u << lane)))
+            continue;
+
+        ++num_executed_instructions_[lane];
+        cycles_[lane] += opcode_cycles[opcode];
+    }
+
+    ++num_executed_groups_;
+}
+
+} // namespace emu6502
@@ -0,0 +1,357 @@
+#include <emu6502/engine_self_check.h>
+#include <aeon/common/string.h>
+#include <algorithm>
+#include <cstring>
+
+namespace emu6502
+{
+
+static constexpr std::size_t page_size = 256;
+static constexpr std::size_t page_count = 256;
+
+lockstep_lane_engine::lockstep_lane_engine(cpu_mos6502_lockstep &cpu, const std::size_t lane)
+    : cpu_{cpu}
+    , lane_{lane}
+{
+}
+
+void lockstep_lane_engine::step(const std::uint32_t n) noexcept
+{
+    cpu_.step(n);
+}
+
+auto lockstep_lane_engine::state() const noexcept -> cpu_state
+{
+    return cpu_.state(lane_);
+}
+
+void lockstep_lane_engine::restore_state(const cpu_state &state) noexcept
+{
+    cpu_.restore_state(lane_, state);
+}
+
+auto lockstep_lane_engine::memory() const noexcept -> const std::uint8_t *
+{
+    return cpu_.memory(lane_);
+}
+
+void lockstep_lane_engine::restore_memory(const std::uint8_t *data) noexcept
+{
+    cpu_.load(lane_, 0, data, cpu_mos6502_lockstep::memory_size);
+}
+
+auto lockstep_lane_engine::page_access(const std::uint8_t page) const noexcept -> lockstep_page_access
+{
+    return cpu_.page_access(page);
+}
+
+engine_self_check::reference_memory::reference_memory(const iexecution_engine &engine)
+    : pages_{}
+    , data_(engine.memory(), engine.memory() + page_count * page_size)
+    , written_pages_{}
+{
+    for (auto page = 0u; page < page_count; ++page)
+        pages_[page] = engine.page_access(static_cast<std::uint8_t>(page));
+}
+
+void engine_self_check::reference_memory::write(const std::uint16_t address, const std::uint8_t value) noexcept
+{
+    const auto page = address >> 8;
+
+    if (pages_[page] != lockstep_page_access::ram)
+        return;
+
+    data_[address] = value;
+    written_pages_[page >> 6] |= std::uint64_t{1} << (page & 63);
+}
+
+auto engine_self_check::reference_memory::read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t>
+{
+    return reference_memory::peek(address);
+}
+
+auto engine_self_check::reference_memory::peek(const std::uint16_t address) const noexcept
+    -> std::tuple<bool, std::uint8_t>
+{
+    if (pages_[address >> 8] == lockstep_page_access::unmapped)
+        return {false, 0};
+
+    return {true, data_[address]};
+}
+
+auto engine_self_check::reference_memory::state_size() const noexcept -> std::size_t
+{
+    return std::size(data_);
+}
+
+void engine_self_check::reference_memory::save_state(std::uint8_t *data) const noexcept
+{
+    std::memcpy(data, std::data(data_), std::size(data_));
+}
+
+void engine_self_check::reference_memory::load_state(const std::uint8_t *data) noexcept
+{
+    std::memcpy(std::data(data_), data, std::size(data_));
+}
+
+void engine_self_check::reference_memory::clear_written_pages() noexcept
+{
+    written_pages_.fill(0);
+}
+
+engine_self_check::engine_self_check(iexecution_engine &engine, const self_check_settings &settings)
+    : engine_{engine}
+    , settings_{settings}
+    , memory_{engine}
+    , bus_{}
+    , cpu_{bus_}
+    , reference_cycle_base_{}
+    , engine_cycle_base_{}
+    , executed_{}
+    , next_memory_check_{}
+    , next_checkpoint_{}
+    , next_sampled_page_{}
+    , checkpoint_reference_{cpu_}
+    , checkpoint_engine_state_{}
+    , checkpoint_engine_memory_(page_count * page_size)
+    , checkpoint_executed_{}
+{
+    settings_.register_interval = std::max<std::uint32_t>(settings_.register_interval, 1);
+    settings_.memory_interval = std::max(settings_.memory_interval, settings_.register_interval);
+    settings_.checkpoint_interval = std::max<std::uint64_t>(settings_.checkpoint_interval, settings_.memory_interval);
+
+    // The saved layout must include the memory, so the checkpoint is only set up once it is attached.
+    bus_.add(memory_);
+    checkpoint_reference_ = machine_state{cpu_};
+
+    const auto state = engine_.state();
+    cpu_.restore_state(state);
+
+    reference_cycle_base_ = bus_.cycle();
+    engine_cycle_base_ = state.cycle;
+
+    next_memory_check_ = settings_.memory_interval;
+    next_checkpoint_ = settings_.checkpoint_interval;
+    save_checkpoint();
+}
+
+auto engine_self_check::run(const std::uint64_t instructions) -> std::optional<self_check_mismatch>
+{
+    const auto end = executed_ + instructions;
+
+    while (executed_ < end && !cpu_.is_illegal_opcode_set())
+    {
+        // Every check lands exactly on its interval, no matter how the run is split into calls.
+        const auto next_register_check = (executed_ / settings_.register_interval + 1) * settings_.register_interval;
+        const auto n = std::min({next_register_check, next_memory_check_, end}) - executed_;
+        step(static_cast<std::uint32_t>(n));
+
+        auto match = registers_match();
+
+        if (match && executed_ == next_memory_check_)
+        {
+            match = sampled_memory_matches();
+            next_memory_check_ += settings_.memory_interval;
+        }
+
+        if (match && executed_ >= next_checkpoint_)
+        {
+            match = memory_matches();
+
+            if (match)
+                save_checkpoint();
+
+            next_checkpoint_ += settings_.checkpoint_interval;
+        }
+
+        if (!match)
+            return locate_mismatch();
+    }
+
+    return std::nullopt;
+}
+
+void engine_self_check::step(const std::uint32_t n) noexcept
+{
+    cpu_.step(n);
+    engine_.step(n);
+    executed_ += n;
+}
+
+auto engine_self_check::registers_match() const noexcept -> bool
+{
+    const auto expected = cpu_.state();
+    const auto actual = engine_.state();
+
+    return expected.a == actual.a && expected.x == actual.x && expected.y == actual.y && expected.sp == actual.sp &&
+           expected.pc == actual.pc && expected.status == actual.status &&
+           expected.illegal_opcode == actual.illegal_opcode &&
+           expected.cycle - reference_cycle_base_ == actual.cycle - engine_cycle_base_;
+}
+
+auto engine_self_check::sampled_memory_matches() noexcept -> bool
+{
+    const auto *expected = memory_.data();
+    const auto *actual = engine_.memory();
+
+    const auto page_matches = [expected, actual](const std::size_t page) {
+        return std::memcmp(expected + page * page_size, actual + page * page_size, page_size) == 0;
+    };
+
+    const auto &written_pages = memory_.written_pages();
+
+    for (auto page = std::size_t{0}; page < page_count; ++page)
+    {
+        if ((written_pages[page >> 6] >> (page & 63) & 1) != 0 && !page_matches(page))
+            return false;
+    }
+
+    memory_.clear_written_pages();
+
+    for (auto i = 0u; i < settings_.sampled_pages; ++i)
+    {
+        if (!page_matches(next_sampled_page_))
+            return false;
+
+        next_sampled_page_ = (next_sampled_page_ + 1) % page_count;
+    }
+
+    return true;
+}
+
+auto engine_self_check::memory_matches() const noexcept -> bool
+{
+    return std::memcmp(memory_.data(), engine_.memory(), page_count * page_size) == 0;
+}
+
+void engine_self_check::save_checkpoint()
+{
+    checkpoint_reference_.save(cpu_);
+    checkpoint_engine_state_ = engine_.state();
+    std::memcpy(std::data(checkpoint_engine_memory_), engine_.memory(), std::size(checkpoint_engine_memory_));
+    checkpoint_executed_ = executed_;
+}
+
+void engine_self_check::restore_checkpoint(const machine_state &reference, const cpu_state &engine_state,
+                                           const std::vector<std::uint8_t> &engine_memory,
+                                           const std::uint64_t executed)
+{
+    reference.restore(cpu_);
+    engine_.restore_state(engine_state);
+    engine_.restore_memory(std::data(engine_memory));
+    executed_ = executed;
+    memory_.clear_written_pages();
+}
+
+auto engine_self_check::locate_mismatch() -> self_check_mismatch
+{
+    const auto failed_at = executed_;
+
+    // Everything matched at the checkpoint. Replay in steps of register_interval with full comparisons
+    // to find the first interval that goes wrong, keeping a copy of both machines at its start.
+    restore_checkpoint(checkpoint_reference_, checkpoint_engine_state_, checkpoint_engine_memory_,
+                       checkpoint_executed_);
+
+    machine_state interval_reference{cpu_};
+    auto interval_engine_state = engine_.state();
+    auto interval_engine_memory = checkpoint_engine_memory_;
+    auto interval_executed = executed_;
+
+    while (executed_ < failed_at)
+    {
+        interval_reference.save(cpu_);
+        interval_engine_state = engine_.state();
+        std::memcpy(std::data(interval_engine_memory), engine_.memory(), std::size(interval_engine_memory));
+        interval_executed = executed_;
+
+        step(static_cast<std::uint32_t>(std::min<std::uint64_t>(settings_.register_interval, failed_at - executed_)));
+
+        if (!registers_match() || !memory_matches())
+            break;
+    }
+
+    // Then single step through that interval.
+    restore_checkpoint(interval_reference, interval_engine_state, interval_engine_memory, interval_executed);
+
+    self_check_mismatch mismatch;
+
+    do
+    {
+        mismatch.instruction = executed_;
+        mismatch.before = cpu_.state();
+        mismatch.opcode = bus_.peek(mismatch.before.pc);
+        step(1);
+    } while (executed_ < failed_at && registers_match() && memory_matches());
+
+    mismatch.expected = cpu_.state();
+    mismatch.actual = engine_.state();
+    mismatch.before.cycle -= reference_cycle_base_;
+    mismatch.expected.cycle -= reference_cycle_base_;
+    mismatch.actual.cycle -= engine_cycle_base_;
+
+    const auto *expected = memory_.data();
+    const auto *actual = engine_.memory();
+
+    for (auto address = std::size_t{0}; address < page_count * page_size; ++address)
+    {
+        if (expected[address] == actual[address])
+            continue;
+
+        if (std::size(mismatch.memory) < settings_.max_memory_differences)
+            mismatch.memory.push_back({static_cast<std::uint16_t>(address), expected[address], actual[address]});
+
+        ++mismatch.memory_difference_count;
+    }
+
+    return mismatch;
+}
+
+auto to_string(const self_check_mismatch &mismatch) -> std::string
+{
+    using aeon::common::string::int_to_hex_string;
+
+    std::string result = "Mismatch after instruction " + std::to_string(mismatch.instruction) + " at $" +
+                         int_to_hex_string(mismatch.before.pc) + " (opcode $" + int_to_hex_string(mismatch.opcode) +
+                         ")\n";
+
+    const auto add_register = [&result](const char *name, const auto expected, const auto actual) {
+        if (expected == actual)
+            return;
+
+        result += "  ";
+        result += name;
+        result += ": expected $" + int_to_hex_string(expected) + ", got $" + int_to_hex_string(actual) + '\n';
+    };
+
+    add_register("a", mismatch.expected.a, mismatch.actual.a);
+    add_register("x", mismatch.expected.x, mismatch.actual.x);
+    add_register("y", mismatch.expected.y, mismatch.actual.y);
+    add_register("sp", mismatch.expected.sp, mismatch.actual.sp);
+    add_register("pc", mismatch.expected.pc, mismatch.actual.pc);
+    add_register("status", mismatch.expected.status, mismatch.actual.status);
+
+    if (mismatch.expected.cycle != mismatch.actual.cycle)
+    {
+        result += "  cycle: expected " + std::to_string(mismatch.expected.cycle) + ", got " +
+                  std::to_string(mismatch.actual.cycle) + '\n';
+    }
+
+    if (mismatch.expected.illegal_opcode != mismatch.actual.illegal_opcode)
+        result += std::string{"  illegal opcode: expected "} + (mismatch.expected.illegal_opcode ? "yes" : "no") + '\n';
+
+    for (const auto &difference : mismatch.memory)
+    {
+        result += "  $" + int_to_hex_string(difference.address) + ": expected $" +
+                  int_to_hex_string(difference.expected) + ", got $" + int_to_hex_string(difference.actual) + '\n';
+    }
+
+    if (mismatch.memory_difference_count > std::size(mismatch.memory))
+    {
+        result += "  ... " + std::to_string(mismatch.memory_difference_count - std::size(mismatch.memory)) +
+                  " more differing addresses\n";
+    }
+
+    return result;
+}
+
+} // namespace emu6502
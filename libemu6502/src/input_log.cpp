@@ -0,0 +1,207 @@
+#include <emu6502/input_log.h>
+#include <aeon/streams/stream.h>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace emu6502
+{
+
+static constexpr std::array<std::uint8_t, 4> log_magic{'E', '6', 'I', 'L'};
+static constexpr std::size_t header_size = std::size(log_magic) + sizeof(std::uint32_t);
+
+// Tag byte, up to 10 bytes of variable-length cycle delta and the value.
+static constexpr std::size_t max_event_size = 1 + 10 + 1;
+
+static constexpr std::uint8_t tag_type_mask = 0x03;
+static constexpr int tag_source_shift = 2;
+
+static auto has_value(const input_event_type type) noexcept
+{
+    return type == input_event_type::acia_receive;
+}
+
+input_recorder::input_recorder(aeon::streams::stream &stream, const std::size_t buffer_size)
+    : stream_{stream}
+    , buffer_(std::max(buffer_size, header_size + max_event_size))
+    , used_{}
+    , previous_cycle_{}
+    , event_count_{}
+    , failed_{}
+{
+    std::memcpy(std::data(buffer_), std::data(log_magic), std::size(log_magic));
+    std::memcpy(std::data(buffer_) + std::size(log_magic), &format_version, sizeof(format_version));
+    used_ = header_size;
+}
+
+input_recorder::~input_recorder()
+{
+    flush();
+}
+
+void input_recorder::record(const input_event &event) noexcept
+{
+    assert(event.cycle >= previous_cycle_);
+    assert(event.source <= max_source);
+
+    if (std::size(buffer_) - used_ < max_event_size)
+        flush();
+
+    if (failed_)
+        return;
+
+    auto *data = std::data(buffer_) + used_;
+    *data++ = static_cast<std::uint8_t>(static_cast<std::uint8_t>(event.type) | (event.source << tag_source_shift));
+
+    auto delta = event.cycle - previous_cycle_;
+    while (delta >= 0x80)
+    {
+        *data++ = static_cast<std::uint8_t>(delta | 0x80);
+        delta >>= 7;
+    }
+    *data++ = static_cast<std::uint8_t>(delta);
+
+    if (has_value(event.type))
+        *data++ = event.value;
+
+    used_ = static_cast<std::size_t>(data - std::data(buffer_));
+    previous_cycle_ = event.cycle;
+    ++event_count_;
+}
+
+void input_recorder::flush() noexcept
+{
+    if (used_ == 0 || failed_)
+        return;
+
+    write(std::data(buffer_), used_);
+    used_ = 0;
+}
+
+void input_recorder::write(const std::uint8_t *data, const std::size_t size) noexcept
+{
+    try
+    {
+        if (stream_.write(data, size) != size)
+            failed_ = true;
+    }
+    catch (...)
+    {
+        failed_ = true;
+    }
+}
+
+input_player::input_player(aeon::streams::stream &stream, const std::size_t buffer_size)
+    : stream_{stream}
+    , buffer_(std::max(buffer_size, max_event_size))
+    , position_{}
+    , size_{}
+    , event_{}
+    , has_event_{}
+    , desynchronized_{}
+{
+    std::array<std::uint8_t, header_size> header{};
+
+    for (auto &byte : header)
+    {
+        if (!read_byte(byte))
+            throw std::runtime_error{"Input log is truncated."};
+    }
+
+    if (!std::equal(std::begin(log_magic), std::end(log_magic), std::begin(header)))
+        throw std::runtime_error{"Not an input log."};
+
+    std::uint32_t version;
+    std::memcpy(&version, std::data(header) + std::size(log_magic), sizeof(version));
+
+    if (version != input_recorder::format_version)
+        throw std::runtime_error{"Unsupported input log version."};
+
+    decode_next();
+}
+
+void input_player::pop() noexcept
+{
+    decode_next();
+}
+
+auto input_player::take(const input_event_type type, const std::uint8_t source, const std::uint64_t cycle,
+                        std::uint8_t &value) noexcept -> bool
+{
+    if (!has_event_ || event_.type != type || event_.source != source || event_.cycle > cycle)
+        return false;
+
+    if (event_.cycle < cycle)
+        desynchronized_ = true;
+
+    value = event_.value;
+    decode_next();
+    return true;
+}
+
+void input_player::skip() noexcept
+{
+    desynchronized_ = true;
+    decode_next();
+}
+
+auto input_player::read_byte(std::uint8_t &value) noexcept -> bool
+{
+    if (position_ == size_)
+    {
+        try
+        {
+            size_ = stream_.read(std::data(buffer_), std::size(buffer_));
+        }
+        catch (...)
+        {
+            size_ = 0;
+        }
+
+        position_ = 0;
+
+        if (size_ == 0)
+            return false;
+    }
+
+    value = buffer_[position_++];
+    return true;
+}
+
+void input_player::decode_next() noexcept
+{
+    const auto previous_cycle = event_.cycle;
+    has_event_ = false;
+
+    std::uint8_t tag;
+    if (!read_byte(tag))
+        return;
+
+    std::uint64_t delta = 0;
+    for (auto shift = 0;; shift += 7)
+    {
+        std::uint8_t byte;
+        if (!read_byte(byte) || shift > 63)
+            return;
+
+        delta |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+            break;
+    }
+
+    input_event event;
+    event.cycle = previous_cycle + delta;
+    event.type = static_cast<input_event_type>(tag & tag_type_mask);
+    event.source = static_cast<std::uint8_t>(tag >> tag_source_shift);
+
+    if (has_value(event.type) && !read_byte(event.value))
+        return;
+
+    event_ = event;
+    has_event_ = true;
+}
+
+} // namespace emu6502
@@ -0,0 +1,451 @@
+#include <emu6502/instruction_trace.h>
+#include <mapped_file.h>
+#include <opcode_addressing.h>
+#include <opcode_cycles.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace emu6502
+{
+
+static constexpr std::array<std::uint8_t, 4> trace_magic{'E', '6', 'I', 'T'};
+
+struct trace_file_header
+{
+    std::array<std::uint8_t, 4> magic;
+    std::uint32_t version;
+    std::uint32_t block_size;
+    std::uint32_t mode;
+    std::uint64_t block_count;
+    std::array<std::uint8_t, 40> reserved;
+};
+
+static_assert(sizeof(trace_file_header) == 64);
+
+struct trace_block_header
+{
+    std::uint64_t first_index;
+    std::uint32_t record_count;
+    std::uint32_t used;
+};
+
+static constexpr std::size_t block_header_size = sizeof(trace_block_header);
+
+// Which fields follow the opcode and operand bytes of a record.
+static constexpr std::uint8_t field_a = 0x01;
+static constexpr std::uint8_t field_x = 0x02;
+static constexpr std::uint8_t field_y = 0x04;
+static constexpr std::uint8_t field_sp = 0x08;
+static constexpr std::uint8_t field_status = 0x10;
+static constexpr std::uint8_t field_pc = 0x20;
+static constexpr std::uint8_t field_effective_address = 0x40;
+static constexpr std::uint8_t field_cycle = 0x80;
+static constexpr std::uint8_t all_fields = 0xFF;
+
+// Flags, opcode, 2 operand bytes, 5 registers, pc, effective address and a 10 byte cycle delta.
+static constexpr std::size_t max_encoded_size = 1 + 1 + 2 + 5 + 2 + 2 + 10;
+
+static constexpr std::uint32_t min_block_size = 256;
+
+template <typename T>
+static void write_pod(std::uint8_t *data, const T &value) noexcept
+{
+    std::memcpy(data, &value, sizeof(T));
+}
+
+template <typename T>
+static auto read_pod(const std::uint8_t *data) noexcept
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+static constexpr trace_record zero_record{};
+
+static auto instruction_length(const std::uint8_t opcode) noexcept
+{
+    return opcode_addressing::lengths[opcode];
+}
+
+// The effective address that follows from the operands and index registers. Only the indirect modes need
+// memory, so for those the address is always stored.
+static auto predicted_effective_address(const trace_record &record) noexcept -> std::uint16_t
+{
+    const auto operand = static_cast<std::uint16_t>(record.operand[0] | (record.operand[1] << 8));
+
+    switch (opcode_addressing::modes[record.opcode])
+    {
+        case opcode_addressing::imp:
+            return 0;
+        case opcode_addressing::imm:
+            return static_cast<std::uint16_t>(record.pc + 1);
+        case opcode_addressing::zex:
+            return static_cast<std::uint8_t>(record.operand[0] + record.x);
+        case opcode_addressing::zey:
+            return static_cast<std::uint8_t>(record.operand[0] + record.y);
+        case opcode_addressing::abx:
+            return static_cast<std::uint16_t>(operand + record.x);
+        case opcode_addressing::aby:
+            return static_cast<std::uint16_t>(operand + record.y);
+        case opcode_addressing::rel:
+            return static_cast<std::uint16_t>(record.pc + 2 + static_cast<std::int8_t>(record.operand[0]));
+        default:
+            return operand;
+    }
+}
+
+static auto encode(const trace_record &record, const trace_record &previous, const bool keyframe,
+                   std::uint8_t *out) noexcept -> std::uint8_t *
+{
+    const auto expected_pc = static_cast<std::uint16_t>(previous.pc + instruction_length(previous.opcode));
+    const auto expected_cycle = previous.cycle + opcode_cycles[previous.opcode];
+
+    std::uint8_t fields = all_fields;
+
+    if (!keyframe)
+    {
+        fields = (record.a != previous.a ? field_a : 0) | (record.x != previous.x ? field_x : 0) |
+                 (record.y != previous.y ? field_y : 0) | (record.sp != previous.sp ? field_sp : 0) |
+                 (record.status != previous.status ? field_status : 0) | (record.pc != expected_pc ? field_pc : 0) |
+                 (record.effective_address != predicted_effective_address(record) ? field_effective_address : 0) |
+                 (record.cycle != expected_cycle ? field_cycle : 0);
+    }
+
+    // Every field is written unconditionally and the output only advances past the ones that are present.
+    // The buffer always has room for a complete record, and this avoids a hard to predict branch per field.
+    *out++ = fields;
+    *out++ = record.opcode;
+    out[0] = record.operand[0];
+    out[1] = record.operand[1];
+    out += instruction_length(record.opcode) - 1;
+
+    *out = record.a;
+    out += (fields & field_a) != 0;
+    *out = record.x;
+    out += (fields & field_x) != 0;
+    *out = record.y;
+    out += (fields & field_y) != 0;
+    *out = record.sp;
+    out += (fields & field_sp) != 0;
+    *out = record.status;
+    out += (fields & field_status) != 0;
+
+    write_pod(out, record.pc);
+    out += (fields & field_pc) != 0 ? sizeof(record.pc) : 0;
+    write_pod(out, record.effective_address);
+    out += (fields & field_effective_address) != 0 ? sizeof(record.effective_address) : 0;
+
+    if (fields & field_cycle)
+    {
+        // Relative to the previous record, so it also works when the cycle counter went backwards.
+        auto delta = keyframe ? record.cycle : record.cycle - previous.cycle;
+        while (delta >= 0x80)
+        {
+            *out++ = static_cast<std::uint8_t>(delta | 0x80);
+            delta >>= 7;
+        }
+        *out++ = static_cast<std::uint8_t>(delta);
+    }
+
+    return out;
+}
+
+static auto decode(const std::uint8_t *in, const trace_record &previous, trace_record &record) noexcept
+    -> const std::uint8_t *
+{
+    const auto fields = *in++;
+
+    record.opcode = *in++;
+    record.operand = {};
+
+    const auto length = instruction_length(record.opcode);
+    if (length > 1)
+        record.operand[0] = *in++;
+    if (length > 2)
+        record.operand[1] = *in++;
+
+    record.a = (fields & field_a) ? *in++ : previous.a;
+    record.x = (fields & field_x) ? *in++ : previous.x;
+    record.y = (fields & field_y) ? *in++ : previous.y;
+    record.sp = (fields & field_sp) ? *in++ : previous.sp;
+    record.status = (fields & field_status) ? *in++ : previous.status;
+
+    if (fields & field_pc)
+    {
+        record.pc = read_pod<std::uint16_t>(in);
+        in += sizeof(record.pc);
+    }
+    else
+    {
+        record.pc = static_cast<std::uint16_t>(previous.pc + instruction_length(previous.opcode));
+    }
+
+    if (fields & field_effective_address)
+    {
+        record.effective_address = read_pod<std::uint16_t>(in);
+        in += sizeof(record.effective_address);
+    }
+    else
+    {
+        record.effective_address = predicted_effective_address(record);
+    }
+
+    if (fields & field_cycle)
+    {
+        std::uint64_t delta = 0;
+        for (auto shift = 0; shift < 64; shift += 7)
+        {
+            const auto byte = *in++;
+            delta |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0)
+                break;
+        }
+
+        // A keyframe is decoded against an all-zero previous record, which turns the delta into the cycle.
+        record.cycle = previous.cycle + delta;
+    }
+    else
+    {
+        record.cycle = previous.cycle + opcode_cycles[previous.opcode];
+    }
+
+    return in;
+}
+
+instruction_trace_writer::instruction_trace_writer(const std::filesystem::path &path,
+                                                   const trace_writer_settings &settings)
+    : file_{}
+    , settings_{settings}
+    , block_count_{std::max<std::uint64_t>(settings.block_count, 1)}
+    , block_{}
+    , block_begin_{nullptr}
+    , block_used_{}
+    , block_records_{}
+    , block_first_index_{}
+    , next_index_{}
+    , previous_{}
+    , failed_{}
+{
+    if (settings_.block_size < min_block_size)
+        throw std::invalid_argument{"Trace block size is too small."};
+
+    file_ = std::make_unique<mapped_file>(path, mapped_file::access::read_write);
+
+    // Start from an all-zero file, so no block of an earlier trace is left behind.
+    if (!file_->resize(0) || !file_->resize(sizeof(trace_file_header) + block_count_ * settings_.block_size))
+        throw std::runtime_error{"Could not resize " + path.string() + "."};
+
+    write_file_header();
+    begin_block(0);
+}
+
+instruction_trace_writer::~instruction_trace_writer()
+{
+    write_block_header();
+
+    // An append file is cut back to the blocks that were used.
+    if (settings_.mode == trace_file_mode::append && !failed_)
+    {
+        block_count_ = block_ + 1;
+        write_file_header();
+        file_->resize(sizeof(trace_file_header) + block_count_ * settings_.block_size);
+    }
+}
+
+void instruction_trace_writer::append(const trace_record &record) noexcept
+{
+    if (block_used_ + max_encoded_size > settings_.block_size)
+        next_block();
+
+    if (failed_)
+        return;
+
+    auto *const begin = block_begin_ + block_used_;
+    const auto keyframe = block_records_ == 0;
+    auto *const end = encode(record, keyframe ? zero_record : previous_, keyframe, begin);
+
+    block_used_ += static_cast<std::size_t>(end - begin);
+    ++block_records_;
+    ++next_index_;
+    previous_ = record;
+}
+
+void instruction_trace_writer::flush() noexcept
+{
+    if (!failed_)
+        write_block_header();
+}
+
+auto instruction_trace_writer::block_data(const std::uint64_t block) const noexcept -> std::uint8_t *
+{
+    return file_->data() + sizeof(trace_file_header) + block * settings_.block_size;
+}
+
+void instruction_trace_writer::begin_block(const std::uint64_t block) noexcept
+{
+    block_ = block;
+    block_begin_ = block_data(block);
+    block_used_ = block_header_size;
+    block_records_ = 0;
+    block_first_index_ = next_index_;
+
+    // A reused ring block must not look like it still holds the old records.
+    write_block_header();
+}
+
+void instruction_trace_writer::next_block() noexcept
+{
+    if (failed_)
+        return;
+
+    write_block_header();
+
+    auto block = block_ + 1;
+
+    if (block == block_count_)
+    {
+        if (settings_.mode == trace_file_mode::ring)
+        {
+            block = 0;
+        }
+        else
+        {
+            const auto count = block_count_ + std::max<std::uint64_t>(settings_.block_count, 1);
+
+            if (!file_->resize(sizeof(trace_file_header) + count * settings_.block_size))
+            {
+                failed_ = true;
+                return;
+            }
+
+            block_count_ = count;
+            write_file_header();
+        }
+    }
+
+    begin_block(block);
+}
+
+void instruction_trace_writer::write_block_header() noexcept
+{
+    const trace_block_header header{block_first_index_, block_records_, static_cast<std::uint32_t>(block_used_)};
+    write_pod(block_data(block_), header);
+}
+
+void instruction_trace_writer::write_file_header() noexcept
+{
+    trace_file_header header{};
+    header.magic = trace_magic;
+    header.version = format_version;
+    header.block_size = settings_.block_size;
+    header.mode = static_cast<std::uint32_t>(settings_.mode);
+    header.block_count = block_count_;
+    write_pod(file_->data(), header);
+}
+
+instruction_trace_reader::instruction_trace_reader(const std::filesystem::path &path)
+    : file_{std::make_unique<mapped_file>(path, mapped_file::access::read)}
+    , blocks_{}
+    , first_index_{}
+    , record_count_{}
+{
+    if (file_->size() < sizeof(trace_file_header))
+        throw std::runtime_error{"Not a trace file."};
+
+    const auto header = read_pod<trace_file_header>(file_->data());
+
+    if (header.magic != trace_magic)
+        throw std::runtime_error{"Not a trace file."};
+
+    if (header.version != instruction_trace_writer::format_version)
+        throw std::runtime_error{"Unsupported trace file version."};
+
+    if (header.block_size < min_block_size ||
+        header.block_count > (file_->size() - sizeof(trace_file_header)) / header.block_size)
+        throw std::runtime_error{"Trace file is truncated."};
+
+    for (auto i = std::uint64_t{0}; i < header.block_count; ++i)
+    {
+        const auto *data = file_->data() + sizeof(trace_file_header) + i * header.block_size;
+        const auto block_header = read_pod<trace_block_header>(data);
+
+        if (block_header.record_count == 0)
+            continue;
+
+        if (block_header.used > header.block_size)
+            throw std::runtime_error{"Trace file is corrupt."};
+
+        blocks_.push_back({block_header.first_index, block_header.record_count, block_header.used, data});
+    }
+
+    std::sort(std::begin(blocks_), std::end(blocks_),
+              [](const auto &lhs, const auto &rhs) { return lhs.first_index < rhs.first_index; });
+
+    // In a ring file the oldest blocks may have been overwritten; only the newest consecutive run counts.
+    if (!std::empty(blocks_))
+    {
+        auto first = std::size(blocks_) - 1;
+        while (first > 0 && blocks_[first - 1].first_index + blocks_[first - 1].record_count == blocks_[first].first_index)
+            --first;
+
+        blocks_.erase(std::begin(blocks_), std::begin(blocks_) + static_cast<std::ptrdiff_t>(first));
+
+        first_index_ = blocks_.front().first_index;
+        record_count_ = blocks_.back().first_index + blocks_.back().record_count - first_index_;
+    }
+}
+
+instruction_trace_reader::~instruction_trace_reader() = default;
+
+auto instruction_trace_reader::read(const std::uint64_t index) const -> trace_record
+{
+    trace_record record;
+
+    if (read(index, &record, 1) != 1)
+        throw std::out_of_range{"Trace record index out of range."};
+
+    return record;
+}
+
+auto instruction_trace_reader::read(const std::uint64_t index, trace_record *records, const std::size_t count) const
+    noexcept -> std::size_t
+{
+    if (index < first_index_ || index >= first_index_ + record_count_)
+        return 0;
+
+    auto current_block =
+        std::upper_bound(std::begin(blocks_), std::end(blocks_), index,
+                         [](const auto value, const auto &entry) { return value < entry.first_index; });
+    --current_block;
+
+    auto skip = index - current_block->first_index;
+    auto read = std::size_t{0};
+
+    for (; current_block != std::end(blocks_) && read < count; ++current_block)
+    {
+        const auto *in = current_block->data + block_header_size;
+        trace_record previous = zero_record;
+
+        for (auto i = 0u; i < current_block->record_count && read < count; ++i)
+        {
+            trace_record record;
+            in = decode(in, previous, record);
+            previous = record;
+
+            if (skip > 0)
+            {
+                --skip;
+                continue;
+            }
+
+            records[read++] = record;
+        }
+    }
+
+    return read;
+}
+
+} // namespace emu6502
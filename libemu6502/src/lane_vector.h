@@ -0,0 +1,221 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EMU6502_LANE_VECTOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace emu6502
+{
+
+inline constexpr std::size_t lane_vector_width = 16;
+
+/*!
+ * 16 unsigned bytes processed together; one byte per emulated CPU.
+ *
+ * Masks are vectors where every byte is either 0x00 or 0xFF. Without SSE2 the same operations are
+ * done with plain loops, so the lockstep interpreter still runs everywhere.
+ */
+struct lane_vector
+{
+#if defined(EMU6502_LANE_VECTOR_SSE2)
+    __m128i value;
+
+    static auto load(const std::uint8_t *data) noexcept
+    {
+        return lane_vector{_mm_load_si128(reinterpret_cast<const __m128i *>(data))};
+    }
+
+    void store(std::uint8_t *data) const noexcept
+    {
+        _mm_store_si128(reinterpret_cast<__m128i *>(data), value);
+    }
+
+    static auto splat(const std::uint8_t byte) noexcept
+    {
+        return lane_vector{_mm_set1_epi8(static_cast<char>(byte))};
+    }
+#else
+    alignas(16) std::array<std::uint8_t, lane_vector_width> value;
+
+    static auto load(const std::uint8_t *data) noexcept
+    {
+        lane_vector result;
+        for (auto i = 0u; i < lane_vector_width; ++i)
+            result.value[i] = data[i];
+        return result;
+    }
+
+    void store(std::uint8_t *data) const noexcept
+    {
+        for (auto i = 0u; i < lane_vector_width; ++i)
+            data[i] = value[i];
+    }
+
+    static auto splat(const std::uint8_t byte) noexcept
+    {
+        lane_vector result;
+        result.value.fill(byte);
+        return result;
+    }
+#endif
+};
+
+#if defined(EMU6502_LANE_VECTOR_SSE2)
+
+inline auto operator&(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector{_mm_and_si128(a.value, b.value)};
+}
+
+inline auto operator|(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector{_mm_or_si128(a.value, b.value)};
+}
+
+inline auto operator^(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector{_mm_xor_si128(a.value, b.value)};
+}
+
+inline auto operator~(const lane_vector a) noexcept
+{
+    return lane_vector{_mm_xor_si128(a.value, _mm_set1_epi8(-1))};
+}
+
+inline auto operator+(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector{_mm_add_epi8(a.value, b.value)};
+}
+
+inline auto operator-(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector{_mm_sub_epi8(a.value, b.value)};
+}
+
+// Every byte is 0xFF where a == b.
+inline auto equal(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector{_mm_cmpeq_epi8(a.value, b.value)};
+}
+
+// Every byte is 0xFF where a > b, comparing unsigned.
+inline auto greater(const lane_vector a, const lane_vector b) noexcept
+{
+    const auto bias = _mm_set1_epi8(static_cast<char>(0x80));
+    return lane_vector{_mm_cmpgt_epi8(_mm_xor_si128(a.value, bias), _mm_xor_si128(b.value, bias))};
+}
+
+inline auto shift_left_1(const lane_vector a) noexcept
+{
+    return lane_vector{_mm_add_epi8(a.value, a.value)};
+}
+
+inline auto shift_right_1(const lane_vector a) noexcept
+{
+    return lane_vector{_mm_and_si128(_mm_srli_epi16(a.value, 1), _mm_set1_epi8(0x7F))};
+}
+
+// Picks a where the mask is set and b everywhere else.
+inline auto select(const lane_vector mask, const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector{_mm_or_si128(_mm_and_si128(mask.value, a.value), _mm_andnot_si128(mask.value, b.value))};
+}
+
+#else
+
+template <typename func_t>
+inline auto lane_vector_apply(const lane_vector a, const lane_vector b, func_t func) noexcept
+{
+    lane_vector result;
+    for (auto i = 0u; i < lane_vector_width; ++i)
+        result.value[i] = static_cast<std::uint8_t>(func(a.value[i], b.value[i]));
+    return result;
+}
+
+inline auto operator&(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector_apply(a, b, [](const auto x, const auto y) { return x & y; });
+}
+
+inline auto operator|(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector_apply(a, b, [](const auto x, const auto y) { return x | y; });
+}
+
+inline auto operator^(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector_apply(a, b, [](const auto x, const auto y) { return x ^ y; });
+}
+
+inline auto operator~(const lane_vector a) noexcept
+{
+    return lane_vector_apply(a, a, [](const auto x, const auto) { return ~x; });
+}
+
+inline auto operator+(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector_apply(a, b, [](const auto x, const auto y) { return x + y; });
+}
+
+inline auto operator-(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector_apply(a, b, [](const auto x, const auto y) { return x - y; });
+}
+
+inline auto equal(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector_apply(a, b, [](const auto x, const auto y) { return x == y ? 0xFF : 0x00; });
+}
+
+inline auto greater(const lane_vector a, const lane_vector b) noexcept
+{
+    return lane_vector_apply(a, b, [](const auto x, const auto y) { return x > y ? 0xFF : 0x00; });
+}
+
+inline auto shift_left_1(const lane_vector a) noexcept
+{
+    return lane_vector_apply(a, a, [](const auto x, const auto) { return x << 1; });
+}
+
+inline auto shift_right_1(const lane_vector a) noexcept
+{
+    return lane_vector_apply(a, a, [](const auto x, const auto) { return x >> 1; });
+}
+
+inline auto select(const lane_vector mask, const lane_vector a, const lane_vector b) noexcept
+{
+    return (mask & a) | (~mask & b);
+}
+
+#endif
+
+// One bit per lane, set where the mask is set.
+inline auto lane_bits(const lane_vector mask) noexcept -> std::uint32_t
+{
+#if defined(EMU6502_LANE_VECTOR_SSE2)
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(mask.value));
+#else
+    std::uint32_t bits = 0;
+    for (auto i = 0u; i < lane_vector_width; ++i)
+        bits |= (mask.value[i] & 0x80u) ? (1u << i) : 0u;
+    return bits;
+#endif
+}
+
+// Every byte is 0xFF where (a & bits) != 0.
+inline auto any_set(const lane_vector a, const std::uint8_t bits) noexcept
+{
+    return ~equal(a & lane_vector::splat(bits), lane_vector::splat(0));
+}
+
+// Turns a mask into a single bit per byte, so it can be combined with plain flag constants.
+inline auto to_bits(const lane_vector mask, const std::uint8_t bits) noexcept
+{
+    return mask & lane_vector::splat(bits);
+}
+
+} // namespace emu6502
@@ -0,0 +1,524 @@
+#include <emu6502/machine_runner.h>
+#include <emu6502/bus.h>
+#include <algorithm>
+#include <limits>
+
+namespace emu6502
+{
+
+static constexpr std::size_t command_queue_capacity = 256;
+static constexpr std::size_t event_queue_capacity = 256;
+
+// Number of instructions executed between checks of the command queue.
+static constexpr std::uint64_t batch_size = 4096;
+
+static constexpr std::uint64_t run_forever = std::numeric_limits<std::uint64_t>::max();
+
+static constexpr std::chrono::milliseconds snapshot_interval{1};
+
+// Memory views refresh at display rate, so copying memory more often would only cost emulation time.
+static constexpr std::chrono::milliseconds memory_interval{16};
+
+static constexpr std::uint16_t stack_page = 0x0100;
+
+// The longest instruction plus an interrupt taken right after it. Stepping (distance / this) instructions
+// can never pass a cycle that is that distance away.
+static constexpr std::uint64_t max_cycles_per_step = 7 + 7;
+
+machine_runner::machine_runner(cpu_mos6502 &cpu, machine_event_notify_func notify_func)
+    : cpu_{cpu}
+    , commands_{command_queue_capacity}
+    , events_{event_queue_capacity}
+    , notify_func_{std::move(notify_func)}
+    , notify_pending_{false}
+    , snapshot_{}
+    , last_snapshot_time_{}
+    , memory_{}
+    , last_memory_time_{}
+    , accesses_{std::make_unique<access_counters>()}
+    , breakpoints_{}
+    , breakpoint_count_{0}
+    , skip_breakpoint_{false}
+    , steps_remaining_{0}
+    , input_recorder_{nullptr}
+    , input_player_{nullptr}
+    , memory_watchers_{0}
+    , access_watchers_{0}
+    , running_{false}
+    , quit_{false}
+    , wake_mutex_{}
+    , wake_{}
+    , thread_{}
+{
+}
+
+machine_runner::~machine_runner()
+{
+    shutdown();
+}
+
+void machine_runner::start()
+{
+    if (thread_.joinable())
+        return;
+
+    quit_ = false;
+    publish_snapshot();
+    thread_ = std::thread{[this]() { thread_main(); }};
+}
+
+void machine_runner::shutdown()
+{
+    if (!thread_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock{wake_mutex_};
+        quit_ = true;
+    }
+
+    wake_.notify_one();
+    thread_.join();
+}
+
+auto machine_runner::send(const machine_command command) -> bool
+{
+    if (!commands_.push(command))
+        return false;
+
+    // Taking the lock orders the push before the runner's check for an empty queue, so a
+    // runner that is about to go to sleep can't miss the command.
+    {
+        std::lock_guard<std::mutex> lock{wake_mutex_};
+    }
+
+    wake_.notify_one();
+    return true;
+}
+
+auto machine_runner::run() -> bool
+{
+    return send({machine_command_type::run});
+}
+
+auto machine_runner::stop() -> bool
+{
+    return send({machine_command_type::stop});
+}
+
+auto machine_runner::step(const std::uint32_t count) -> bool
+{
+    return send({machine_command_type::step, count});
+}
+
+auto machine_runner::reset() -> bool
+{
+    return send({machine_command_type::reset});
+}
+
+auto machine_runner::irq() -> bool
+{
+    return send({machine_command_type::irq});
+}
+
+auto machine_runner::nmi() -> bool
+{
+    return send({machine_command_type::nmi});
+}
+
+auto machine_runner::add_breakpoint(const std::uint16_t address) -> bool
+{
+    return send({machine_command_type::add_breakpoint, address});
+}
+
+auto machine_runner::remove_breakpoint(const std::uint16_t address) -> bool
+{
+    return send({machine_command_type::remove_breakpoint, address});
+}
+
+auto machine_runner::clear_breakpoints() -> bool
+{
+    return send({machine_command_type::clear_breakpoints});
+}
+
+auto machine_runner::watch_memory() -> bool
+{
+    return send({machine_command_type::watch_memory});
+}
+
+auto machine_runner::unwatch_memory() -> bool
+{
+    return send({machine_command_type::unwatch_memory});
+}
+
+auto machine_runner::watch_accesses() -> bool
+{
+    return send({machine_command_type::watch_accesses});
+}
+
+auto machine_runner::unwatch_accesses() -> bool
+{
+    return send({machine_command_type::unwatch_accesses});
+}
+
+void machine_runner::set_input_recorder(input_recorder *recorder) noexcept
+{
+    input_recorder_ = recorder;
+}
+
+void machine_runner::set_input_player(input_player *player) noexcept
+{
+    input_player_ = player;
+}
+
+auto machine_runner::poll_event(machine_event &event) noexcept -> bool
+{
+    notify_pending_.store(false);
+    return events_.pop(event);
+}
+
+auto machine_runner::discard_events() noexcept -> std::size_t
+{
+    std::size_t count = 0;
+    machine_event event;
+
+    while (poll_event(event))
+        ++count;
+
+    return count;
+}
+
+auto machine_runner::is_running() const noexcept -> bool
+{
+    return running_.load(std::memory_order_relaxed);
+}
+
+auto machine_runner::snapshot() const noexcept -> machine_snapshot
+{
+    return snapshot_.load();
+}
+
+auto machine_runner::snapshot_version() const noexcept -> std::uint32_t
+{
+    return snapshot_.version();
+}
+
+void machine_runner::thread_main()
+{
+    while (!quit_)
+    {
+        machine_command command;
+        while (commands_.pop(command))
+            execute(command);
+
+        if (steps_remaining_ != 0)
+        {
+            execute_batch();
+            continue;
+        }
+
+        if (input_recorder_)
+            input_recorder_->flush();
+
+        std::unique_lock<std::mutex> lock{wake_mutex_};
+        wake_.wait(lock, [this]() { return quit_ || !commands_.empty(); });
+    }
+
+    if (input_recorder_)
+        input_recorder_->flush();
+}
+
+void machine_runner::execute(const machine_command &command)
+{
+    switch (command.type)
+    {
+        case machine_command_type::run:
+        {
+            if (steps_remaining_ == run_forever)
+                break;
+
+            skip_breakpoint_ = true;
+            set_steps_remaining(run_forever);
+            publish(machine_event_type::started);
+            break;
+        }
+        case machine_command_type::stop:
+        {
+            if (steps_remaining_ == 0)
+                break;
+
+            set_steps_remaining(0);
+            publish(machine_event_type::stopped);
+            break;
+        }
+        case machine_command_type::step:
+        {
+            if (steps_remaining_ != 0 || command.argument == 0)
+                break;
+
+            skip_breakpoint_ = true;
+            set_steps_remaining(command.argument);
+            break;
+        }
+        case machine_command_type::reset:
+        {
+            // While replaying, these come from the log instead.
+            if (input_player_)
+                break;
+
+            record_input(input_event_type::reset);
+            cpu_.reset();
+            publish(machine_event_type::reset);
+            break;
+        }
+        case machine_command_type::irq:
+        {
+            if (input_player_)
+                break;
+
+            record_input(input_event_type::irq);
+            cpu_.trigger_irq();
+            break;
+        }
+        case machine_command_type::nmi:
+        {
+            if (input_player_)
+                break;
+
+            record_input(input_event_type::nmi);
+            cpu_.trigger_nmi();
+            break;
+        }
+        case machine_command_type::add_breakpoint:
+        {
+            const auto address = static_cast<std::uint16_t>(command.argument);
+
+            if (!breakpoints_.test(address))
+            {
+                breakpoints_.set(address);
+                ++breakpoint_count_;
+            }
+            break;
+        }
+        case machine_command_type::remove_breakpoint:
+        {
+            const auto address = static_cast<std::uint16_t>(command.argument);
+
+            if (breakpoints_.test(address))
+            {
+                breakpoints_.reset(address);
+                --breakpoint_count_;
+            }
+            break;
+        }
+        case machine_command_type::clear_breakpoints:
+        {
+            breakpoints_.reset();
+            breakpoint_count_ = 0;
+            break;
+        }
+        case machine_command_type::watch_memory:
+        {
+            if (memory_watchers_++ != 0)
+                break;
+
+            // Pages written while nobody was watching are not known, so everything is copied once.
+            auto &bus = cpu_.get_bus();
+            bus.take_written_pages();
+            memory_.update_all(bus);
+            last_memory_time_ = std::chrono::steady_clock::now();
+            break;
+        }
+        case machine_command_type::unwatch_memory:
+        {
+            if (memory_watchers_ != 0)
+                --memory_watchers_;
+            break;
+        }
+        case machine_command_type::watch_accesses:
+        {
+            if (access_watchers_++ == 0)
+                cpu_.get_bus().set_access_counters(accesses_.get());
+            break;
+        }
+        case machine_command_type::unwatch_accesses:
+        {
+            if (access_watchers_ != 0 && --access_watchers_ == 0)
+                cpu_.get_bus().set_access_counters(nullptr);
+            break;
+        }
+    }
+}
+
+void machine_runner::execute_batch()
+{
+    auto count = std::min(steps_remaining_, batch_size);
+
+    if (input_player_)
+    {
+        replay_inputs();
+        count = std::min(count, steps_until_next_input());
+    }
+
+    if (breakpoint_count_ == 0)
+    {
+        cpu_.step(static_cast<std::uint32_t>(count));
+    }
+    else
+    {
+        for (auto i = 0ull; i < count; ++i)
+        {
+            if (!skip_breakpoint_ && breakpoints_.test(cpu_.pc()))
+            {
+                set_steps_remaining(0);
+                publish(machine_event_type::breakpoint_hit);
+                return;
+            }
+
+            skip_breakpoint_ = false;
+            cpu_.step(1);
+
+            if (cpu_.is_illegal_opcode_set())
+                break;
+        }
+    }
+
+    skip_breakpoint_ = false;
+
+    if (cpu_.is_illegal_opcode_set())
+    {
+        set_steps_remaining(0);
+        publish(machine_event_type::illegal_opcode);
+        return;
+    }
+
+    if (steps_remaining_ == run_forever)
+    {
+        const auto now = std::chrono::steady_clock::now();
+
+        if (now - last_snapshot_time_ >= snapshot_interval)
+            publish_snapshot();
+
+        if (memory_watchers_ != 0 && now - last_memory_time_ >= memory_interval)
+            publish_memory();
+
+        return;
+    }
+
+    set_steps_remaining(steps_remaining_ - count);
+
+    if (steps_remaining_ == 0)
+        publish(machine_event_type::step_completed);
+}
+
+void machine_runner::record_input(const input_event_type type) noexcept
+{
+    if (input_recorder_)
+        input_recorder_->record({cpu_.get_bus().cycle(), type});
+}
+
+void machine_runner::replay_inputs() noexcept
+{
+    while (const auto *event = input_player_->peek())
+    {
+        const auto cycle = cpu_.get_bus().cycle();
+
+        if (event->cycle > cycle)
+            return;
+
+        const auto type = event->type;
+
+        if (type == input_event_type::acia_receive)
+        {
+            // The device takes it during the next instruction. One that is already late can't be delivered.
+            if (event->cycle == cycle)
+                return;
+
+            input_player_->skip();
+            continue;
+        }
+
+        std::uint8_t value;
+        input_player_->take(type, event->source, cycle, value);
+
+        switch (type)
+        {
+            case input_event_type::reset:
+            {
+                cpu_.reset();
+                publish(machine_event_type::reset);
+                break;
+            }
+            case input_event_type::irq:
+            {
+                cpu_.trigger_irq();
+                break;
+            }
+            case input_event_type::nmi:
+            {
+                cpu_.trigger_nmi();
+                break;
+            }
+            default:;
+        }
+    }
+}
+
+auto machine_runner::steps_until_next_input() const noexcept -> std::uint64_t
+{
+    const auto *event = input_player_->peek();
+
+    if (!event)
+        return run_forever;
+
+    const auto cycle = cpu_.get_bus().cycle();
+
+    if (event->cycle <= cycle)
+        return 1;
+
+    return std::max<std::uint64_t>((event->cycle - cycle) / max_cycles_per_step, 1);
+}
+
+void machine_runner::set_steps_remaining(const std::uint64_t steps) noexcept
+{
+    steps_remaining_ = steps;
+    running_.store(steps != 0, std::memory_order_relaxed);
+}
+
+void machine_runner::publish(const machine_event_type type) noexcept
+{
+    publish_snapshot();
+
+    if (memory_watchers_ != 0)
+        publish_memory();
+
+    // Never wait for the consumer. A full queue means it is far behind and will resync on the next event.
+    events_.push({type, cpu_.state()});
+
+    if (!notify_pending_.exchange(true) && notify_func_)
+        notify_func_();
+}
+
+void machine_runner::publish_snapshot() noexcept
+{
+    machine_snapshot snapshot;
+    snapshot.state = cpu_.state();
+    snapshot.running = steps_remaining_ != 0;
+
+    // Peeking, so displaying the stack never changes the state of a device mapped there.
+    const auto &bus = cpu_.get_bus();
+    for (auto i = 0u; i < std::size(snapshot.stack); ++i)
+        snapshot.stack[i] = bus.peek(static_cast<std::uint16_t>(stack_page + i));
+
+    snapshot_.store(snapshot);
+    last_snapshot_time_ = std::chrono::steady_clock::now();
+}
+
+void machine_runner::publish_memory() noexcept
+{
+    auto &bus = cpu_.get_bus();
+    memory_.update(bus, bus.take_written_pages());
+    last_memory_time_ = std::chrono::steady_clock::now();
+}
+
+} // namespace emu6502
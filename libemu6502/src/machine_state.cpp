@@ -0,0 +1,229 @@
+#include <emu6502/machine_state.h>
+#include <emu6502/bus.h>
+#include <emu6502/ibus_device.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace emu6502
+{
+
+static constexpr std::array<char, 4> state_magic{'E', '6', 'M', 'S'};
+
+struct state_header
+{
+    std::array<char, 4> magic;
+    std::uint32_t version;
+    std::uint64_t size;
+    std::uint32_t device_count;
+    std::uint32_t reserved;
+};
+
+struct state_bus
+{
+    std::uint64_t cycle;
+    std::uint32_t event_count;
+    std::uint32_t reserved;
+};
+
+struct state_clock_event
+{
+    std::uint64_t cycle;
+    std::uint32_t device_index;
+    std::uint32_t reserved;
+};
+
+static auto align(const std::size_t offset) noexcept
+{
+    return (offset + 7) & ~std::size_t{7};
+}
+
+template <typename T>
+static void write_pod(std::uint8_t *data, const T &value) noexcept
+{
+    std::memcpy(data, &value, sizeof(T));
+}
+
+template <typename T>
+static auto read_pod(const std::uint8_t *data) noexcept
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+machine_state::machine_state(const cpu_mos6502 &cpu)
+    : cpu_offset_{}
+    , bus_offset_{}
+    , device_table_offset_{}
+    , device_offsets_{}
+    , buffer_{}
+{
+    const auto &devices = cpu.get_bus().devices();
+    const auto device_count = std::size(devices);
+
+    auto offset = align(sizeof(state_header));
+    cpu_offset_ = offset;
+    offset = align(offset + sizeof(cpu_state));
+
+    bus_offset_ = offset;
+    offset = align(offset + sizeof(state_bus) + device_count * sizeof(state_clock_event));
+
+    device_table_offset_ = offset;
+    offset = align(offset + device_count * sizeof(std::uint64_t));
+
+    device_offsets_.reserve(device_count);
+    for (const auto device : devices)
+    {
+        device_offsets_.push_back(offset);
+        offset = align(offset + device->state_size());
+    }
+
+    buffer_.resize(offset);
+
+    state_header header{};
+    header.magic = state_magic;
+    header.version = format_version;
+    header.size = offset;
+    header.device_count = static_cast<std::uint32_t>(device_count);
+    write_pod(std::data(buffer_), header);
+
+    for (auto i = 0u; i < device_count; ++i)
+    {
+        const std::uint64_t size = devices[i]->state_size();
+        write_pod(std::data(buffer_) + device_table_offset_ + i * sizeof(std::uint64_t), size);
+    }
+}
+
+void machine_state::save(const cpu_mos6502 &cpu) noexcept
+{
+    const auto &bus = cpu.get_bus();
+    const auto &devices = bus.devices();
+    const auto data = std::data(buffer_);
+
+    write_pod(data + cpu_offset_, cpu.state());
+
+    state_bus bus_state{};
+    bus_state.cycle = bus.cycle_;
+    bus_state.event_count = static_cast<std::uint32_t>(std::size(bus.clock_events_));
+    write_pod(data + bus_offset_, bus_state);
+
+    auto event_data = data + bus_offset_ + sizeof(state_bus);
+    for (const auto &event : bus.clock_events_)
+    {
+        const auto result = std::find(std::begin(devices), std::end(devices), event.device);
+
+        state_clock_event event_state{};
+        event_state.cycle = event.cycle;
+        event_state.device_index = static_cast<std::uint32_t>(std::distance(std::begin(devices), result));
+        write_pod(event_data, event_state);
+        event_data += sizeof(state_clock_event);
+    }
+
+    for (auto i = 0u; i < std::size(devices); ++i)
+        devices[i]->save_state(data + device_offsets_[i]);
+}
+
+void machine_state::restore(cpu_mos6502 &cpu) const
+{
+    validate(cpu);
+
+    auto &bus = cpu.get_bus();
+    const auto &devices = bus.devices();
+    const auto data = std::data(buffer_);
+
+    cpu.restore_state(read_pod<cpu_state>(data + cpu_offset_));
+
+    const auto bus_state = read_pod<state_bus>(data + bus_offset_);
+    bus.cycle_ = bus_state.cycle;
+    bus.clock_events_.clear();
+
+    auto event_data = data + bus_offset_ + sizeof(state_bus);
+    for (auto i = 0u; i < bus_state.event_count; ++i)
+    {
+        const auto event_state = read_pod<state_clock_event>(event_data);
+        bus.clock_events_.push_back({event_state.cycle, devices[event_state.device_index]});
+        event_data += sizeof(state_clock_event);
+    }
+
+    bus.update_next_event_cycle();
+
+    for (auto i = 0u; i < std::size(devices); ++i)
+        devices[i]->load_state(data + device_offsets_[i]);
+}
+
+void machine_state::assign(const std::uint8_t *data, const std::size_t size)
+{
+    if (size != std::size(buffer_))
+        throw std::runtime_error{"Machine state size does not match."};
+
+    const auto header = read_pod<state_header>(data);
+
+    if (header.magic != state_magic)
+        throw std::runtime_error{"Not a machine state."};
+
+    if (header.version != format_version)
+        throw std::runtime_error{"Unsupported machine state version."};
+
+    if (header.size != size)
+        throw std::runtime_error{"Machine state size does not match."};
+
+    validate_sections(data);
+    std::memcpy(std::data(buffer_), data, size);
+}
+
+void machine_state::validate_sections(const std::uint8_t *data) const
+{
+    const auto header = read_pod<state_header>(data);
+    const auto device_count = std::size(device_offsets_);
+
+    if (header.device_count != device_count)
+        throw std::runtime_error{"Machine state was saved from a machine with different devices."};
+
+    // Every device section has to end where the layout of this machine puts the next one.
+    for (auto i = 0u; i < device_count; ++i)
+    {
+        const auto size = read_pod<std::uint64_t>(data + device_table_offset_ + i * sizeof(std::uint64_t));
+        const auto end = i + 1 < device_count ? device_offsets_[i + 1] : std::size(buffer_);
+
+        if (size > end - device_offsets_[i] || align(device_offsets_[i] + size) != end)
+            throw std::runtime_error{"Machine state device section does not fit the machine state."};
+    }
+
+    // The bus section has room for one clock event per device.
+    const auto bus_state = read_pod<state_bus>(data + bus_offset_);
+
+    if (bus_state.event_count > device_count)
+        throw std::runtime_error{"Machine state has more clock events than devices."};
+
+    auto event_data = data + bus_offset_ + sizeof(state_bus);
+    for (auto i = 0u; i < bus_state.event_count; ++i)
+    {
+        if (read_pod<state_clock_event>(event_data).device_index >= device_count)
+            throw std::runtime_error{"Machine state has a clock event for an unknown device."};
+
+        event_data += sizeof(state_clock_event);
+    }
+}
+
+void machine_state::validate(const cpu_mos6502 &cpu) const
+{
+    const auto &devices = cpu.get_bus().devices();
+
+    if (std::size(device_offsets_) != std::size(devices))
+        throw std::runtime_error{"Machine state was saved from a machine with different devices."};
+
+    validate_sections(std::data(buffer_));
+
+    for (auto i = 0u; i < std::size(devices); ++i)
+    {
+        const auto size =
+            read_pod<std::uint64_t>(std::data(buffer_) + device_table_offset_ + i * sizeof(std::uint64_t));
+
+        if (size != devices[i]->state_size())
+            throw std::runtime_error{"Machine state was saved from a machine with different devices."};
+    }
+}
+
+} // namespace emu6502
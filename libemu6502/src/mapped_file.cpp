@@ -0,0 +1,187 @@
+#include <mapped_file.h>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace emu6502
+{
+
+#if defined(_WIN32)
+
+mapped_file::mapped_file(const std::filesystem::path &path, const access mode, const std::size_t create_size)
+    : mode_{mode}
+    , data_{nullptr}
+    , size_{}
+    , file_{INVALID_HANDLE_VALUE}
+    , mapping_{nullptr}
+{
+    const auto writable = mode == access::read_write;
+    file_ = CreateFileW(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file_ == INVALID_HANDLE_VALUE)
+        throw std::runtime_error{"Could not open " + path.string() + "."};
+
+    LARGE_INTEGER file_size{};
+    GetFileSizeEx(file_, &file_size);
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+
+    if (writable && size_ == 0 && create_size != 0 && !resize(create_size))
+    {
+        CloseHandle(file_);
+        throw std::runtime_error{"Could not resize " + path.string() + "."};
+    }
+
+    if (!data_ && size_ != 0 && !map())
+    {
+        CloseHandle(file_);
+        throw std::runtime_error{"Could not map " + path.string() + "."};
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    unmap();
+    CloseHandle(file_);
+}
+
+auto mapped_file::resize(const std::size_t size) noexcept -> bool
+{
+    if (mode_ != access::read_write)
+        return false;
+
+    unmap();
+
+    LARGE_INTEGER new_size{};
+    new_size.QuadPart = static_cast<LONGLONG>(size);
+
+    if (!SetFilePointerEx(file_, new_size, nullptr, FILE_BEGIN) || !SetEndOfFile(file_))
+    {
+        map();
+        return false;
+    }
+
+    size_ = size;
+    return size == 0 || map();
+}
+
+auto mapped_file::map() noexcept -> bool
+{
+    const auto writable = mode_ == access::read_write;
+    mapping_ = CreateFileMappingW(file_, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+
+    if (!mapping_)
+        return false;
+
+    data_ = static_cast<std::uint8_t *>(MapViewOfFile(mapping_, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+
+    if (!data_)
+    {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void mapped_file::unmap() noexcept
+{
+    if (data_)
+        UnmapViewOfFile(data_);
+
+    if (mapping_)
+        CloseHandle(mapping_);
+
+    data_ = nullptr;
+    mapping_ = nullptr;
+}
+
+#else
+
+mapped_file::mapped_file(const std::filesystem::path &path, const access mode, const std::size_t create_size)
+    : mode_{mode}
+    , data_{nullptr}
+    , size_{}
+    , file_{-1}
+{
+    const auto writable = mode == access::read_write;
+    file_ = ::open(path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+
+    if (file_ < 0)
+        throw std::runtime_error{"Could not open " + path.string() + "."};
+
+    struct stat status
+    {
+    };
+    ::fstat(file_, &status);
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    if (writable && size_ == 0 && create_size != 0 && !resize(create_size))
+    {
+        ::close(file_);
+        throw std::runtime_error{"Could not resize " + path.string() + "."};
+    }
+
+    if (!data_ && size_ != 0 && !map())
+    {
+        ::close(file_);
+        throw std::runtime_error{"Could not map " + path.string() + "."};
+    }
+}
+
+mapped_file::~mapped_file()
+{
+    unmap();
+    ::close(file_);
+}
+
+auto mapped_file::resize(const std::size_t size) noexcept -> bool
+{
+    if (mode_ != access::read_write)
+        return false;
+
+    unmap();
+
+    if (::ftruncate(file_, static_cast<off_t>(size)) != 0)
+    {
+        map();
+        return false;
+    }
+
+    size_ = size;
+    return size == 0 || map();
+}
+
+auto mapped_file::map() noexcept -> bool
+{
+    const auto protection = mode_ == access::read_write ? PROT_READ | PROT_WRITE : PROT_READ;
+    auto *data = ::mmap(nullptr, size_, protection, MAP_SHARED, file_, 0);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    data_ = static_cast<std::uint8_t *>(data);
+    return true;
+}
+
+void mapped_file::unmap() noexcept
+{
+    if (data_)
+        ::munmap(data_, size_);
+
+    data_ = nullptr;
+}
+
+#endif
+
+} // namespace emu6502
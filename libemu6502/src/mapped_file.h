@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace emu6502
+{
+
+/*!
+ * A file mapped into memory, either read-only or read-write. A writable mapping can be resized, which
+ * changes the size of the file and may move the mapping.
+ */
+class mapped_file final
+{
+public:
+    enum class access
+    {
+        read,
+        read_write
+    };
+
+    /*!
+     * Map an existing file. A writable mapping of a file that doesn't exist creates it with the given size.
+     * Throws if the file can't be opened or mapped.
+     */
+    explicit mapped_file(const std::filesystem::path &path, const access mode, const std::size_t create_size = 0);
+    ~mapped_file();
+
+    mapped_file(mapped_file &&) noexcept = delete;
+    auto operator=(mapped_file &&) noexcept -> mapped_file & = delete;
+
+    mapped_file(const mapped_file &) noexcept = delete;
+    auto operator=(const mapped_file &) noexcept -> mapped_file & = delete;
+
+    /*!
+     * Change the size of a writable mapping. Returns false if the file could not be resized; the old mapping
+     * stays valid in that case.
+     */
+    auto resize(const std::size_t size) noexcept -> bool;
+
+    auto data() const noexcept
+    {
+        return data_;
+    }
+
+    auto size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    auto map() noexcept -> bool;
+    void unmap() noexcept;
+
+    access mode_;
+    std::uint8_t *data_;
+    std::size_t size_;
+
+#if defined(_WIN32)
+    void *file_;
+    void *mapping_;
+#else
+    int file_;
+#endif
+};
+
+} // namespace emu6502
@@ -1,5 +1,6 @@
 #include <emu6502/memory.h>
 #include <aeon/streams/stream.h>
+#include <cstring>
 #include <stdexcept>
 
 namespace emu6502
@@ -13,6 +14,21 @@ void memory::load(aeon::streams::stream &stream, const std::uint16_t offset)
     stream.read(std::data(data_) + offset, stream.size());
 }
 
+auto memory::state_size() const noexcept -> std::size_t
+{
+    return std::size(data_);
+}
+
+void memory::save_state(std::uint8_t *data) const noexcept
+{
+    std::memcpy(data, std::data(data_), std::size(data_));
+}
+
+void memory::load_state(const std::uint8_t *data) noexcept
+{
+    std::memcpy(std::data(data_), data, std::size(data_));
+}
+
 memory::memory(const std::uint16_t offset, const std::uint16_t size)
     : offset_{offset}
     , data_(size)
@@ -33,6 +49,11 @@ void memory::write(const std::uint16_t address, const std::uint8_t value) noexce
 }
 
 auto memory::read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t>
+{
+    return memory::peek(address);
+}
+
+auto memory::peek(const std::uint16_t address) const noexcept -> std::tuple<bool, std::uint8_t>
 {
     const auto offset = static_cast<int>(address) - static_cast<int>(offset_);
 
@@ -0,0 +1,33 @@
+#include <emu6502/memory_mirror.h>
+#include <emu6502/bus.h>
+
+namespace emu6502
+{
+
+void memory_mirror::update(const bus &bus, const std::array<std::uint64_t, 4> &pages) noexcept
+{
+    for (auto page = 0u; page < std::size(pages_); ++page)
+    {
+        if ((pages[page >> 6] >> (page & 63) & 1) != 0)
+            update_page(bus, static_cast<std::uint8_t>(page));
+    }
+}
+
+void memory_mirror::update_all(const bus &bus) noexcept
+{
+    for (auto page = 0u; page < std::size(pages_); ++page)
+        update_page(bus, static_cast<std::uint8_t>(page));
+}
+
+void memory_mirror::update_page(const bus &bus, const std::uint8_t page) noexcept
+{
+    memory_page data;
+    const auto base = static_cast<std::uint16_t>(page << 8);
+
+    for (auto i = 0u; i < std::size(data); ++i)
+        data[i] = bus.peek(static_cast<std::uint16_t>(base + i));
+
+    pages_[page].store(data);
+}
+
+} // namespace emu6502
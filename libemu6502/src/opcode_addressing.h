@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace emu6502::opcode_addressing
+{
+
+enum mode : std::uint8_t
+{
+    imp,
+    imm,
+    zer,
+    abs,
+    zex,
+    zey,
+    abx,
+    aby,
+    rel,
+    inx,
+    iny,
+    abi
+};
+
+// Addressing mode per opcode, as set up by cpu_mos6502::initialize_opcodes. Accumulator mode and the
+// unused opcodes count as implied.
+// clang-format off
+inline constexpr std::array<mode, 256> modes{
+    imp, inx, imp, imp, imp, zer, zer, imp, imp, imm, imp, imp, imp, abs, abs, imp,
+    rel, iny, imp, imp, imp, zex, zex, imp, imp, aby, imp, imp, imp, abx, abx, imp,
+    abs, inx, imp, imp, zer, zer, zer, imp, imp, imm, imp, imp, abs, abs, abs, imp,
+    rel, iny, imp, imp, imp, zex, zex, imp, imp, aby, imp, imp, imp, abx, abx, imp,
+    imp, inx, imp, imp, imp, zer, zer, imp, imp, imm, imp, imp, abs, abs, abs, imp,
+    rel, iny, imp, imp, imp, zex, zex, imp, imp, aby, imp, imp, imp, abx, abx, imp,
+    imp, inx, imp, imp, imp, zer, zer, imp, imp, imm, imp, imp, abi, abs, abs, imp,
+    rel, iny, imp, imp, imp, zex, zex, imp, imp, aby, imp, imp, imp, abx, abx, imp,
+    imp, inx, imp, imp, zer, zer, zer, imp, imp, imp, imp, imp, abs, abs, abs, imp,
+    rel, iny, imp, imp, zex, zex, zey, imp, imp, aby, imp, imp, imp, abx, imp, imp,
+    imm, inx, imm, imp, zer, zer, zer, imp, imp, imm, imp, imp, abs, abs, abs, imp,
+    rel, iny, imp, imp, zex, zex, zey, imp, imp, aby, imp, imp, abx, abx, aby, imp,
+    imm, inx, imp, imp, zer, zer, zer, imp, imp, imm, imp, imp, abs, abs, abs, imp,
+    rel, iny, imp, imp, imp, zex, zex, imp, imp, aby, imp, imp, imp, abx, abx, imp,
+    imm, inx, imp, imp, zer, zer, zer, imp, imp, imm, imp, imp, abs, abs, abs, imp,
+    rel, iny, imp, imp, imp, zex, zex, imp, imp, aby, imp, imp, imp, abx, abx, imp};
+// clang-format on
+
+// Instruction length in bytes, including the opcode.
+inline constexpr auto length(const mode m) noexcept -> std::uint8_t
+{
+    switch (m)
+    {
+        case imp:
+            return 1;
+        case abs:
+        case abx:
+        case aby:
+        case abi:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+inline constexpr auto make_lengths() noexcept
+{
+    std::array<std::uint8_t, 256> table{};
+
+    for (auto i = 0u; i < 256; ++i)
+        table[i] = length(modes[i]);
+
+    return table;
+}
+
+// Instruction length per opcode.
+inline constexpr std::array<std::uint8_t, 256> lengths = make_lengths();
+
+} // namespace emu6502::opcode_addressing
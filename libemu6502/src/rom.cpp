@@ -9,6 +9,20 @@ rom::rom(const std::uint16_t offset, const std::uint16_t size)
 {
 }
 
+auto rom::state_size() const noexcept -> std::size_t
+{
+    return 0;
+}
+
+// Overridden rather than left to memory, which would copy the contents into the empty state buffer.
+void rom::save_state([[maybe_unused]] std::uint8_t *data) const noexcept
+{
+}
+
+void rom::load_state([[maybe_unused]] const std::uint8_t *data) noexcept
+{
+}
+
 void rom::write(const std::uint16_t address, const std::uint8_t value) noexcept
 {
     // ROM can not be written to.
@@ -0,0 +1,407 @@
+#include <emu6502/time_travel.h>
+#include <emu6502/bus.h>
+#include <emu6502/cpu_mos6502.h>
+#include <emu6502/input_log.h>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+
+namespace emu6502
+{
+
+static constexpr std::size_t delta_page_size = 256;
+
+// Weight of the newest measurement in the running averages used to tune the checkpoint interval.
+static constexpr double measurement_weight = 0.25;
+
+using clock = std::chrono::steady_clock;
+
+static auto round_up_to_power_of_two(const std::size_t value) noexcept
+{
+    auto result = std::size_t{1};
+
+    while (result < value)
+        result <<= 1;
+
+    return result;
+}
+
+static auto seconds_since(const clock::time_point start) noexcept
+{
+    return std::chrono::duration<double>(clock::now() - start).count();
+}
+
+time_travel::write_journal::write_journal(time_travel &owner)
+    : recording_{true}
+    , owner_{owner}
+    , entries_(round_up_to_power_of_two(owner.settings_.journal_capacity))
+    , mask_{std::size(entries_) - 1}
+    , head_{}
+    , count_{}
+{
+    // Attached here rather than in the body of time_travel, so the machine state that is created after
+    // the journal already includes it in its device layout.
+    owner.cpu_.get_bus().add(*this);
+}
+
+void time_travel::write_journal::write(const std::uint16_t address, const std::uint8_t value) noexcept
+{
+    if (!recording_)
+        return;
+
+    entries_[head_] = {owner_.current_position(), address, value};
+    head_ = (head_ + 1) & mask_;
+    count_ += count_ <= mask_;
+}
+
+auto time_travel::write_journal::read([[maybe_unused]] const std::uint16_t address) noexcept
+    -> std::tuple<bool, std::uint8_t>
+{
+    return {false, 0};
+}
+
+auto time_travel::write_journal::find_last(const std::uint16_t address, const std::uint64_t before) const noexcept
+    -> std::optional<time_travel_write>
+{
+    for (auto i = std::size_t{0}; i < count_; ++i)
+    {
+        const auto &entry = entries_[(head_ - 1 - i) & mask_];
+
+        if (entry.position < before && entry.address == address)
+            return entry;
+    }
+
+    return std::nullopt;
+}
+
+void time_travel::write_journal::truncate(const std::uint64_t position) noexcept
+{
+    while (count_ > 0 && entries_[(head_ - 1) & mask_].position >= position)
+    {
+        head_ = (head_ - 1) & mask_;
+        --count_;
+    }
+}
+
+time_travel::time_travel(cpu_mos6502 &cpu, const time_travel_settings &settings)
+    : cpu_{cpu}
+    , settings_{settings}
+    , journal_{*this}
+    , position_{}
+    , chunk_start_count_{}
+    , state_{cpu}
+    , previous_state_{}
+    , checkpoints_{}
+    , checkpoints_since_keyframe_{}
+    , memory_usage_{}
+    , input_recorder_{nullptr}
+    , input_ranges_{}
+    , checkpoint_interval_{std::max<std::uint64_t>(settings.min_checkpoint_interval, 1)}
+    , next_checkpoint_{}
+    , execute_seconds_{}
+    , seconds_per_instruction_{}
+    , seconds_per_checkpoint_{}
+{
+    take_checkpoint();
+}
+
+time_travel::~time_travel()
+{
+    cpu_.get_bus().remove(journal_);
+}
+
+auto time_travel::step(const std::uint64_t n) -> std::uint64_t
+{
+    auto executed = std::uint64_t{0};
+
+    while (executed < n)
+    {
+        if (position_ >= next_checkpoint_)
+        {
+            const auto instructions = position_ - checkpoints_.back().position;
+            const auto start = clock::now();
+            take_checkpoint();
+            tune_interval(instructions, seconds_since(start));
+        }
+
+        const auto chunk = std::min(n - executed, next_checkpoint_ - position_);
+        const auto start = clock::now();
+        const auto count = execute(chunk);
+        execute_seconds_ += seconds_since(start);
+
+        executed += count;
+
+        if (count < chunk)
+            break;
+    }
+
+    return executed;
+}
+
+auto time_travel::step_back(const std::uint64_t n) -> bool
+{
+    if (n > position_)
+        return false;
+
+    return seek(position_ - n);
+}
+
+auto time_travel::seek(const std::uint64_t target) -> bool
+{
+    if (target > position_ || target < oldest_position())
+        return false;
+
+    if (target == position_)
+        return true;
+
+    const auto result = std::find_if(std::rbegin(checkpoints_), std::rend(checkpoints_),
+                                     [target](const auto &candidate) { return candidate.position <= target; });
+    assert(result != std::rend(checkpoints_));
+
+    const auto index = static_cast<std::size_t>(std::distance(result, std::rend(checkpoints_)) - 1);
+
+    // Replaying would take fresh input from the host, or none, instead of what the machine got the first time.
+    if (input_delivered(checkpoints_[index].position, target))
+        return false;
+
+    restore_checkpoint(index);
+    truncate(target);
+
+    // The writes up to the target are still in the journal, so they must not be recorded twice.
+    journal_.recording_ = false;
+    [[maybe_unused]] const auto replayed = execute(target - position_);
+    journal_.recording_ = true;
+    assert(replayed == target - checkpoints_[index].position);
+
+    // Timing is not tracked while replaying; start measuring anew from here.
+    execute_seconds_ = 0.0;
+    next_checkpoint_ = std::max(target, checkpoints_.back().position + checkpoint_interval_);
+    return true;
+}
+
+auto time_travel::run_back_to_last_write(const std::uint16_t address) -> bool
+{
+    if (position_ == 0)
+        return false;
+
+    const auto write = journal_.find_last(address, position_ - 1);
+
+    if (!write)
+        return false;
+
+    return seek(write->position + 1);
+}
+
+auto time_travel::find_last_write(const std::uint16_t address) const noexcept -> std::optional<time_travel_write>
+{
+    return journal_.find_last(address, position_);
+}
+
+void time_travel::set_input_recorder(const input_recorder *recorder) noexcept
+{
+    input_recorder_ = recorder;
+}
+
+auto time_travel::current_position() const noexcept -> std::uint64_t
+{
+    // The counter of the cpu is only 32 bits and is cleared on reset, so only the difference is used.
+    return position_ + static_cast<std::uint32_t>(cpu_.num_executed_instructions() - chunk_start_count_);
+}
+
+auto time_travel::execute(const std::uint64_t n) -> std::uint64_t
+{
+    auto executed = std::uint64_t{0};
+
+    while (executed < n)
+    {
+        const auto chunk = static_cast<std::uint32_t>(std::min<std::uint64_t>(n - executed, 0x10000000));
+        const auto input_count = input_recorder_ ? input_recorder_->event_count() : 0;
+
+        chunk_start_count_ = cpu_.num_executed_instructions();
+        cpu_.step(chunk);
+
+        const auto count = static_cast<std::uint32_t>(cpu_.num_executed_instructions() - chunk_start_count_);
+
+        // Only the chunk is known, not the instruction that took the input; single steps are exact.
+        if (input_recorder_ && input_recorder_->event_count() != input_count)
+        {
+            const auto last = position_ + std::max(count, 1u) - 1;
+
+            if (!std::empty(input_ranges_) && input_ranges_.back().last + 1 >= position_)
+                input_ranges_.back().last = last;
+            else
+                input_ranges_.push_back({position_, last});
+        }
+
+        position_ += count;
+        executed += count;
+
+        if (count < chunk)
+            break;
+    }
+
+    return executed;
+}
+
+auto time_travel::input_delivered(const std::uint64_t begin, const std::uint64_t end) const noexcept -> bool
+{
+    for (auto i = std::rbegin(input_ranges_); i != std::rend(input_ranges_) && i->last >= begin; ++i)
+    {
+        if (i->first < end)
+            return true;
+    }
+
+    return false;
+}
+
+void time_travel::take_checkpoint()
+{
+    state_.save(cpu_);
+
+    const auto *current = state_.data();
+    const auto size = state_.size();
+
+    checkpoint new_checkpoint{position_, false, {}};
+
+    if (std::empty(previous_state_) || checkpoints_since_keyframe_ + 1 >= settings_.keyframe_interval)
+    {
+        new_checkpoint.keyframe = true;
+        new_checkpoint.data.assign(current, current + size);
+        checkpoints_since_keyframe_ = 0;
+    }
+    else
+    {
+        for (auto offset = std::size_t{0}; offset < size; offset += delta_page_size)
+        {
+            const auto length = std::min(delta_page_size, size - offset);
+
+            if (std::memcmp(current + offset, std::data(previous_state_) + offset, length) == 0)
+                continue;
+
+            const auto page = static_cast<std::uint32_t>(offset / delta_page_size);
+            const auto *page_bytes = reinterpret_cast<const std::uint8_t *>(&page);
+            new_checkpoint.data.insert(std::end(new_checkpoint.data), page_bytes, page_bytes + sizeof(page));
+            new_checkpoint.data.insert(std::end(new_checkpoint.data), current + offset, current + offset + length);
+        }
+
+        new_checkpoint.data.shrink_to_fit();
+        ++checkpoints_since_keyframe_;
+    }
+
+    previous_state_.assign(current, current + size);
+    memory_usage_ += std::size(new_checkpoint.data) + sizeof(checkpoint);
+    checkpoints_.push_back(std::move(new_checkpoint));
+    next_checkpoint_ = position_ + checkpoint_interval_;
+
+    enforce_memory_budget();
+}
+
+void time_travel::restore_checkpoint(const std::size_t index)
+{
+    auto keyframe = index;
+
+    while (!checkpoints_[keyframe].keyframe)
+        --keyframe;
+
+    previous_state_ = checkpoints_[keyframe].data;
+    const auto size = std::size(previous_state_);
+
+    for (auto i = keyframe + 1; i <= index; ++i)
+    {
+        const auto &data = checkpoints_[i].data;
+
+        for (auto offset = std::size_t{0}; offset < std::size(data);)
+        {
+            std::uint32_t page;
+            std::memcpy(&page, std::data(data) + offset, sizeof(page));
+            offset += sizeof(page);
+
+            const auto page_offset = page * delta_page_size;
+            const auto length = std::min(delta_page_size, size - page_offset);
+            std::memcpy(std::data(previous_state_) + page_offset, std::data(data) + offset, length);
+            offset += length;
+        }
+    }
+
+    state_.assign(std::data(previous_state_), size);
+    state_.restore(cpu_);
+
+    position_ = checkpoints_[index].position;
+    checkpoints_since_keyframe_ = static_cast<std::uint32_t>(index - keyframe);
+}
+
+void time_travel::truncate(const std::uint64_t position)
+{
+    while (checkpoints_.back().position > position)
+    {
+        memory_usage_ -= std::size(checkpoints_.back().data) + sizeof(checkpoint);
+        checkpoints_.pop_back();
+    }
+
+    journal_.truncate(position);
+
+    while (!std::empty(input_ranges_) && input_ranges_.back().first >= position)
+        input_ranges_.pop_back();
+}
+
+void time_travel::enforce_memory_budget() noexcept
+{
+    while (memory_usage_ > settings_.memory_budget)
+    {
+        // Checkpoints are dropped a keyframe and its deltas at a time, so the oldest remaining
+        // checkpoint is always a keyframe.
+        const auto next_keyframe = std::find_if(std::next(std::begin(checkpoints_)), std::end(checkpoints_),
+                                                [](const auto &candidate) { return candidate.keyframe; });
+
+        if (next_keyframe == std::end(checkpoints_))
+        {
+            // Everything belongs to one keyframe; make the next checkpoint a keyframe so the group can go.
+            checkpoints_since_keyframe_ = settings_.keyframe_interval;
+            return;
+        }
+
+        for (auto i = std::begin(checkpoints_); i != next_keyframe; ++i)
+            memory_usage_ -= std::size(i->data) + sizeof(checkpoint);
+
+        checkpoints_.erase(std::begin(checkpoints_), next_keyframe);
+    }
+
+    // Input before the oldest checkpoint can never be replayed across anymore.
+    const auto oldest = checkpoints_.front().position;
+    const auto first_kept = std::find_if(std::begin(input_ranges_), std::end(input_ranges_),
+                                         [oldest](const auto &range) { return range.last >= oldest; });
+    input_ranges_.erase(std::begin(input_ranges_), first_kept);
+}
+
+void time_travel::tune_interval(const std::uint64_t instructions, const double checkpoint_seconds) noexcept
+{
+    if (instructions > 0 && execute_seconds_ > 0.0)
+    {
+        const auto per_instruction = execute_seconds_ / static_cast<double>(instructions);
+        seconds_per_instruction_ = seconds_per_instruction_ == 0.0
+                                       ? per_instruction
+                                       : seconds_per_instruction_ + measurement_weight *
+                                                                        (per_instruction - seconds_per_instruction_);
+    }
+
+    seconds_per_checkpoint_ = seconds_per_checkpoint_ == 0.0
+                                  ? checkpoint_seconds
+                                  : seconds_per_checkpoint_ +
+                                        measurement_weight * (checkpoint_seconds - seconds_per_checkpoint_);
+    execute_seconds_ = 0.0;
+
+    if (seconds_per_instruction_ == 0.0 || settings_.max_overhead <= 0.0)
+        return;
+
+    // A checkpoint every n instructions costs seconds_per_checkpoint / (n * seconds_per_instruction) of
+    // the execution time; pick the smallest n that stays within the allowed overhead.
+    const auto interval = seconds_per_checkpoint_ / (seconds_per_instruction_ * settings_.max_overhead);
+    const auto min_interval = std::max<std::uint64_t>(settings_.min_checkpoint_interval, 1);
+    const auto max_interval = std::max(settings_.max_checkpoint_interval, min_interval);
+
+    checkpoint_interval_ = std::clamp(static_cast<std::uint64_t>(std::min(interval, 1e18)), min_interval, max_interval);
+    next_checkpoint_ = checkpoints_.back().position + checkpoint_interval_;
+}
+
+} // namespace emu6502
@@ -0,0 +1,180 @@
+#include <emu6502/trace_compare.h>
+#include <emu6502/instruction_trace.h>
+#include <lane_vector.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace emu6502
+{
+
+static auto equal_bytes(const std::uint8_t *a, const std::uint8_t *b, std::size_t size) noexcept -> bool
+{
+#if defined(EMU6502_LANE_VECTOR_SSE2)
+    // Differences are rare, so 64 bytes are folded together before the single test per iteration.
+    for (; size >= 64; size -= 64, a += 64, b += 64)
+    {
+        const auto *va = reinterpret_cast<const __m128i *>(a);
+        const auto *vb = reinterpret_cast<const __m128i *>(b);
+
+        const auto d0 = _mm_xor_si128(_mm_loadu_si128(va), _mm_loadu_si128(vb));
+        const auto d1 = _mm_xor_si128(_mm_loadu_si128(va + 1), _mm_loadu_si128(vb + 1));
+        const auto d2 = _mm_xor_si128(_mm_loadu_si128(va + 2), _mm_loadu_si128(vb + 2));
+        const auto d3 = _mm_xor_si128(_mm_loadu_si128(va + 3), _mm_loadu_si128(vb + 3));
+        const auto difference = _mm_or_si128(_mm_or_si128(d0, d1), _mm_or_si128(d2, d3));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(difference, _mm_setzero_si128())) != 0xFFFF)
+            return false;
+    }
+#endif
+
+    return std::memcmp(a, b, size) == 0;
+}
+
+static auto same_block(const instruction_trace_reader::block &a, const instruction_trace_reader::block &b) noexcept
+{
+    return a.first_index == b.first_index && a.record_count == b.record_count && a.used == b.used &&
+           equal_bytes(a.data, b.data, a.used);
+}
+
+/*!
+ * Find the first item in [0, count) for which first_difference reports a difference. The items are split
+ * into chunks that are handed out in order; first_difference(begin, end) returns the first differing
+ * item of a chunk, or end. Once a difference is known, chunks that start after it are skipped.
+ */
+template <typename function_t>
+static auto find_first(const std::uint64_t count, const std::uint64_t chunk_size, const std::size_t thread_count,
+                       function_t &&first_difference) -> std::uint64_t
+{
+    if (count == 0)
+        return 0;
+
+    std::atomic<std::uint64_t> next_chunk{0};
+    std::atomic<std::uint64_t> first{count};
+
+    const auto worker = [&]() {
+        for (;;)
+        {
+            const auto begin = next_chunk.fetch_add(1, std::memory_order_relaxed) * chunk_size;
+
+            if (begin >= first.load(std::memory_order_relaxed))
+                return;
+
+            const auto end = std::min(begin + chunk_size, count);
+            const auto difference = first_difference(begin, end);
+
+            if (difference != end)
+            {
+                auto current = first.load(std::memory_order_relaxed);
+                while (difference < current &&
+                       !first.compare_exchange_weak(current, difference, std::memory_order_relaxed))
+                {
+                }
+
+                return;
+            }
+        }
+    };
+
+    const auto chunk_count = (count + chunk_size - 1) / chunk_size;
+    const auto extra_threads = std::min<std::uint64_t>(thread_count, chunk_count) - 1;
+
+    std::vector<std::thread> threads;
+    for (auto i = std::uint64_t{0}; i < extra_threads; ++i)
+        threads.emplace_back(worker);
+
+    worker();
+
+    for (auto &thread : threads)
+        thread.join();
+
+    return first.load();
+}
+
+auto find_trace_divergence(const instruction_trace_reader &a, const instruction_trace_reader &b,
+                           const trace_compare_settings &settings) -> std::optional<std::uint64_t>
+{
+    const auto thread_count =
+        std::max<std::size_t>(settings.thread_count != 0 ? settings.thread_count : std::thread::hardware_concurrency(),
+                              1);
+
+    const auto begin = std::max(a.first_index(), b.first_index());
+    const auto end_a = a.first_index() + a.record_count();
+    const auto end_b = b.first_index() + b.record_count();
+    const auto end = std::min(end_a, end_b);
+
+    if (begin >= end)
+    {
+        if (a.record_count() == 0 && b.record_count() == 0)
+            return std::nullopt;
+
+        return begin;
+    }
+
+    // Skip all leading blocks that are byte for byte the same in both traces.
+    const auto &blocks_a = a.blocks();
+    const auto &blocks_b = b.blocks();
+
+    const auto block_containing = [begin](const auto &blocks) {
+        return static_cast<std::uint64_t>(
+            std::upper_bound(std::begin(blocks), std::end(blocks), begin,
+                             [](const auto value, const auto &block) { return value < block.first_index; }) -
+            std::begin(blocks) - 1);
+    };
+
+    const auto first_block_a = block_containing(blocks_a);
+    const auto first_block_b = block_containing(blocks_b);
+    const auto block_pairs = std::min(std::size(blocks_a) - first_block_a, std::size(blocks_b) - first_block_b);
+
+    const auto differing_pair = find_first(
+        block_pairs, std::max<std::size_t>(settings.chunk_blocks, 1), thread_count,
+        [&](const std::uint64_t first_pair, const std::uint64_t last_pair) {
+            for (auto pair = first_pair; pair < last_pair; ++pair)
+            {
+                if (!same_block(blocks_a[first_block_a + pair], blocks_b[first_block_b + pair]))
+                    return pair;
+            }
+
+            return last_pair;
+        });
+
+    auto compare_from = begin;
+
+    if (differing_pair > 0)
+    {
+        const auto &last_same = blocks_a[first_block_a + differing_pair - 1];
+        compare_from = std::max(begin, last_same.first_index + last_same.record_count);
+    }
+
+    // Decode and compare the remaining records.
+    const auto chunk_records = std::max<std::size_t>(settings.chunk_records, 1);
+
+    const auto differing_record = find_first(
+        end - std::min(compare_from, end), chunk_records, thread_count,
+        [&](const std::uint64_t first, const std::uint64_t last) {
+            const auto count = static_cast<std::size_t>(last - first);
+            std::vector<trace_record> records_a(count);
+            std::vector<trace_record> records_b(count);
+
+            const auto read_a = a.read(compare_from + first, std::data(records_a), count);
+            const auto read_b = b.read(compare_from + first, std::data(records_b), count);
+
+            const auto compared = std::min(read_a, read_b);
+            const auto mismatch =
+                std::mismatch(std::begin(records_a), std::begin(records_a) + static_cast<std::ptrdiff_t>(compared),
+                              std::begin(records_b));
+
+            return first + static_cast<std::uint64_t>(mismatch.first - std::begin(records_a));
+        });
+
+    const auto divergence = compare_from + differing_record;
+
+    if (divergence < end || end_a != end_b)
+        return divergence;
+
+    return std::nullopt;
+}
+
+} // namespace emu6502
@@ -23,6 +23,32 @@ via_6522::via_6522(const via_6522_settings settings) noexcept
 {
 }
 
+auto via_6522::state_size() const noexcept -> std::size_t
+{
+    return 16;
+}
+
+template <typename via_t>
+auto via_6522::registers(via_t &via) noexcept
+{
+    return std::array{&via.iorb_register_, &via.iora_register_, &via.ddrb_register_, &via.ddra_register_,
+                      &via.t1cl_register_, &via.t1ch_register_, &via.t1ll_register_, &via.t1lh_register_,
+                      &via.t2cl_register_, &via.t2ch_register_, &via.sr_register_,   &via.acr_register_,
+                      &via.pcr_register_,  &via.ifr_register_,  &via.ier_register_,  &via.iora_no_handshake_register_};
+}
+
+void via_6522::save_state(std::uint8_t *data) const noexcept
+{
+    for (const auto reg : registers(*this))
+        *data++ = reg->get();
+}
+
+void via_6522::load_state(const std::uint8_t *data) noexcept
+{
+    for (const auto reg : registers(*this))
+        reg->set(*data++);
+}
+
 void via_6522::write(const std::uint16_t address, const std::uint8_t value) noexcept
 {
 }
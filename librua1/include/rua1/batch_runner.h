@@ -0,0 +1,95 @@
+#pragma once
+
+#include <rua1/configuration.h>
+#include <rua1/machine.h>
+#include <rua1/work_stealing_pool.h>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace rua1::batch
+{
+
+/*!
+ * One headless run of the machine. The input is fed into an ACIA receiver as fast as the firmware
+ * consumes it; everything the firmware transmits on that ACIA is collected as output.
+ */
+struct job
+{
+    std::string name;
+    std::vector<std::uint8_t> input;
+
+    // Name of the ACIA to connect to. Empty selects the first ACIA in the configuration.
+    std::string acia;
+
+    std::uint64_t cycle_budget{};
+    std::optional<std::uint16_t> stop_pc;
+};
+
+enum class job_exit_reason
+{
+    cycle_budget,
+    stop_pc,
+    illegal_opcode,
+    error
+};
+
+struct job_result
+{
+    std::string name;
+    job_exit_reason exit_reason{job_exit_reason::error};
+    std::uint64_t cycles{};
+    std::uint64_t instructions{};
+    std::uint16_t pc{};
+    std::vector<std::uint8_t> output;
+    std::uint64_t duration_ns{};
+    std::size_t worker{};
+    std::string error;
+};
+
+/*!
+ * Runs many jobs in parallel on a work-stealing pool.
+ *
+ * Every worker thread builds its own machine from the configuration the first time it needs one and
+ * resets it to the power-on state between jobs, so ROM images are only loaded once per thread.
+ */
+class batch_runner final
+{
+public:
+    /*!
+     * The configuration must outlive the runner. A thread count of 0 uses all hardware threads.
+     */
+    explicit batch_runner(const config::configuration &config, const std::size_t thread_count = 0);
+    ~batch_runner();
+
+    batch_runner(batch_runner &&) noexcept = delete;
+    auto operator=(batch_runner &&) noexcept -> batch_runner & = delete;
+
+    batch_runner(const batch_runner &) noexcept = delete;
+    auto operator=(const batch_runner &) noexcept -> batch_runner & = delete;
+
+    /*!
+     * Run all jobs and return their results in the same order. Errors in a single job (for example an
+     * unknown ACIA name) are reported in its result instead of aborting the batch.
+     */
+    auto run(const std::vector<job> &jobs) -> std::vector<job_result>;
+
+    auto thread_count() const noexcept
+    {
+        return pool_.thread_count();
+    }
+
+    static auto to_string(const job_exit_reason reason) noexcept -> const char *;
+
+private:
+    auto get_machine(const std::size_t worker) -> machine &;
+    static void execute(machine &m, const job &j, job_result &result);
+
+    const config::configuration &config_;
+    work_stealing_pool pool_;
+    std::vector<std::unique_ptr<machine>> machines_;
+};
+
+} // namespace rua1::batch
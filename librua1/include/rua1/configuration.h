@@ -19,7 +19,7 @@ enum class device_type
 class device_config
 {
 public:
-    ~device_config() = default;
+    virtual ~device_config() = default;
 
     device_config(device_config &&) noexcept = delete;
     auto operator=(device_config &&) noexcept -> device_config & = delete;
@@ -272,18 +272,105 @@ private:
     int iora_no_hs_register_;
 };
 
+enum class serial_backend_type
+{
+    none,
+    pty,
+    unix_socket,
+    file,
+    stdio
+};
+
+enum class serial_timing
+{
+    accurate,
+    turbo
+};
+
+/*!
+ * Host endpoint of an ACIA, from the optional "backend" object of an acia_6551 device. The default
+ * configuration leaves every ACIA unconnected. To reach one from a terminal program, connect it to a pty
+ * and open the symlink (the pty backend replaces whatever file exists at that path):
+ *
+ *     "serial_timing": "accurate",
+ *     "backend": {
+ *         "type": "pty",
+ *         "path": "/tmp/rua1_acia1"
+ *     }
+ */
+class serial_backend_config final
+{
+public:
+    serial_backend_config() = default;
+
+    explicit serial_backend_config(const serial_backend_type type, std::filesystem::path path,
+                                   std::filesystem::path input, std::filesystem::path output)
+        : type_{type}
+        , path_{std::move(path)}
+        , input_{std::move(input)}
+        , output_{std::move(output)}
+    {
+    }
+
+    ~serial_backend_config() = default;
+
+    serial_backend_config(serial_backend_config &&) noexcept = default;
+    auto operator=(serial_backend_config &&) noexcept -> serial_backend_config & = default;
+
+    serial_backend_config(const serial_backend_config &) = default;
+    auto operator=(const serial_backend_config &) -> serial_backend_config & = default;
+
+    auto type() const noexcept
+    {
+        return type_;
+    }
+
+    /*!
+     * Socket path for unix_socket. For pty an optional symlink to the slave device is created here.
+     */
+    const auto &path() const noexcept
+    {
+        return path_;
+    }
+
+    /*!
+     * File or FIFO to replay into the receiver. Only used by the file backend.
+     */
+    const auto &input() const noexcept
+    {
+        return input_;
+    }
+
+    /*!
+     * File or FIFO to capture the transmitter into. Only used by the file backend.
+     */
+    const auto &output() const noexcept
+    {
+        return output_;
+    }
+
+private:
+    serial_backend_type type_{serial_backend_type::none};
+    std::filesystem::path path_;
+    std::filesystem::path input_;
+    std::filesystem::path output_;
+};
+
 class acia_6551_device_config final : public device_config
 {
 public:
     explicit acia_6551_device_config(std::string name, const bool enabled, const int send_recv_register,
                                      const int status_register, const int command_register, const int control_register,
-                                     const bool simulate_wdc_bugs)
+                                     const bool simulate_wdc_bugs, const serial_timing timing,
+                                     serial_backend_config backend)
         : device_config{device_type::acia_6551, std::move(name), enabled}
         , send_recv_register_{send_recv_register}
         , status_register_{status_register}
         , command_register_{command_register}
         , control_register_{control_register}
         , simulate_wdc_bugs_{simulate_wdc_bugs}
+        , timing_{timing}
+        , backend_{std::move(backend)}
     {
     }
 
@@ -320,12 +407,24 @@ public:
         return simulate_wdc_bugs_;
     }
 
+    auto timing() const noexcept
+    {
+        return timing_;
+    }
+
+    const auto &backend() const noexcept
+    {
+        return backend_;
+    }
+
 private:
     int send_recv_register_;
     int status_register_;
     int command_register_;
     int control_register_;
     bool simulate_wdc_bugs_;
+    serial_timing timing_;
+    serial_backend_config backend_;
 };
 
 class configuration final
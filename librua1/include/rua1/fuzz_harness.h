@@ -0,0 +1,148 @@
+#pragma once
+
+#include <rua1/configuration.h>
+#include <rua1/machine.h>
+#include <emu6502/icpu_debug_interface.h>
+#include <emu6502/ibus_device.h>
+#include <emu6502/machine_state.h>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace rua1::fuzz
+{
+
+struct fuzz_settings
+{
+    // Name of the ACIA that receives the input. Empty selects the first ACIA in the configuration.
+    std::string acia;
+
+    // The machine boots from reset until it reaches this PC. Without a boot PC it simply runs for
+    // boot_cycles. With a boot PC, boot_cycles is the limit after which booting is considered failed.
+    std::optional<std::uint16_t> boot_pc;
+    std::uint64_t boot_cycles{10000000};
+
+    // Every input runs until the cycle budget is spent or the sentinel PC is reached.
+    std::uint64_t cycle_budget{20000};
+    std::optional<std::uint16_t> sentinel_pc;
+};
+
+enum class fuzz_finding
+{
+    none,
+    illegal_opcode,
+    stack_overflow,
+    stack_underflow,
+    rom_write
+};
+
+struct fuzz_result
+{
+    fuzz_finding finding{fuzz_finding::none};
+
+    // PC at the moment the finding was detected, or where the run stopped.
+    std::uint16_t pc{};
+
+    // Target address of a ROM write.
+    std::uint16_t address{};
+
+    std::uint64_t cycles{};
+    bool reached_sentinel{};
+};
+
+/*!
+ * Persistent-mode fuzzing of firmware through a serial port.
+ *
+ * The machine is booted once and snapshotted. Every input then starts from that snapshot, is fed into
+ * the ACIA receiver and runs until the cycle budget or the sentinel PC, so an execution only costs the
+ * snapshot restore plus the instructions that actually handle the input.
+ */
+class fuzz_harness final : private emu6502::icpu_debug_interface
+{
+public:
+    /*!
+     * Build and boot the machine. The configuration is only used during construction.
+     * Throws if the ACIA does not exist or the boot PC is not reached.
+     */
+    explicit fuzz_harness(const config::configuration &config, fuzz_settings settings);
+    ~fuzz_harness() final;
+
+    fuzz_harness(fuzz_harness &&) noexcept = delete;
+    auto operator=(fuzz_harness &&) noexcept -> fuzz_harness & = delete;
+
+    fuzz_harness(const fuzz_harness &) noexcept = delete;
+    auto operator=(const fuzz_harness &) noexcept -> fuzz_harness & = delete;
+
+    /*!
+     * Run one input from the boot snapshot.
+     */
+    auto run(const std::uint8_t *data, const std::size_t size) -> fuzz_result;
+
+    /*!
+     * Record guest coverage for every following run. See emu6502::cpu_mos6502::set_coverage.
+     */
+    void set_coverage(const emu6502::cpu_coverage &coverage) noexcept;
+
+    /*!
+     * Everything the firmware sent back during the last run.
+     */
+    const auto &output() const noexcept
+    {
+        return output_;
+    }
+
+    static auto to_string(const fuzz_finding finding) noexcept -> const char *;
+
+private:
+    /*!
+     * Sees every bus write and flags the ones that land in ROM. It never answers reads.
+     */
+    class rom_write_detector final : public emu6502::ibus_device
+    {
+    public:
+        explicit rom_write_detector(fuzz_harness &harness);
+        ~rom_write_detector() = default;
+
+        rom_write_detector(rom_write_detector &&) noexcept = delete;
+        auto operator=(rom_write_detector &&) noexcept -> rom_write_detector & = delete;
+
+        rom_write_detector(const rom_write_detector &) noexcept = delete;
+        auto operator=(const rom_write_detector &) noexcept -> rom_write_detector & = delete;
+
+        void add_range(const std::uint16_t offset, const std::uint32_t size);
+
+    private:
+        void write(const std::uint16_t address, const std::uint8_t value) noexcept override;
+        auto read(const std::uint16_t address) noexcept -> std::tuple<bool, std::uint8_t> override;
+
+        fuzz_harness &harness_;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges_;
+    };
+
+    void boot();
+    void report(const fuzz_finding finding, const std::uint16_t address = 0) noexcept;
+    void service_acia(const std::uint8_t *data, const std::size_t size, std::size_t &offset);
+
+    void on_cpu_instruction_executed() override;
+    void on_cpu_breakpoint() override;
+    void on_cpu_illegal_opcode() override;
+    void on_cpu_reset() override;
+    void on_cpu_nmi() override;
+    void on_cpu_irq() override;
+    void on_cpu_stack_push(const std::uint8_t byte) override;
+    void on_cpu_stack_pop() override;
+
+    fuzz_settings settings_;
+    machine machine_;
+    rom_write_detector rom_write_detector_;
+    emu6502::acia_6551 *acia_;
+    std::optional<emu6502::machine_state> snapshot_;
+    std::vector<std::uint8_t> output_;
+
+    // Findings are only collected once booting is done.
+    bool armed_;
+    fuzz_result result_;
+};
+
+} // namespace rua1::fuzz
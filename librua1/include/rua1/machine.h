@@ -0,0 +1,67 @@
+#pragma once
+
+#include <rua1/configuration.h>
+#include <emu6502/acia_6551.h>
+#include <emu6502/bus.h>
+#include <emu6502/cpu_mos6502.h>
+#include <emu6502/icpu_debug_interface.h>
+#include <emu6502/machine_state.h>
+#include <emu6502/memory.h>
+#include <emu6502/via_6522.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace rua1
+{
+
+/*!
+ * A complete machine without a user interface, built from a configuration.
+ *
+ * The power-on state is captured after construction, so reset() brings the machine back to it with
+ * a few memcpy calls instead of rebuilding the devices and reloading ROM images.
+ */
+class machine final
+{
+public:
+    explicit machine(const config::configuration &config, emu6502::icpu_debug_interface *debug_interface = nullptr);
+    ~machine();
+
+    machine(machine &&) noexcept = delete;
+    auto operator=(machine &&) noexcept -> machine & = delete;
+
+    machine(const machine &) noexcept = delete;
+    auto operator=(const machine &) noexcept -> machine & = delete;
+
+    /*!
+     * Restore the power-on state and discard any pending serial data.
+     */
+    void reset();
+
+    auto get_cpu() noexcept -> emu6502::cpu_mos6502 &
+    {
+        return cpu_;
+    }
+
+    auto get_bus() noexcept -> emu6502::bus &
+    {
+        return bus_;
+    }
+
+    /*!
+     * Find an ACIA by its configured name. An empty name returns the first ACIA.
+     * Returns nullptr if there is no such ACIA.
+     */
+    auto find_acia(const std::string &name) noexcept -> emu6502::acia_6551 *;
+
+private:
+    emu6502::bus bus_;
+    std::vector<std::unique_ptr<emu6502::memory>> memories_;
+    std::vector<std::unique_ptr<emu6502::via_6522>> vias_;
+    std::vector<std::pair<std::string, std::unique_ptr<emu6502::acia_6551>>> acias_;
+    emu6502::cpu_mos6502 cpu_;
+    std::optional<emu6502::machine_state> power_on_state_;
+};
+
+} // namespace rua1
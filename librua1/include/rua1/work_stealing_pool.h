@@ -0,0 +1,76 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rua1::batch
+{
+
+/*!
+ * A fixed set of worker threads that execute indexed tasks.
+ *
+ * Every worker gets its own deque with a contiguous block of indices. A worker takes work from the back
+ * of its own deque and, once it runs dry, steals from the front of the others. Jobs that take very
+ * different amounts of time therefore still keep all threads busy.
+ */
+class work_stealing_pool final
+{
+public:
+    using task_func = std::function<void(const std::size_t index, const std::size_t worker)>;
+
+    /*!
+     * Start the workers. A thread count of 0 uses the number of hardware threads.
+     */
+    explicit work_stealing_pool(const std::size_t thread_count = 0);
+    ~work_stealing_pool();
+
+    work_stealing_pool(work_stealing_pool &&) noexcept = delete;
+    auto operator=(work_stealing_pool &&) noexcept -> work_stealing_pool & = delete;
+
+    work_stealing_pool(const work_stealing_pool &) noexcept = delete;
+    auto operator=(const work_stealing_pool &) noexcept -> work_stealing_pool & = delete;
+
+    /*!
+     * Call func for every index in [0, count) and wait until all calls returned. The worker index passed
+     * to func is stable per thread, so it can be used to select per-thread resources.
+     * Must not be called from within a task. If a task throws, the first exception is rethrown here.
+     */
+    void parallel_for(const std::size_t count, const task_func &func);
+
+    auto thread_count() const noexcept
+    {
+        return std::size(workers_);
+    }
+
+private:
+    struct worker_queue
+    {
+        std::mutex mutex;
+        std::deque<std::size_t> indices;
+    };
+
+    void worker_thread(const std::size_t worker);
+    auto take(const std::size_t worker, std::size_t &index) -> bool;
+    void execute(const std::size_t index, const std::size_t worker);
+
+    std::vector<std::unique_ptr<worker_queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable work_done_;
+    const task_func *func_;
+    std::size_t generation_;
+    std::size_t remaining_;
+    std::exception_ptr exception_;
+    bool shutdown_;
+};
+
+} // namespace rua1::batch
@@ -0,0 +1,143 @@
+#include <rua1/batch_runner.h>
+#include <array>
+#include <chrono>
+#include <stdexcept>
+
+namespace rua1::batch
+{
+
+// Instructions between checks for serial output and fresh receiver space.
+static constexpr auto io_interval = 256u;
+
+batch_runner::batch_runner(const config::configuration &config, const std::size_t thread_count)
+    : config_{config}
+    , pool_{thread_count}
+    , machines_{}
+{
+    machines_.resize(pool_.thread_count());
+}
+
+batch_runner::~batch_runner() = default;
+
+auto batch_runner::run(const std::vector<job> &jobs) -> std::vector<job_result>
+{
+    std::vector<job_result> results(std::size(jobs));
+
+    pool_.parallel_for(std::size(jobs), [this, &jobs, &results](const std::size_t index, const std::size_t worker) {
+        const auto &j = jobs[index];
+        auto &result = results[index];
+        result.name = j.name;
+        result.worker = worker;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        try
+        {
+            execute(get_machine(worker), j, result);
+        }
+        catch (const std::exception &e)
+        {
+            result.exit_reason = job_exit_reason::error;
+            result.error = e.what();
+        }
+
+        const auto duration = std::chrono::steady_clock::now() - start;
+        result.duration_ns =
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    });
+
+    return results;
+}
+
+auto batch_runner::to_string(const job_exit_reason reason) noexcept -> const char *
+{
+    switch (reason)
+    {
+        case job_exit_reason::cycle_budget:
+            return "cycle_budget";
+        case job_exit_reason::stop_pc:
+            return "stop_pc";
+        case job_exit_reason::illegal_opcode:
+            return "illegal_opcode";
+        case job_exit_reason::error:
+        default:
+            return "error";
+    }
+}
+
+auto batch_runner::get_machine(const std::size_t worker) -> machine &
+{
+    // Only ever touched by the worker thread it belongs to.
+    auto &m = machines_[worker];
+
+    if (!m)
+        m = std::make_unique<machine>(config_);
+    else
+        m->reset();
+
+    return *m;
+}
+
+void batch_runner::execute(machine &m, const job &j, job_result &result)
+{
+    auto *acia = m.find_acia(j.acia);
+
+    if (!acia && (!std::empty(j.input) || !std::empty(j.acia)))
+        throw std::runtime_error{"No ACIA named '" + j.acia + "' in the configuration."};
+
+    auto &cpu = m.get_cpu();
+    auto &bus = m.get_bus();
+    const auto start_cycle = bus.cycle();
+    const auto end_cycle = start_cycle + j.cycle_budget;
+    const auto start_instructions = cpu.num_executed_instructions();
+
+    std::size_t input_offset = 0;
+    std::array<std::uint8_t, 256> buffer{};
+
+    const auto service_acia = [&]() {
+        if (!acia)
+            return;
+
+        if (input_offset < std::size(j.input))
+            input_offset += acia->host_write(std::data(j.input) + input_offset, std::size(j.input) - input_offset);
+
+        std::size_t read = 0;
+        while ((read = acia->host_read(std::data(buffer), std::size(buffer))) > 0)
+            result.output.insert(std::end(result.output), std::begin(buffer), std::begin(buffer) + read);
+    };
+
+    result.exit_reason = job_exit_reason::cycle_budget;
+    service_acia();
+
+    auto countdown = io_interval;
+    while (bus.cycle() < end_cycle)
+    {
+        if (j.stop_pc && cpu.pc() == *j.stop_pc)
+        {
+            result.exit_reason = job_exit_reason::stop_pc;
+            break;
+        }
+
+        cpu.step(1);
+
+        if (cpu.is_illegal_opcode_set())
+        {
+            result.exit_reason = job_exit_reason::illegal_opcode;
+            break;
+        }
+
+        if (--countdown == 0)
+        {
+            service_acia();
+            countdown = io_interval;
+        }
+    }
+
+    service_acia();
+
+    result.cycles = bus.cycle() - start_cycle;
+    result.instructions = cpu.num_executed_instructions() - start_instructions;
+    result.pc = cpu.pc();
+}
+
+} // namespace rua1::batch
@@ -1,4 +1,4 @@
-#include <configuration.h>
+#include <rua1/configuration.h>
 #include <json11.hpp>
 #include <aeon/streams/file_stream.h>
 #include <aeon/streams/stream_reader.h>
@@ -37,6 +37,19 @@ static auto get_bool(const std::map<std::string, json11::Json> &map, const std::
     return bool_obj.bool_value();
 }
 
+static auto get_optional_string(const std::map<std::string, json11::Json> &map, const std::string &key)
+{
+    const auto result = map.find(key);
+
+    if (result == std::end(map))
+        return std::string{};
+
+    if (!result->second.is_string())
+        throw std::runtime_error{"Expected string."};
+
+    return result->second.string_value();
+}
+
 } // namespace json11_helpers
 
 static auto load_config_file(const std::filesystem::path &path)
@@ -101,6 +114,59 @@ auto load_via_6522_device_config(const std::map<std::string, json11::Json> &map)
         ifr_register, ier_register, iora_no_hs_register);
 }
 
+auto load_serial_backend_config(const std::map<std::string, json11::Json> &map)
+{
+    const auto result = map.find("backend");
+
+    if (result == std::end(map))
+        return serial_backend_config{};
+
+    if (!result->second.is_object())
+        throw std::runtime_error{"Expected 'backend' to be an object."};
+
+    const auto &values = result->second.object_items();
+    const auto type_str = json11_helpers::get_string(values, "type");
+    const auto path = json11_helpers::get_optional_string(values, "path");
+    const auto input = json11_helpers::get_optional_string(values, "input");
+    const auto output = json11_helpers::get_optional_string(values, "output");
+
+    auto type = serial_backend_type::none;
+
+    if (type_str == "none")
+        type = serial_backend_type::none;
+    else if (type_str == "pty")
+        type = serial_backend_type::pty;
+    else if (type_str == "unix_socket")
+        type = serial_backend_type::unix_socket;
+    else if (type_str == "file")
+        type = serial_backend_type::file;
+    else if (type_str == "stdio")
+        type = serial_backend_type::stdio;
+    else
+        throw std::runtime_error{"Unknown serial backend type '" + type_str + "'."};
+
+    if (type == serial_backend_type::unix_socket && path.empty())
+        throw std::runtime_error{"Serial backend 'unix_socket' requires a 'path'."};
+
+    if (type == serial_backend_type::file && input.empty() && output.empty())
+        throw std::runtime_error{"Serial backend 'file' requires an 'input' and/or 'output'."};
+
+    return serial_backend_config{type, path, input, output};
+}
+
+auto load_serial_timing(const std::map<std::string, json11::Json> &map)
+{
+    const auto timing_str = json11_helpers::get_optional_string(map, "serial_timing");
+
+    if (timing_str.empty() || timing_str == "turbo")
+        return serial_timing::turbo;
+
+    if (timing_str == "accurate")
+        return serial_timing::accurate;
+
+    throw std::runtime_error{"Unknown serial timing '" + timing_str + "'."};
+}
+
 auto load_acia_6551_device_config(const std::map<std::string, json11::Json> &map)
 {
     const auto name = json11_helpers::get_string(map, "name");
@@ -111,9 +177,12 @@ auto load_acia_6551_device_config(const std::map<std::string, json11::Json> &map
     const auto command_register = json11_helpers::get_hex_string(map, "command_register");
     const auto control_register = json11_helpers::get_hex_string(map, "control_register");
     const auto simulate_wdc_bugs = json11_helpers::get_bool(map, "simulate_wdc_bugs");
+    const auto timing = load_serial_timing(map);
+    auto backend = load_serial_backend_config(map);
 
     return std::make_unique<acia_6551_device_config>(name, enabled, send_recv_register, status_register,
-                                                     command_register, control_register, simulate_wdc_bugs);
+                                                     command_register, control_register, simulate_wdc_bugs, timing,
+                                                     std::move(backend));
 }
 
 auto load_devices_config(json11::Json &json) -> std::vector<std::unique_ptr<device_config>>
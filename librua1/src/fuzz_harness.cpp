@@ -0,0 +1,230 @@
+#include <rua1/fuzz_harness.h>
+#include <array>
+#include <stdexcept>
+
+namespace rua1::fuzz
+{
+
+// Instructions between checks for serial output and fresh receiver space.
+static constexpr auto io_interval = 64u;
+
+fuzz_harness::rom_write_detector::rom_write_detector(fuzz_harness &harness)
+    : harness_{harness}
+    , ranges_{}
+{
+}
+
+void fuzz_harness::rom_write_detector::add_range(const std::uint16_t offset, const std::uint32_t size)
+{
+    ranges_.emplace_back(offset, offset + size);
+}
+
+void fuzz_harness::rom_write_detector::write(const std::uint16_t address,
+                                             [[maybe_unused]] const std::uint8_t value) noexcept
+{
+    for (const auto &[begin, end] : ranges_)
+    {
+        if (address >= begin && address < end)
+        {
+            harness_.report(fuzz_finding::rom_write, address);
+            return;
+        }
+    }
+}
+
+auto fuzz_harness::rom_write_detector::read([[maybe_unused]] const std::uint16_t address) noexcept
+    -> std::tuple<bool, std::uint8_t>
+{
+    return {false, 0};
+}
+
+fuzz_harness::fuzz_harness(const config::configuration &config, fuzz_settings settings)
+    : settings_{std::move(settings)}
+    , machine_{config, this}
+    , rom_write_detector_{*this}
+    , acia_{machine_.find_acia(settings_.acia)}
+    , snapshot_{}
+    , output_{}
+    , armed_{false}
+    , result_{}
+{
+    if (!acia_)
+        throw std::runtime_error{"No ACIA named '" + settings_.acia + "' in the configuration."};
+
+    for (const auto &device : config.get_device_config())
+    {
+        if (device->enabled() && device->type() == config::device_type::rom)
+        {
+            const auto &rom_config = device->as<config::rom_device_config>();
+            rom_write_detector_.add_range(static_cast<std::uint16_t>(rom_config.offset()),
+                                          static_cast<std::uint32_t>(rom_config.size()));
+        }
+    }
+
+    machine_.get_bus().add(rom_write_detector_);
+
+    boot();
+}
+
+fuzz_harness::~fuzz_harness() = default;
+
+auto fuzz_harness::run(const std::uint8_t *data, const std::size_t size) -> fuzz_result
+{
+    auto &cpu = machine_.get_cpu();
+    auto &bus = machine_.get_bus();
+
+    snapshot_->restore(cpu);
+    cpu.reset_coverage_context();
+    acia_->clear_fifos();
+    output_.clear();
+
+    result_ = fuzz_result{};
+    armed_ = true;
+
+    const auto start_cycle = bus.cycle();
+    const auto end_cycle = start_cycle + settings_.cycle_budget;
+    std::size_t offset = 0;
+
+    service_acia(data, size, offset);
+
+    auto countdown = io_interval;
+    while (bus.cycle() < end_cycle && result_.finding == fuzz_finding::none)
+    {
+        if (settings_.sentinel_pc && cpu.pc() == *settings_.sentinel_pc)
+        {
+            result_.reached_sentinel = true;
+            break;
+        }
+
+        cpu.step(1);
+
+        if (--countdown == 0)
+        {
+            service_acia(data, size, offset);
+            countdown = io_interval;
+        }
+    }
+
+    service_acia(data, size, offset);
+    armed_ = false;
+
+    if (result_.finding == fuzz_finding::none)
+        result_.pc = cpu.pc();
+
+    result_.cycles = bus.cycle() - start_cycle;
+    return result_;
+}
+
+void fuzz_harness::set_coverage(const emu6502::cpu_coverage &coverage) noexcept
+{
+    machine_.get_cpu().set_coverage(coverage);
+}
+
+auto fuzz_harness::to_string(const fuzz_finding finding) noexcept -> const char *
+{
+    switch (finding)
+    {
+        case fuzz_finding::illegal_opcode:
+            return "illegal opcode";
+        case fuzz_finding::stack_overflow:
+            return "stack overflow";
+        case fuzz_finding::stack_underflow:
+            return "stack underflow";
+        case fuzz_finding::rom_write:
+            return "write into ROM";
+        case fuzz_finding::none:
+        default:
+            return "none";
+    }
+}
+
+void fuzz_harness::boot()
+{
+    auto &cpu = machine_.get_cpu();
+    auto &bus = machine_.get_bus();
+
+    while (bus.cycle() < settings_.boot_cycles)
+    {
+        if (settings_.boot_pc && cpu.pc() == *settings_.boot_pc)
+            break;
+
+        cpu.step(1);
+
+        if (cpu.is_illegal_opcode_set())
+            throw std::runtime_error{"Illegal opcode while booting the firmware."};
+
+        // Boot messages are of no interest; keep the transmitter from stalling on a full FIFO.
+        std::array<std::uint8_t, 256> discard{};
+        while (acia_->host_read(std::data(discard), std::size(discard)) > 0)
+        {
+        }
+    }
+
+    if (settings_.boot_pc && cpu.pc() != *settings_.boot_pc)
+        throw std::runtime_error{"The firmware did not reach the boot PC within the boot cycle limit."};
+
+    snapshot_.emplace(cpu);
+    snapshot_->save(cpu);
+}
+
+void fuzz_harness::report(const fuzz_finding finding, const std::uint16_t address) noexcept
+{
+    // Only the first finding of a run is reported; everything after it is a consequence.
+    if (!armed_ || result_.finding != fuzz_finding::none)
+        return;
+
+    result_.finding = finding;
+    result_.pc = machine_.get_cpu().pc();
+    result_.address = address;
+}
+
+void fuzz_harness::service_acia(const std::uint8_t *data, const std::size_t size, std::size_t &offset)
+{
+    if (offset < size)
+        offset += acia_->host_write(data + offset, size - offset);
+
+    std::array<std::uint8_t, 256> buffer{};
+    std::size_t read = 0;
+    while ((read = acia_->host_read(std::data(buffer), std::size(buffer))) > 0)
+        output_.insert(std::end(output_), std::begin(buffer), std::begin(buffer) + read);
+}
+
+void fuzz_harness::on_cpu_instruction_executed()
+{
+}
+
+void fuzz_harness::on_cpu_breakpoint()
+{
+}
+
+void fuzz_harness::on_cpu_illegal_opcode()
+{
+    report(fuzz_finding::illegal_opcode);
+}
+
+void fuzz_harness::on_cpu_reset()
+{
+}
+
+void fuzz_harness::on_cpu_nmi()
+{
+}
+
+void fuzz_harness::on_cpu_irq()
+{
+}
+
+void fuzz_harness::on_cpu_stack_push([[maybe_unused]] const std::uint8_t byte)
+{
+    // The stack pointer is already decremented; it only ends up at 0xFF when it wrapped.
+    if (machine_.get_cpu().sp() == 0xFF)
+        report(fuzz_finding::stack_overflow);
+}
+
+void fuzz_harness::on_cpu_stack_pop()
+{
+    if (machine_.get_cpu().sp() == 0x00)
+        report(fuzz_finding::stack_underflow);
+}
+
+} // namespace rua1::fuzz
@@ -0,0 +1,120 @@
+#include <rua1/machine.h>
+#include <emu6502/ram.h>
+#include <emu6502/rom.h>
+#include <aeon/streams/file_stream.h>
+
+namespace rua1
+{
+
+static auto to_timing_mode(const config::serial_timing timing) noexcept
+{
+    if (timing == config::serial_timing::accurate)
+        return emu6502::acia_6551_timing_mode::accurate;
+
+    return emu6502::acia_6551_timing_mode::turbo;
+}
+
+machine::machine(const config::configuration &config, emu6502::icpu_debug_interface *debug_interface)
+    : bus_{}
+    , memories_{}
+    , vias_{}
+    , acias_{}
+    , cpu_{bus_, debug_interface}
+    , power_on_state_{}
+{
+    for (const auto &device : config.get_device_config())
+    {
+        if (!device->enabled())
+            continue;
+
+        switch (device->type())
+        {
+            case config::device_type::rom:
+            {
+                const auto &rom_config = device->as<config::rom_device_config>();
+                auto rom = std::make_unique<emu6502::rom>(static_cast<std::uint16_t>(rom_config.offset()),
+                                                          static_cast<std::uint16_t>(rom_config.size()));
+                aeon::streams::file_stream file{rom_config.file()};
+                rom->load(file, 0);
+                bus_.add(*rom);
+                memories_.emplace_back(std::move(rom));
+                break;
+            }
+            case config::device_type::ram:
+            {
+                const auto &ram_config = device->as<config::ram_device_config>();
+                auto ram = std::make_unique<emu6502::ram>(static_cast<std::uint16_t>(ram_config.offset()),
+                                                          static_cast<std::uint16_t>(ram_config.size()));
+                bus_.add(*ram);
+                memories_.emplace_back(std::move(ram));
+                break;
+            }
+            case config::device_type::acia_6551:
+            {
+                const auto &acia_config = device->as<config::acia_6551_device_config>();
+                auto acia = std::make_unique<emu6502::acia_6551>(emu6502::acia_6551_settings{
+                    static_cast<std::uint16_t>(acia_config.send_recv_register()),
+                    static_cast<std::uint16_t>(acia_config.status_register()),
+                    static_cast<std::uint16_t>(acia_config.command_register()),
+                    static_cast<std::uint16_t>(acia_config.control_register()), acia_config.simulate_wdc_bugs(),
+                    to_timing_mode(acia_config.timing()), {}});
+                bus_.add(*acia);
+                acias_.emplace_back(acia_config.name(), std::move(acia));
+                break;
+            }
+            case config::device_type::via_6522:
+            {
+                const auto &via_config = device->as<config::via_6522_device_config>();
+                auto via = std::make_unique<emu6502::via_6522>(emu6502::via_6522_settings{
+                    static_cast<std::uint16_t>(via_config.iorb_register()),
+                    static_cast<std::uint16_t>(via_config.iora_register()),
+                    static_cast<std::uint16_t>(via_config.ddrb_register()),
+                    static_cast<std::uint16_t>(via_config.ddra_register()),
+                    static_cast<std::uint16_t>(via_config.t1cl_register()),
+                    static_cast<std::uint16_t>(via_config.t1ch_register()),
+                    static_cast<std::uint16_t>(via_config.t1ll_register()),
+                    static_cast<std::uint16_t>(via_config.t1lh_register()),
+                    static_cast<std::uint16_t>(via_config.t2cl_register()),
+                    static_cast<std::uint16_t>(via_config.t2ch_register()),
+                    static_cast<std::uint16_t>(via_config.sr_register()),
+                    static_cast<std::uint16_t>(via_config.acr_register()),
+                    static_cast<std::uint16_t>(via_config.pcr_register()),
+                    static_cast<std::uint16_t>(via_config.ifr_register()),
+                    static_cast<std::uint16_t>(via_config.ier_register()),
+                    static_cast<std::uint16_t>(via_config.iora_no_hs_register())});
+                bus_.add(*via);
+                vias_.emplace_back(std::move(via));
+                break;
+            }
+            default:;
+        }
+    }
+
+    // The reset vector can only be read once the ROM is on the bus.
+    cpu_.reset();
+    power_on_state_.emplace(cpu_);
+    power_on_state_->save(cpu_);
+}
+
+machine::~machine() = default;
+
+void machine::reset()
+{
+    power_on_state_->restore(cpu_);
+
+    for (auto &[name, acia] : acias_)
+        acia->clear_fifos();
+}
+
+auto machine::find_acia(const std::string &name) noexcept -> emu6502::acia_6551 *
+{
+    for (auto &[acia_name, acia] : acias_)
+    {
+        if (name.empty() || acia_name == name)
+            return acia.get();
+    }
+
+    return nullptr;
+}
+
+} // namespace rua1
@@ -0,0 +1,156 @@
+#include <rua1/work_stealing_pool.h>
+#include <algorithm>
+#include <utility>
+
+namespace rua1::batch
+{
+
+work_stealing_pool::work_stealing_pool(const std::size_t thread_count)
+    : queues_{}
+    , workers_{}
+    , mutex_{}
+    , work_available_{}
+    , work_done_{}
+    , func_{nullptr}
+    , generation_{}
+    , remaining_{}
+    , exception_{}
+    , shutdown_{false}
+{
+    auto count = thread_count;
+
+    if (count == 0)
+        count = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (auto i = 0u; i < count; ++i)
+        queues_.emplace_back(std::make_unique<worker_queue>());
+
+    for (auto i = 0u; i < count; ++i)
+        workers_.emplace_back([this, i]() { worker_thread(i); });
+}
+
+work_stealing_pool::~work_stealing_pool()
+{
+    {
+        std::scoped_lock lock{mutex_};
+        shutdown_ = true;
+    }
+
+    work_available_.notify_all();
+
+    for (auto &worker : workers_)
+        worker.join();
+}
+
+void work_stealing_pool::parallel_for(const std::size_t count, const task_func &func)
+{
+    if (count == 0)
+        return;
+
+    std::unique_lock lock{mutex_};
+    func_ = &func;
+    remaining_ = count;
+    exception_ = nullptr;
+
+    // Hand out contiguous blocks, so workers only start stealing once the distribution turns out uneven.
+    // A worker that is still draining the previous call may pick these up right away, which is why the
+    // function is published first.
+    const auto worker_count = std::size(queues_);
+    for (auto worker = 0u; worker < worker_count; ++worker)
+    {
+        const auto begin = count * worker / worker_count;
+        const auto end = count * (worker + 1) / worker_count;
+
+        std::scoped_lock queue_lock{queues_[worker]->mutex};
+        for (auto index = begin; index < end; ++index)
+            queues_[worker]->indices.push_back(index);
+    }
+
+    ++generation_;
+    work_available_.notify_all();
+
+    work_done_.wait(lock, [this]() { return remaining_ == 0; });
+    func_ = nullptr;
+
+    if (exception_)
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+}
+
+void work_stealing_pool::worker_thread(const std::size_t worker)
+{
+    std::size_t seen_generation = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock lock{mutex_};
+            work_available_.wait(lock, [this, seen_generation]() {
+                return shutdown_ || generation_ != seen_generation;
+            });
+
+            if (shutdown_)
+                return;
+
+            seen_generation = generation_;
+        }
+
+        std::size_t index = 0;
+        while (take(worker, index))
+            execute(index, worker);
+    }
+}
+
+auto work_stealing_pool::take(const std::size_t worker, std::size_t &index) -> bool
+{
+    {
+        auto &own = *queues_[worker];
+        std::scoped_lock lock{own.mutex};
+
+        if (!std::empty(own.indices))
+        {
+            index = own.indices.back();
+            own.indices.pop_back();
+            return true;
+        }
+    }
+
+    const auto worker_count = std::size(queues_);
+    for (auto i = 1u; i < worker_count; ++i)
+    {
+        auto &victim = *queues_[(worker + i) % worker_count];
+        std::scoped_lock lock{victim.mutex};
+
+        if (!std::empty(victim.indices))
+        {
+            index = victim.indices.front();
+            victim.indices.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void work_stealing_pool::execute(const std::size_t index, const std::size_t worker)
+{
+    std::exception_ptr exception;
+
+    try
+    {
+        (*func_)(index, worker);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    std::scoped_lock lock{mutex_};
+
+    if (exception && !exception_)
+        exception_ = exception;
+
+    if (--remaining_ == 0)
+        work_done_.notify_all();
+}
+
+} // namespace rua1::batch
@@ -0,0 +1,154 @@
+#include <rua1/batch_runner.h>
+#include <rua1/configuration.h>
+#include <json11.hpp>
+#include <aeon/streams/file_stream.h>
+#include <aeon/streams/stream_reader.h>
+#include <aeon/common/string.h>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void print_usage()
+{
+    std::cerr << "Usage: rua1_batch <config.json> <jobs.json> [--threads N]\n"
+                 "\n"
+                 "jobs.json: {\"jobs\": [{\"name\": \"...\", \"input\": \"...\", \"input_file\": \"...\",\n"
+                 "                       \"acia\": \"acia1\", \"cycles\": 1000000, \"stop_pc\": \"0x8000\"}]}\n";
+}
+
+static auto load_text_file(const std::filesystem::path &path)
+{
+    aeon::streams::file_stream file{path, aeon::streams::access_mode::read, aeon::streams::file_mode::text};
+    aeon::streams::stream_reader reader{file};
+    return reader.read_as_string();
+}
+
+static auto load_job(const json11::Json &json, const std::filesystem::path &base_path)
+{
+    if (!json.is_object())
+        throw std::runtime_error{"Expected job object."};
+
+    rua1::batch::job job;
+    job.name = json["name"].string_value();
+    job.acia = json["acia"].string_value();
+
+    const auto &input = json["input"].string_value();
+    job.input.assign(std::begin(input), std::end(input));
+
+    if (const auto &input_file = json["input_file"].string_value(); !std::empty(input_file))
+    {
+        aeon::streams::file_stream file{base_path / input_file};
+        const auto data = file.read_to_vector();
+        job.input.insert(std::end(job.input), std::begin(data), std::end(data));
+    }
+
+    if (!json["cycles"].is_number())
+        throw std::runtime_error{"Job '" + job.name + "' has no cycle budget."};
+
+    job.cycle_budget = static_cast<std::uint64_t>(json["cycles"].number_value());
+
+    if (const auto &stop_pc = json["stop_pc"].string_value(); !std::empty(stop_pc))
+        job.stop_pc = aeon::common::string::hex_string_to_int<std::uint16_t>(stop_pc);
+
+    return job;
+}
+
+static auto load_jobs(const std::filesystem::path &path)
+{
+    std::string error_string;
+    const auto json = json11::Json::parse(load_text_file(path), error_string, json11::JsonParse::STANDARD);
+
+    if (!std::empty(error_string))
+        throw std::runtime_error{"Jobs parse error: " + error_string};
+
+    // Input files are relative to the jobs file, so a job set can be moved around as a whole.
+    const auto base_path = path.parent_path();
+
+    std::vector<rua1::batch::job> jobs;
+    for (const auto &job : json["jobs"].array_items())
+        jobs.emplace_back(load_job(job, base_path));
+
+    return jobs;
+}
+
+static auto to_json(const rua1::batch::job_result &result)
+{
+    json11::Json::object object{
+        {"name", result.name},
+        {"exit_reason", rua1::batch::batch_runner::to_string(result.exit_reason)},
+        {"cycles", static_cast<double>(result.cycles)},
+        {"instructions", static_cast<double>(result.instructions)},
+        {"pc", aeon::common::string::int_to_hex_string(result.pc)},
+        {"output", std::string{std::begin(result.output), std::end(result.output)}},
+        {"duration_ms", static_cast<double>(result.duration_ns) / 1000000.0},
+        {"worker", static_cast<int>(result.worker)}};
+
+    if (!std::empty(result.error))
+        object.emplace("error", result.error);
+
+    return json11::Json{object};
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        if (argc != 3 && argc != 5)
+        {
+            print_usage();
+            return 1;
+        }
+
+        std::size_t thread_count = 0;
+
+        if (argc == 5)
+        {
+            if (std::string{argv[3]} != "--threads")
+            {
+                print_usage();
+                return 1;
+            }
+
+            thread_count = std::stoul(argv[4]);
+        }
+
+        const rua1::config::configuration config{argv[1]};
+        const auto jobs = load_jobs(argv[2]);
+
+        rua1::batch::batch_runner runner{config, thread_count};
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto results = runner.run(jobs);
+        const auto duration = std::chrono::steady_clock::now() - start;
+
+        std::string output;
+        std::uint64_t total_cycles = 0;
+        auto failed = 0;
+
+        for (const auto &result : results)
+        {
+            output += to_json(result).dump();
+            output += '\n';
+            total_cycles += result.cycles;
+
+            if (result.exit_reason == rua1::batch::job_exit_reason::error)
+                ++failed;
+        }
+
+        std::cout << output << std::flush;
+
+        const auto seconds = std::chrono::duration<double>{duration}.count();
+        std::cerr << std::size(results) << " jobs on " << runner.thread_count() << " threads in " << seconds
+                  << " s, " << (seconds > 0.0 ? static_cast<double>(total_cycles) / seconds / 1000000.0 : 0.0)
+                  << " emulated MHz, " << failed << " failed\n";
+
+        return failed == 0 ? 0 : 2;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -4,12 +4,22 @@
 namespace rua1::model
 {
 
+static auto to_timing_mode(const config::serial_timing timing) noexcept
+{
+    if (timing == config::serial_timing::accurate)
+        return emu6502::acia_6551_timing_mode::accurate;
+
+    return emu6502::acia_6551_timing_mode::turbo;
+}
+
 acia_6551::acia_6551(view::imain_window &main_window, const config::acia_6551_device_config &config)
     : sidebar_toggleable<view::frmacia, view::frmacia_model_interface>{*this, config.name(), main_window}
     , acia_{
           {static_cast<std::uint16_t>(config.send_recv_register()),
            static_cast<std::uint16_t>(config.status_register()), static_cast<std::uint16_t>(config.command_register()),
-           static_cast<std::uint16_t>(config.control_register()), config.simulate_wdc_bugs(), [](const auto value) {}}}
+           static_cast<std::uint16_t>(config.control_register()), config.simulate_wdc_bugs(),
+           to_timing_mode(config.timing()), []() {}}}
+    , host_connection_{}
 {
 }
 
@@ -20,8 +30,25 @@ auto acia_6551::get_device() noexcept -> emu6502::ibus_device &
     return acia_;
 }
 
+void acia_6551::set_host_connection(std::string name)
+{
+    host_connection_ = std::move(name);
+
+    if (view())
+        view()->set_host_connection(host_connection_);
+}
+
+void acia_6551::on_ui_turbo_timing_toggled(const bool enabled)
+{
+    acia_.set_timing_mode(enabled ? emu6502::acia_6551_timing_mode::turbo : emu6502::acia_6551_timing_mode::accurate);
+}
+
 void acia_6551::on_view_created()
 {
+    view()->set_turbo_timing(acia_.timing_mode() == emu6502::acia_6551_timing_mode::turbo);
+
+    if (!std::empty(host_connection_))
+        view()->set_host_connection(host_connection_);
 }
 
 void acia_6551::on_view_destroyed()
@@ -4,9 +4,10 @@
 #include <model/sidebar_toggleable.h>
 #include <view/imain_window.h>
 #include <view/frmacia.h>
-#include <configuration.h>
+#include <rua1/configuration.h>
 #include <emu6502/bus.h>
 #include <emu6502/acia_6551.h>
+#include <string>
 
 namespace rua1::model
 {
@@ -27,11 +28,24 @@ public:
 
     auto get_device() noexcept -> emu6502::ibus_device & override;
 
+    auto get_acia() noexcept -> emu6502::acia_6551 &
+    {
+        return acia_;
+    }
+
+    /*!
+     * Name of the host endpoint the ACIA is connected to, shown in its view.
+     */
+    void set_host_connection(std::string name);
+
 private:
+    void on_ui_turbo_timing_toggled(const bool enabled) override;
+
     void on_view_created() override;
     void on_view_destroyed() override;
 
     emu6502::acia_6551 acia_;
+    std::string host_connection_;
 };
 
 } // namespace rua1::model
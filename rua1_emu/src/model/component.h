@@ -1,6 +1,7 @@
 #pragma once
 
 #include <emu6502/ibus_device.h>
+#include <cstdint>
 
 namespace rua1::model
 {
@@ -18,6 +19,15 @@ public:
     auto operator=(const component &) noexcept -> component & = delete;
 
     virtual auto get_device() noexcept -> emu6502::ibus_device & = 0;
+
+    /*!
+     * Open the view of this component at the address. Returns false if the component has no view that
+     * shows the address.
+     */
+    virtual auto show_address(const std::uint16_t) -> bool
+    {
+        return false;
+    }
 };
 
 } // namespace rua1::model
@@ -4,6 +4,10 @@
 #include <model/acia_6551.h>
 #include <model/via_6522.h>
 
+#if defined(RUA1_HAS_SERIAL_BACKENDS)
+#include <serial/serial_backend_factory.h>
+#endif
+
 namespace rua1::model
 {
 
@@ -13,6 +17,10 @@ computer::computer(view::imain_window &main_window, std::filesystem::path path)
     , bus_{}
     , cpu_{main_window_, bus_}
     , components_{}
+    , heatmap_{main_window_, cpu_.runner(), [this](const auto address) { show_address(address); }}
+#if defined(RUA1_HAS_SERIAL_BACKENDS)
+    , serial_io_{}
+#endif
 {
     const auto &device_config = config_.get_device_config();
     for (const auto &device : device_config)
@@ -21,23 +29,34 @@ computer::computer(view::imain_window &main_window, std::filesystem::path path)
         {
             case config::device_type::rom:
             {
-                auto component = std::make_unique<rom>(main_window_, device->as<config::rom_device_config>());
+                auto component =
+                    std::make_unique<rom>(main_window_, cpu_.runner(), device->as<config::rom_device_config>());
                 bus_.add(component->get_device());
                 components_.emplace_back(std::move(component));
                 break;
             }
             case config::device_type::ram:
             {
-                auto component = std::make_unique<ram>(main_window_, device->as<config::ram_device_config>());
+                auto component =
+                    std::make_unique<ram>(main_window_, cpu_.runner(), device->as<config::ram_device_config>());
                 bus_.add(component->get_device());
                 components_.emplace_back(std::move(component));
                 break;
             }
             case config::device_type::acia_6551:
             {
-                auto component =
-                    std::make_unique<acia_6551>(main_window_, device->as<config::acia_6551_device_config>());
+                const auto &acia_config = device->as<config::acia_6551_device_config>();
+                auto component = std::make_unique<acia_6551>(main_window_, acia_config);
                 bus_.add(component->get_device());
+
+#if defined(RUA1_HAS_SERIAL_BACKENDS)
+                if (auto backend = serial::create_serial_backend(acia_config.backend()))
+                {
+                    component->set_host_connection(backend->name());
+                    serial_io_.attach(component->get_acia(), std::move(backend));
+                }
+#endif
+
                 components_.emplace_back(std::move(component));
                 break;
             }
@@ -52,10 +71,30 @@ computer::computer(view::imain_window &main_window, std::filesystem::path path)
         }
     }
 
+#if defined(RUA1_HAS_SERIAL_BACKENDS)
+    if (serial_io_.port_count() != 0)
+        serial_io_.start();
+#endif
+
+    cpu_.start();
+
     // TODO: The CPU view should be shown by default.
     // cpu_.create_view();
 }
 
-computer::~computer() = default;
+computer::~computer()
+{
+    // Stop emulation before any of the devices on the bus are destroyed.
+    cpu_.shutdown();
+}
+
+void computer::show_address(const std::uint16_t address) const
+{
+    for (const auto &component : components_)
+    {
+        if (component->show_address(address))
+            return;
+    }
+}
 
 } // namespace rua1::model
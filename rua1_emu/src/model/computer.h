@@ -2,9 +2,15 @@
 
 #include <model/cpu.h>
 #include <model/component.h>
+#include <model/heatmap.h>
 #include <view/imain_window.h>
-#include <configuration.h>
+#include <rua1/configuration.h>
 #include <emu6502/bus.h>
+
+#if defined(RUA1_HAS_SERIAL_BACKENDS)
+#include <serial/serial_io_service.h>
+#endif
+
 #include <vector>
 #include <memory>
 
@@ -24,12 +30,23 @@ public:
     auto operator=(const computer &) noexcept -> computer & = delete;
 
 private:
+    /*!
+     * Open the view of the first component that shows the address.
+     */
+    void show_address(const std::uint16_t address) const;
+
     view::imain_window &main_window_;
     config::configuration config_;
     emu6502::bus bus_;
     cpu cpu_;
 
     std::vector<std::unique_ptr<component>> components_;
+    heatmap heatmap_;
+
+#if defined(RUA1_HAS_SERIAL_BACKENDS)
+    // Declared after the components so that the I/O thread is stopped before the ACIAs go away.
+    serial::serial_io_service serial_io_;
+#endif
 };
 
 } // namespace rua1::model
@@ -1,94 +1,151 @@
 #include <model/cpu.h>
+#include <QMetaObject>
 #include <cassert>
 
 namespace rua1::model
 {
 
+static constexpr auto refresh_interval_ms = 16;
+
 cpu::cpu(view::imain_window &main_window, emu6502::bus &bus)
     : sidebar_toggleable<view::frmcpu, view::frmcpu_model_interface>{*this, "CPU", main_window}
-    , cpu_{bus, this}
+    , cpu_{bus}
+    , runner_{cpu_,
+              [this]() {
+                  QMetaObject::invokeMethod(&event_context_, [this]() { on_machine_events(); }, Qt::QueuedConnection);
+              }}
+    , event_context_{}
+    , refresh_timer_{}
+    , snapshot_{}
+    , snapshot_version_{}
+    , breakpoints_{}
     , hex_view_selected_{true}
 {
+    refresh_timer_.setInterval(refresh_interval_ms);
+    QObject::connect(&refresh_timer_, &QTimer::timeout, [this]() { refresh_snapshot(false); });
 }
 
-cpu::~cpu() = default;
+cpu::~cpu()
+{
+    shutdown();
+}
 
-void cpu::on_ui_btn_reset_clicked()
+void cpu::start()
 {
-    cpu_.reset();
+    runner_.start();
+
+    // The reset vector could not be read yet when the cpu was constructed on an empty bus.
+    runner_.reset();
 }
 
-void cpu::on_ui_btn_step_clicked()
+void cpu::shutdown()
 {
-    cpu_.step(1);
+    runner_.shutdown();
 }
 
-void cpu::on_ui_hex_selected()
+void cpu::on_ui_btn_run_clicked()
 {
-    hex_view_selected_ = true;
-    update_ui();
+    runner_.run();
 }
 
-void cpu::on_ui_dec_selected()
+void cpu::on_ui_btn_break_clicked()
 {
-    hex_view_selected_ = false;
-    update_ui();
+    runner_.stop();
 }
 
-void cpu::on_view_created()
+void cpu::on_ui_btn_reset_clicked()
 {
-    view()->set_hex_view(hex_view_selected_);
-    update_ui();
+    runner_.reset();
 }
 
-void cpu::on_view_destroyed()
+void cpu::on_ui_btn_step_clicked()
 {
+    runner_.step(1);
 }
 
-void cpu::update_ui()
+void cpu::on_ui_btn_stepn_clicked(const std::uint32_t count)
 {
-    if (!view())
+    runner_.step(count);
+}
+
+void cpu::on_ui_breakpoint_added(const std::uint16_t address)
+{
+    if (!breakpoints_.insert(address).second)
         return;
 
-    view()->set_pc_value(cpu_.pc());
-    view()->set_sp_value(cpu_.sp());
-    view()->set_a_value(cpu_.a());
-    view()->set_x_value(cpu_.x());
-    view()->set_y_value(cpu_.y());
+    runner_.add_breakpoint(address);
+
+    if (view())
+        view()->add_breakpoint(address);
 }
 
-void cpu::on_cpu_instruction_executed()
+void cpu::on_ui_breakpoint_removed(const std::uint16_t address)
 {
-    update_ui();
+    breakpoints_.erase(address);
+    runner_.remove_breakpoint(address);
 }
 
-void cpu::on_cpu_breakpoint()
+void cpu::on_ui_hex_selected()
 {
+    hex_view_selected_ = true;
+    update_ui();
 }
 
-void cpu::on_cpu_illegal_opcode()
+void cpu::on_ui_dec_selected()
 {
+    hex_view_selected_ = false;
+    update_ui();
 }
 
-void cpu::on_cpu_reset()
+void cpu::on_view_created()
 {
-    update_ui();
+    view()->set_hex_view(hex_view_selected_);
+
+    for (const auto address : breakpoints_)
+        view()->add_breakpoint(address);
+
+    refresh_snapshot(true);
+    refresh_timer_.start();
 }
 
-void cpu::on_cpu_nmi()
+void cpu::on_view_destroyed()
 {
+    refresh_timer_.stop();
 }
 
-void cpu::on_cpu_irq()
+void cpu::update_ui()
 {
+    if (!view())
+        return;
+
+    const auto &state = snapshot_.state;
+    view()->set_running(snapshot_.running);
+    view()->set_pc_value(state.pc);
+    view()->set_sp_value(state.sp);
+    view()->set_a_value(state.a);
+    view()->set_x_value(state.x);
+    view()->set_y_value(state.y);
+    view()->set_stack(state.sp, snapshot_.stack);
 }
 
-void cpu::on_cpu_stack_push(const std::uint8_t byte)
+void cpu::on_machine_events()
 {
+    // The runner publishes a snapshot right before every event, so the latest snapshot already shows the
+    // outcome of all of them. Instead of handling the events one by one, the view is resynchronized once.
+    runner_.discard_events();
+    refresh_snapshot(false);
 }
 
-void cpu::on_cpu_stack_pop()
+void cpu::refresh_snapshot(const bool force)
 {
+    const auto version = runner_.snapshot_version();
+
+    if (!force && version == snapshot_version_)
+        return;
+
+    snapshot_ = runner_.snapshot();
+    snapshot_version_ = version;
+    update_ui();
 }
 
 } // namespace rua1::model
@@ -4,13 +4,15 @@
 #include <view/frmcpu.h>
 #include <emu6502/bus.h>
 #include <emu6502/cpu_mos6502.h>
-#include <emu6502/icpu_debug_interface.h>
+#include <emu6502/machine_runner.h>
+#include <QObject>
+#include <QTimer>
+#include <set>
 
 namespace rua1::model
 {
 
 class cpu final : public sidebar_toggleable<view::frmcpu, view::frmcpu_model_interface>,
-                  public emu6502::icpu_debug_interface,
                   public view::frmcpu_model_interface
 {
 public:
@@ -23,9 +25,29 @@ public:
     cpu(const cpu &) noexcept = delete;
     auto operator=(const cpu &) noexcept -> cpu & = delete;
 
+    /*!
+     * Start executing on the runner thread. Must be called after all devices were added to the bus.
+     * From then on the cpu and bus must only be accessed through the runner.
+     */
+    void start();
+    void shutdown();
+
+    /*!
+     * The runner that executes this cpu, for the models of other parts of the machine.
+     */
+    auto runner() noexcept -> emu6502::machine_runner &
+    {
+        return runner_;
+    }
+
 private:
+    void on_ui_btn_run_clicked() override;
+    void on_ui_btn_break_clicked() override;
     void on_ui_btn_reset_clicked() override;
     void on_ui_btn_step_clicked() override;
+    void on_ui_btn_stepn_clicked(const std::uint32_t count) override;
+    void on_ui_breakpoint_added(const std::uint16_t address) override;
+    void on_ui_breakpoint_removed(const std::uint16_t address) override;
     void on_ui_hex_selected() override;
     void on_ui_dec_selected() override;
 
@@ -33,16 +55,23 @@ private:
     void on_view_destroyed() override;
     void update_ui();
 
-    void on_cpu_instruction_executed() override;
-    void on_cpu_breakpoint() override;
-    void on_cpu_illegal_opcode() override;
-    void on_cpu_reset() override;
-    void on_cpu_nmi() override;
-    void on_cpu_irq() override;
-    void on_cpu_stack_push(const std::uint8_t byte) override;
-    void on_cpu_stack_pop() override;
+    void on_machine_events();
+    void refresh_snapshot(const bool force);
 
     emu6502::cpu_mos6502 cpu_;
+    emu6502::machine_runner runner_;
+
+    // Queued runner notifications are delivered through this object, so they are discarded once it is gone.
+    QObject event_context_;
+
+    // Polls the runner's snapshot while the view is open.
+    QTimer refresh_timer_;
+
+    // Last snapshot taken from the runner. Only accessed on the GUI thread.
+    emu6502::machine_snapshot snapshot_;
+    std::uint32_t snapshot_version_;
+    std::set<std::uint16_t> breakpoints_;
+
     bool hex_view_selected_;
 };
 
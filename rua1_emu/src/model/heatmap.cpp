@@ -0,0 +1,81 @@
+#include <model/heatmap.h>
+
+namespace rua1::model
+{
+
+static constexpr auto refresh_interval_ms = 16;
+
+static constexpr std::size_t address_count = 0x10000;
+
+heatmap::heatmap(view::imain_window &main_window, emu6502::machine_runner &runner,
+                 std::function<void(const std::uint16_t)> show_address)
+    : sidebar_toggleable<view::frmheatmap, view::frmheatmap_model_interface>{*this, "Heatmap", main_window}
+    , runner_{runner}
+    , show_address_{std::move(show_address)}
+    , refresh_timer_{}
+    , previous_{}
+    , deltas_{}
+{
+    for (auto &counts : previous_)
+        counts.assign(address_count, 0);
+
+    for (auto &counts : deltas_)
+        counts.assign(address_count, 0);
+
+    refresh_timer_.setInterval(refresh_interval_ms);
+    QObject::connect(&refresh_timer_, &QTimer::timeout, [this]() { refresh(); });
+}
+
+heatmap::~heatmap() = default;
+
+void heatmap::on_ui_address_clicked(const std::uint16_t address)
+{
+    show_address_(address);
+}
+
+void heatmap::on_view_created()
+{
+    // Counts made before the view was opened would otherwise show up as one burst in the first frame.
+    take_counts();
+
+    runner_.watch_accesses();
+    refresh_timer_.start();
+}
+
+void heatmap::on_view_destroyed()
+{
+    refresh_timer_.stop();
+    runner_.unwatch_accesses();
+}
+
+void heatmap::take_counts()
+{
+    const auto &accesses = runner_.accesses();
+
+    for (auto type = std::size_t{0}; type < emu6502::access_type_count; ++type)
+    {
+        const auto access = static_cast<emu6502::access_type>(type);
+        auto *previous = std::data(previous_[type]);
+        auto *delta = std::data(deltas_[type]);
+
+        for (auto address = std::size_t{0}; address < address_count; ++address)
+        {
+            const auto count = accesses.get(access, static_cast<std::uint16_t>(address));
+
+            // Counts wrap around, which unsigned subtraction handles.
+            delta[address] = count - previous[address];
+            previous[address] = count;
+        }
+    }
+}
+
+void heatmap::refresh()
+{
+    take_counts();
+
+    view()->add_counts(std::data(deltas_[static_cast<std::size_t>(emu6502::access_type::read)]),
+                       std::data(deltas_[static_cast<std::size_t>(emu6502::access_type::write)]),
+                       std::data(deltas_[static_cast<std::size_t>(emu6502::access_type::fetch)]));
+}
+
+} // namespace rua1::model
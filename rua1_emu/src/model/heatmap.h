@@ -0,0 +1,60 @@
+#pragma once
+
+#include <model/sidebar_toggleable.h>
+#include <view/imain_window.h>
+#include <view/frmheatmap.h>
+#include <emu6502/machine_runner.h>
+#include <QTimer>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace rua1::model
+{
+
+/*!
+ * Heatmap of the memory accesses of the running machine.
+ *
+ * The runner only counts accesses while the view is open. At display rate the counts are read and the
+ * difference with the previous frame is passed to the view.
+ */
+class heatmap final : public sidebar_toggleable<view::frmheatmap, view::frmheatmap_model_interface>,
+                      public view::frmheatmap_model_interface
+{
+public:
+    /*!
+     * show_address is called with the address of a clicked pixel.
+     */
+    explicit heatmap(view::imain_window &main_window, emu6502::machine_runner &runner,
+                     std::function<void(const std::uint16_t)> show_address);
+    ~heatmap();
+
+    heatmap(heatmap &&) noexcept = delete;
+    auto operator=(heatmap &&) noexcept -> heatmap & = delete;
+
+    heatmap(const heatmap &) noexcept = delete;
+    auto operator=(const heatmap &) noexcept -> heatmap & = delete;
+
+private:
+    void on_ui_address_clicked(const std::uint16_t address) override;
+
+    void on_view_created() override;
+    void on_view_destroyed() override;
+
+    /*!
+     * Store the counts in previous_ and the difference with the previous counts in deltas_.
+     */
+    void take_counts();
+    void refresh();
+
+    emu6502::machine_runner &runner_;
+    std::function<void(const std::uint16_t)> show_address_;
+    QTimer refresh_timer_;
+
+    // Per access type, indexed by address.
+    std::array<std::vector<std::uint32_t>, emu6502::access_type_count> previous_;
+    std::array<std::vector<std::uint32_t>, emu6502::access_type_count> deltas_;
+};
+
+} // namespace rua1::model
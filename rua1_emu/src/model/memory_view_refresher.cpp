@@ -0,0 +1,76 @@
+#include <model/memory_view_refresher.h>
+#include <algorithm>
+
+namespace rua1::model
+{
+
+static constexpr auto refresh_interval_ms = 16;
+
+memory_view_refresher::memory_view_refresher(emu6502::machine_runner &runner, const std::uint16_t offset,
+                                             const std::uint16_t size)
+    : runner_{runner}
+    , offset_{offset}
+    , size_{size}
+    , view_{nullptr}
+    , refresh_timer_{}
+    , versions_{}
+{
+    refresh_timer_.setInterval(refresh_interval_ms);
+    QObject::connect(&refresh_timer_, &QTimer::timeout, [this]() { refresh(); });
+}
+
+memory_view_refresher::~memory_view_refresher()
+{
+    stop();
+}
+
+void memory_view_refresher::start(view::frmmemory &view)
+{
+    view_ = &view;
+    view_->set_range(offset_, size_);
+
+    // Pages always have a version of at least 2, so every page is passed on with the first refresh.
+    versions_.fill(0);
+
+    runner_.watch_memory();
+    refresh_timer_.start();
+}
+
+void memory_view_refresher::stop()
+{
+    if (!view_)
+        return;
+
+    refresh_timer_.stop();
+    runner_.unwatch_memory();
+    view_ = nullptr;
+}
+
+void memory_view_refresher::refresh()
+{
+    if (size_ == 0)
+        return;
+
+    const auto &memory = runner_.memory();
+    const auto begin = std::uint32_t{offset_};
+    const auto end = begin + size_;
+
+    for (auto page_begin = begin & ~0xFFu; page_begin < end; page_begin += 0x100)
+    {
+        const auto page = static_cast<std::uint8_t>(page_begin >> 8);
+        const auto version = memory.version(page);
+
+        if (version == versions_[page])
+            continue;
+
+        versions_[page] = version;
+
+        // The first and last page can be partially outside of the range.
+        const auto data = memory.page(page);
+        const auto first = std::max(page_begin, begin);
+        const auto last = std::min(page_begin + 0x100, end);
+        view_->set_bytes(static_cast<std::uint16_t>(first), std::data(data) + (first - page_begin), last - first);
+    }
+}
+
+} // namespace rua1::model
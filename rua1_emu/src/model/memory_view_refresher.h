@@ -0,0 +1,49 @@
+#pragma once
+
+#include <view/frmmemory.h>
+#include <emu6502/machine_runner.h>
+#include <QTimer>
+#include <array>
+#include <cstdint>
+
+namespace rua1::model
+{
+
+/*!
+ * Keeps the hex view of a frmmemory up to date with an address range while the view is open.
+ *
+ * Watches the memory of the runner and polls it at display rate. Only the pages whose version changed
+ * since the last poll are copied and passed on, and the view only repaints the rows that differ, so a
+ * running machine that touches a few pages costs a few rows per frame.
+ */
+class memory_view_refresher final
+{
+public:
+    explicit memory_view_refresher(emu6502::machine_runner &runner, const std::uint16_t offset,
+                                   const std::uint16_t size);
+    ~memory_view_refresher();
+
+    memory_view_refresher(memory_view_refresher &&) noexcept = delete;
+    auto operator=(memory_view_refresher &&) noexcept -> memory_view_refresher & = delete;
+
+    memory_view_refresher(const memory_view_refresher &) noexcept = delete;
+    auto operator=(const memory_view_refresher &) noexcept -> memory_view_refresher & = delete;
+
+    void start(view::frmmemory &view);
+    void stop();
+
+private:
+    void refresh();
+
+    emu6502::machine_runner &runner_;
+    std::uint16_t offset_;
+    std::uint16_t size_;
+
+    view::frmmemory *view_;
+    QTimer refresh_timer_;
+
+    // Version of every page when it was last passed to the view.
+    std::array<std::uint32_t, 256> versions_;
+};
+
+} // namespace rua1::model
@@ -4,9 +4,10 @@
 namespace rua1::model
 {
 
-ram::ram(view::imain_window &main_window, const config::ram_device_config &config)
+ram::ram(view::imain_window &main_window, emu6502::machine_runner &runner, const config::ram_device_config &config)
     : sidebar_toggleable<view::frmmemory, view::frmmemory_model_interface>{*this, config.name(), main_window}
     , ram_{static_cast<std::uint16_t>(config.offset()), static_cast<std::uint16_t>(config.size())}
+    , refresher_{runner, ram_.offset(), static_cast<std::uint16_t>(ram_.size())}
 {
 }
 
@@ -17,12 +18,24 @@ auto ram::get_device() noexcept -> emu6502::ibus_device &
     return ram_;
 }
 
+auto ram::show_address(const std::uint16_t address) -> bool
+{
+    if (static_cast<std::uint16_t>(address - ram_.offset()) >= ram_.size())
+        return false;
+
+    show_view();
+    view()->scroll_to(address);
+    return true;
+}
+
 void ram::on_view_created()
 {
+    refresher_.start(*view());
 }
 
 void ram::on_view_destroyed()
 {
+    refresher_.stop();
 }
 
 } // namespace rua1::model
@@ -4,9 +4,10 @@
 namespace rua1::model
 {
 
-rom::rom(view::imain_window &main_window, const config::rom_device_config &config)
+rom::rom(view::imain_window &main_window, emu6502::machine_runner &runner, const config::rom_device_config &config)
     : sidebar_toggleable<view::frmmemory, view::frmmemory_model_interface>{*this, config.name(), main_window}
     , rom_{static_cast<std::uint16_t>(config.offset()), static_cast<std::uint16_t>(config.size())}
+    , refresher_{runner, rom_.offset(), static_cast<std::uint16_t>(rom_.size())}
 {
     aeon::streams::file_stream file{config.file()};
     rom_.load(file, 0);
@@ -19,12 +20,24 @@ auto rom::get_device() noexcept -> emu6502::ibus_device &
     return rom_;
 }
 
+auto rom::show_address(const std::uint16_t address) -> bool
+{
+    if (static_cast<std::uint16_t>(address - rom_.offset()) >= rom_.size())
+        return false;
+
+    show_view();
+    view()->scroll_to(address);
+    return true;
+}
+
 void rom::on_view_created()
 {
+    refresher_.start(*view());
 }
 
 void rom::on_view_destroyed()
 {
+    refresher_.stop();
 }
 
 } // namespace rua1::model
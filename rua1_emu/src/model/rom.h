@@ -2,10 +2,12 @@
 
 #include <model/component.h>
 #include <model/sidebar_toggleable.h>
+#include <model/memory_view_refresher.h>
 #include <view/imain_window.h>
 #include <view/frmmemory.h>
-#include <configuration.h>
+#include <rua1/configuration.h>
 #include <emu6502/bus.h>
+#include <emu6502/machine_runner.h>
 #include <emu6502/rom.h>
 
 namespace rua1::model
@@ -16,7 +18,8 @@ class rom final : public component,
                   public view::frmmemory_model_interface
 {
 public:
-    explicit rom(view::imain_window &main_window, const config::rom_device_config &config);
+    explicit rom(view::imain_window &main_window, emu6502::machine_runner &runner,
+                 const config::rom_device_config &config);
     ~rom();
 
     rom(rom &&) noexcept = delete;
@@ -26,12 +29,14 @@ public:
     auto operator=(const rom &) noexcept -> rom & = delete;
 
     auto get_device() noexcept -> emu6502::ibus_device & override;
+    auto show_address(const std::uint16_t address) -> bool override;
 
 private:
     void on_view_created() override;
     void on_view_destroyed() override;
 
     emu6502::rom rom_;
+    memory_view_refresher refresher_;
 };
 
 } // namespace rua1::model
@@ -35,6 +35,16 @@ protected:
         return view_;
     }
 
+    /*!
+     * Open the view through its sidebar button, so the button stays in sync. Does nothing if the view is
+     * already open.
+     */
+    void show_view() const
+    {
+        if (!view_)
+            sidebar_button_->set_checked(true);
+    }
+
     virtual void on_view_created() = 0;
     virtual void on_view_destroyed() = 0;
 
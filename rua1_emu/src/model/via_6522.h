@@ -4,7 +4,7 @@
 #include <model/sidebar_toggleable.h>
 #include <view/imain_window.h>
 #include <view/frmvia.h>
-#include <configuration.h>
+#include <rua1/configuration.h>
 #include <emu6502/bus.h>
 #include <emu6502/via_6522.h>
 
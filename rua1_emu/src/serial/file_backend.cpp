@@ -0,0 +1,94 @@
+#include <serial/file_backend.h>
+#include <serial/posix_utilities.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rua1::serial
+{
+
+static auto is_named_pipe(const std::filesystem::path &path) noexcept
+{
+    struct stat info
+    {
+    };
+
+    return stat(path.c_str(), &info) == 0 && S_ISFIFO(info.st_mode);
+}
+
+static auto open_input(const std::filesystem::path &path)
+{
+    if (path.empty())
+        return -1;
+
+    // Opening a FIFO for read and write keeps it from reporting end of file while no writer is attached.
+    const auto flags = is_named_pipe(path) ? O_RDWR : O_RDONLY;
+    const auto fd = open(path.c_str(), flags | O_NONBLOCK | O_CLOEXEC);
+
+    if (fd == -1)
+        posix::throw_errno("Could not open serial input " + path.string());
+
+    return fd;
+}
+
+static auto open_output(const std::filesystem::path &path)
+{
+    if (path.empty())
+        return -1;
+
+    // Same for writing into a FIFO without a reader; the data is buffered by the kernel.
+    const auto flags = is_named_pipe(path) ? O_RDWR : (O_WRONLY | O_CREAT | O_TRUNC);
+    const auto fd = open(path.c_str(), flags | O_NONBLOCK | O_CLOEXEC, 0644);
+
+    if (fd == -1)
+        posix::throw_errno("Could not open serial output " + path.string());
+
+    return fd;
+}
+
+file_backend::file_backend(std::filesystem::path input, std::filesystem::path output)
+    : input_{std::move(input)}
+    , output_{std::move(output)}
+    , input_fd_{open_input(input_)}
+    , output_fd_{-1}
+{
+    try
+    {
+        output_fd_ = open_output(output_);
+    }
+    catch (...)
+    {
+        posix::close_fd(input_fd_);
+        throw;
+    }
+}
+
+file_backend::~file_backend()
+{
+    posix::close_fd(output_fd_);
+    posix::close_fd(input_fd_);
+}
+
+auto file_backend::input_fd() const noexcept -> int
+{
+    return input_fd_;
+}
+
+auto file_backend::output_fd() const noexcept -> int
+{
+    return output_fd_;
+}
+
+auto file_backend::disconnect() -> bool
+{
+    // The whole input was replayed.
+    posix::close_fd(input_fd_);
+    return true;
+}
+
+auto file_backend::name() const -> std::string
+{
+    return input_.string() + " -> " + output_.string();
+}
+
+} // namespace rua1::serial
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <serial/serial_backend.h>
+#include <filesystem>
+
+namespace rua1::serial
+{
+
+/*!
+ * Replays a file or FIFO into the receiver and captures the transmitter into another file or FIFO.
+ * Either side may be left empty.
+ */
+class file_backend final : public serial_backend
+{
+public:
+    explicit file_backend(std::filesystem::path input, std::filesystem::path output);
+    ~file_backend() override;
+
+    file_backend(file_backend &&) noexcept = delete;
+    auto operator=(file_backend &&) noexcept -> file_backend & = delete;
+
+    file_backend(const file_backend &) noexcept = delete;
+    auto operator=(const file_backend &) noexcept -> file_backend & = delete;
+
+    auto input_fd() const noexcept -> int override;
+    auto output_fd() const noexcept -> int override;
+    auto disconnect() -> bool override;
+    auto name() const -> std::string override;
+
+private:
+    std::filesystem::path input_;
+    std::filesystem::path output_;
+    int input_fd_;
+    int output_fd_;
+};
+
+} // namespace rua1::serial
@@ -0,0 +1,32 @@
+#include <serial/posix_utilities.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace rua1::serial::posix
+{
+
+void throw_errno(const std::string &message)
+{
+    throw std::runtime_error{message + ": " + std::strerror(errno)};
+}
+
+void set_non_blocking(const int fd)
+{
+    const auto flags = fcntl(fd, F_GETFL);
+
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+        throw_errno("Could not make descriptor non-blocking");
+}
+
+void close_fd(int &fd) noexcept
+{
+    if (fd != -1)
+        close(fd);
+
+    fd = -1;
+}
+
+} // namespace rua1::serial::posix
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+namespace rua1::serial::posix
+{
+
+/*!
+ * Throw a std::runtime_error with the given message and the description of errno.
+ */
+[[noreturn]] void throw_errno(const std::string &message);
+
+void set_non_blocking(const int fd);
+
+/*!
+ * Close the descriptor if it is valid, and set it to -1.
+ */
+void close_fd(int &fd) noexcept;
+
+} // namespace rua1::serial::posix
@@ -0,0 +1,84 @@
+#include <serial/pty_backend.h>
+#include <serial/posix_utilities.h>
+#include <cstdlib>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace rua1::serial
+{
+
+pty_backend::pty_backend(std::filesystem::path link_path)
+    : master_fd_{posix_openpt(O_RDWR | O_NOCTTY)}
+    , slave_fd_{-1}
+    , slave_name_{}
+    , link_path_{std::move(link_path)}
+{
+    if (master_fd_ == -1)
+        posix::throw_errno("Could not open pseudo-terminal");
+
+    try
+    {
+        if (grantpt(master_fd_) == -1 || unlockpt(master_fd_) == -1)
+            posix::throw_errno("Could not unlock pseudo-terminal");
+
+        slave_name_ = ptsname(master_fd_);
+
+        slave_fd_ = open(slave_name_.c_str(), O_RDWR | O_NOCTTY);
+
+        if (slave_fd_ == -1)
+            posix::throw_errno("Could not open pseudo-terminal slave " + slave_name_);
+
+        termios attributes{};
+        if (tcgetattr(slave_fd_, &attributes) == -1)
+            posix::throw_errno("Could not get pseudo-terminal attributes");
+
+        cfmakeraw(&attributes);
+
+        if (tcsetattr(slave_fd_, TCSANOW, &attributes) == -1)
+            posix::throw_errno("Could not set pseudo-terminal attributes");
+
+        posix::set_non_blocking(master_fd_);
+
+        if (!link_path_.empty())
+        {
+            std::filesystem::remove(link_path_);
+            std::filesystem::create_symlink(slave_name_, link_path_);
+        }
+    }
+    catch (...)
+    {
+        posix::close_fd(slave_fd_);
+        posix::close_fd(master_fd_);
+        throw;
+    }
+}
+
+pty_backend::~pty_backend()
+{
+    if (!link_path_.empty())
+    {
+        std::error_code ec;
+        std::filesystem::remove(link_path_, ec);
+    }
+
+    posix::close_fd(slave_fd_);
+    posix::close_fd(master_fd_);
+}
+
+auto pty_backend::input_fd() const noexcept -> int
+{
+    return master_fd_;
+}
+
+auto pty_backend::output_fd() const noexcept -> int
+{
+    return master_fd_;
+}
+
+auto pty_backend::name() const -> std::string
+{
+    return slave_name_;
+}
+
+} // namespace rua1::serial
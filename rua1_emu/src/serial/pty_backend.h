@@ -0,0 +1,41 @@
+#pragma once
+
+#include <serial/serial_backend.h>
+#include <filesystem>
+
+namespace rua1::serial
+{
+
+/*!
+ * Exposes the serial port as a pseudo-terminal in raw mode. Terminal programs such as
+ * minicom or screen can be attached to the slave device.
+ */
+class pty_backend final : public serial_backend
+{
+public:
+    /*!
+     * If link_path is not empty, a symlink to the slave device is created at that location.
+     */
+    explicit pty_backend(std::filesystem::path link_path);
+    ~pty_backend() override;
+
+    pty_backend(pty_backend &&) noexcept = delete;
+    auto operator=(pty_backend &&) noexcept -> pty_backend & = delete;
+
+    pty_backend(const pty_backend &) noexcept = delete;
+    auto operator=(const pty_backend &) noexcept -> pty_backend & = delete;
+
+    auto input_fd() const noexcept -> int override;
+    auto output_fd() const noexcept -> int override;
+    auto name() const -> std::string override;
+
+private:
+    int master_fd_;
+
+    // Keeping the slave open prevents the master from reporting a hangup while no terminal is attached.
+    int slave_fd_;
+    std::string slave_name_;
+    std::filesystem::path link_path_;
+};
+
+} // namespace rua1::serial
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+
+namespace rua1::serial
+{
+
+/*!
+ * A host-side endpoint for an emulated serial port. Backends only own file descriptors;
+ * all reading and writing is done by the serial_io_service thread.
+ */
+class serial_backend
+{
+public:
+    virtual ~serial_backend() = default;
+
+    serial_backend(serial_backend &&) noexcept = delete;
+    auto operator=(serial_backend &&) noexcept -> serial_backend & = delete;
+
+    serial_backend(const serial_backend &) noexcept = delete;
+    auto operator=(const serial_backend &) noexcept -> serial_backend & = delete;
+
+    /*!
+     * Descriptor to read received data from, or -1 if there is currently no input.
+     */
+    virtual auto input_fd() const noexcept -> int = 0;
+
+    /*!
+     * Descriptor to write transmitted data to, or -1 if transmitted data should be discarded.
+     */
+    virtual auto output_fd() const noexcept -> int = 0;
+
+    /*!
+     * Descriptor that signals a pending connection, or -1 if the backend does not accept connections.
+     */
+    virtual auto listen_fd() const noexcept -> int
+    {
+        return -1;
+    }
+
+    /*!
+     * Called when listen_fd is readable. Returns true if input_fd or output_fd changed.
+     */
+    virtual auto accept_connection() -> bool
+    {
+        return false;
+    }
+
+    /*!
+     * Called when the input reached end of file or the peer hung up. Returns true if input_fd or
+     * output_fd changed.
+     */
+    virtual auto disconnect() -> bool
+    {
+        return false;
+    }
+
+    /*!
+     * Human readable description, for example the pty slave device name.
+     */
+    virtual auto name() const -> std::string = 0;
+
+protected:
+    serial_backend() = default;
+};
+
+} // namespace rua1::serial
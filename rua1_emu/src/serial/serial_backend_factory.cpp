@@ -0,0 +1,28 @@
+#include <serial/serial_backend_factory.h>
+#include <serial/pty_backend.h>
+#include <serial/unix_socket_backend.h>
+#include <serial/file_backend.h>
+#include <serial/stdio_backend.h>
+
+namespace rua1::serial
+{
+
+auto create_serial_backend(const config::serial_backend_config &config) -> std::unique_ptr<serial_backend>
+{
+    switch (config.type())
+    {
+        case config::serial_backend_type::pty:
+            return std::make_unique<pty_backend>(config.path());
+        case config::serial_backend_type::unix_socket:
+            return std::make_unique<unix_socket_backend>(config.path());
+        case config::serial_backend_type::file:
+            return std::make_unique<file_backend>(config.input(), config.output());
+        case config::serial_backend_type::stdio:
+            return std::make_unique<stdio_backend>();
+        case config::serial_backend_type::none:
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace rua1::serial
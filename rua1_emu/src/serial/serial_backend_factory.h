@@ -0,0 +1,15 @@
+#pragma once
+
+#include <serial/serial_backend.h>
+#include <rua1/configuration.h>
+#include <memory>
+
+namespace rua1::serial
+{
+
+/*!
+ * Create the backend described by the config. Returns nullptr for serial_backend_type::none.
+ */
+auto create_serial_backend(const config::serial_backend_config &config) -> std::unique_ptr<serial_backend>;
+
+} // namespace rua1::serial
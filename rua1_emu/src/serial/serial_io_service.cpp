@@ -0,0 +1,444 @@
+#include <serial/serial_io_service.h>
+#include <serial/posix_utilities.h>
+#include <cassert>
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace rua1::serial
+{
+
+// Each port registers at most three descriptors with epoll. The slot is encoded in the low bits of the
+// epoll user data, the port index in the remaining bits.
+static constexpr int slot_input = 0;
+static constexpr int slot_output = 1;
+static constexpr int slot_listen = 2;
+static constexpr int slot_count = 3;
+static constexpr int slot_bits = 2;
+
+static constexpr std::uint64_t wake_key = ~std::uint64_t{0};
+
+static constexpr int max_events = 256;
+
+struct serial_io_service::port
+{
+    explicit port(emu6502::acia_6551 &acia, std::unique_ptr<serial_backend> backend, const std::size_t index)
+        : acia{acia}
+        , backend{std::move(backend)}
+        , index{index}
+    {
+        registered_fd.fill(-1);
+        registered_events.fill(0);
+        pollable.fill(true);
+    }
+
+    emu6502::acia_6551 &acia;
+    std::unique_ptr<serial_backend> backend;
+    std::size_t index;
+
+    std::array<int, slot_count> registered_fd{};
+    std::array<std::uint32_t, slot_count> registered_events{};
+
+    // Regular files can not be used with epoll. They are always considered ready instead.
+    std::array<bool, slot_count> pollable{};
+
+    // Host data that did not fit in the receive FIFO yet.
+    std::vector<std::uint8_t> pending_input;
+    std::size_t pending_input_offset{};
+
+    // Guest data that the backend could not accept yet.
+    std::vector<std::uint8_t> pending_output;
+    std::size_t pending_output_offset{};
+
+    port *next_ready{};
+};
+
+static auto make_key(const std::size_t index, const int slot) noexcept -> std::uint64_t
+{
+    return (static_cast<std::uint64_t>(index) << slot_bits) | static_cast<std::uint64_t>(slot);
+}
+
+serial_io_service::serial_io_service()
+    : epoll_fd_{epoll_create1(EPOLL_CLOEXEC)}
+    , wake_fd_{-1}
+    , running_{false}
+    , thread_{}
+    , ports_{}
+    , transmit_ready_{nullptr}
+    , buffer_{}
+{
+    if (epoll_fd_ == -1)
+        posix::throw_errno("Could not create epoll instance");
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (wake_fd_ == -1)
+    {
+        posix::close_fd(epoll_fd_);
+        posix::throw_errno("Could not create eventfd");
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = wake_key;
+
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event) == -1)
+    {
+        posix::close_fd(wake_fd_);
+        posix::close_fd(epoll_fd_);
+        posix::throw_errno("Could not register eventfd");
+    }
+}
+
+serial_io_service::~serial_io_service()
+{
+    stop();
+
+    for (auto &p : ports_)
+        p->acia.set_transmit_notify_func({});
+
+    posix::close_fd(wake_fd_);
+    posix::close_fd(epoll_fd_);
+}
+
+void serial_io_service::attach(emu6502::acia_6551 &acia, std::unique_ptr<serial_backend> backend)
+{
+    assert(!running_);
+    assert(backend);
+
+    auto p = std::make_unique<port>(acia, std::move(backend), std::size(ports_));
+    auto port_ptr = p.get();
+    acia.set_transmit_notify_func([this, port_ptr]() { notify_transmit(*port_ptr); });
+    ports_.emplace_back(std::move(p));
+}
+
+void serial_io_service::start()
+{
+    if (running_)
+        return;
+
+    for (auto &p : ports_)
+        update_interest(*p);
+
+    running_ = true;
+    thread_ = std::thread{[this]() { run(); }};
+}
+
+void serial_io_service::stop()
+{
+    if (!running_)
+        return;
+
+    running_ = false;
+    wake();
+    thread_.join();
+}
+
+void serial_io_service::run()
+{
+    // Writing to a socket whose peer went away must result in EPIPE, not in the process being killed.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    std::array<epoll_event, max_events> events{};
+
+    while (running_)
+    {
+        const auto count = epoll_wait(epoll_fd_, std::data(events), max_events, poll_timeout());
+
+        if (count == -1 && errno != EINTR)
+            break;
+
+        for (auto i = 0; i < count; ++i)
+        {
+            const auto key = events[i].data.u64;
+
+            if (key == wake_key)
+            {
+                std::uint64_t value = 0;
+                [[maybe_unused]] const auto result = read(wake_fd_, &value, sizeof(value));
+
+                auto p = transmit_ready_.exchange(nullptr, std::memory_order_acquire);
+                while (p)
+                {
+                    const auto next = p->next_ready;
+                    flush_output(*p);
+                    p = next;
+                }
+
+                continue;
+            }
+
+            on_event(*ports_[key >> slot_bits], static_cast<int>(key & ((1 << slot_bits) - 1)), events[i].events);
+        }
+
+        // Retry ports that are waiting for room in their receive FIFO, and inputs that can't be polled.
+        for (auto &p : ports_)
+        {
+            if (!std::empty(p->pending_input) || (p->registered_fd[slot_input] != -1 && !p->pollable[slot_input]))
+                read_input(*p);
+        }
+    }
+}
+
+void serial_io_service::wake() const noexcept
+{
+    const std::uint64_t value = 1;
+    [[maybe_unused]] const auto result = write(wake_fd_, &value, sizeof(value));
+}
+
+void serial_io_service::notify_transmit(port &p) noexcept
+{
+    // The ACIA only notifies once per burst, so a port is never on the stack twice.
+    auto head = transmit_ready_.load(std::memory_order_relaxed);
+
+    do
+    {
+        p.next_ready = head;
+    } while (!transmit_ready_.compare_exchange_weak(head, &p, std::memory_order_release, std::memory_order_relaxed));
+
+    if (!head)
+        wake();
+}
+
+void serial_io_service::update_interest(port &p)
+{
+    const auto input_fd = p.backend->input_fd();
+    const auto output_fd = p.backend->output_fd();
+
+    const std::uint32_t input_events =
+        std::empty(p.pending_input) ? static_cast<std::uint32_t>(EPOLLIN | EPOLLRDHUP) : 0u;
+    const std::uint32_t output_events = std::empty(p.pending_output) ? 0u : static_cast<std::uint32_t>(EPOLLOUT);
+
+    // A pty or socket uses the same descriptor in both directions, which epoll only accepts once.
+    if (input_fd != -1 && input_fd == output_fd)
+    {
+        set_interest(p, slot_input, input_fd, input_events | output_events);
+        set_interest(p, slot_output, -1, 0);
+    }
+    else
+    {
+        set_interest(p, slot_input, input_fd, input_events);
+        set_interest(p, slot_output, output_fd, output_events);
+    }
+
+    set_interest(p, slot_listen, p.backend->listen_fd(), EPOLLIN);
+}
+
+void serial_io_service::unregister_data_fds(port &p)
+{
+    set_interest(p, slot_input, -1, 0);
+    set_interest(p, slot_output, -1, 0);
+}
+
+void serial_io_service::set_interest(port &p, const int slot, const int fd, const std::uint32_t events)
+{
+    auto &registered_fd = p.registered_fd[slot];
+    auto &registered_events = p.registered_events[slot];
+
+    if (registered_fd != fd && registered_fd != -1)
+    {
+        if (p.pollable[slot])
+            epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, registered_fd, nullptr);
+
+        registered_fd = -1;
+        registered_events = 0;
+        p.pollable[slot] = true;
+    }
+
+    if (fd == -1)
+        return;
+
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = make_key(p.index, slot);
+
+    if (registered_fd == -1)
+    {
+        registered_fd = fd;
+        registered_events = events;
+
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1)
+        {
+            if (errno != EPERM)
+                posix::throw_errno("Could not register serial port with epoll");
+
+            p.pollable[slot] = false;
+        }
+
+        return;
+    }
+
+    if (registered_events != events && p.pollable[slot])
+    {
+        registered_events = events;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event);
+    }
+}
+
+void serial_io_service::on_event(port &p, const int slot, const std::uint32_t events)
+{
+    if (slot == slot_listen)
+    {
+        on_accept(p);
+        return;
+    }
+
+    if (events & EPOLLOUT)
+        flush_output(p);
+
+    if (slot == slot_input && (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)))
+        read_input(p);
+}
+
+void serial_io_service::on_accept(port &p)
+{
+    unregister_data_fds(p);
+    p.backend->accept_connection();
+    update_interest(p);
+}
+
+void serial_io_service::on_hangup(port &p)
+{
+    // A pty or socket hangs up in both directions, so output its peer did not take yet is lost. Files and
+    // standard input only ran out of input; their output is still flushed.
+    const auto output_lost = p.backend->input_fd() == p.backend->output_fd();
+
+    unregister_data_fds(p);
+    p.backend->disconnect();
+
+    if (output_lost)
+        drop_pending_output(p);
+
+    update_interest(p);
+}
+
+void serial_io_service::drop_pending_output(port &p) noexcept
+{
+    p.pending_output.clear();
+    p.pending_output_offset = 0;
+}
+
+void serial_io_service::read_input(port &p)
+{
+    if (!std::empty(p.pending_input))
+    {
+        const auto remaining = std::size(p.pending_input) - p.pending_input_offset;
+        p.pending_input_offset += p.acia.host_write(std::data(p.pending_input) + p.pending_input_offset, remaining);
+
+        if (p.pending_input_offset != std::size(p.pending_input))
+            return;
+
+        p.pending_input.clear();
+        p.pending_input_offset = 0;
+        update_interest(p);
+    }
+
+    const auto fd = p.backend->input_fd();
+
+    if (fd == -1)
+        return;
+
+    const auto result = read(fd, std::data(buffer_), std::size(buffer_));
+
+    if (result == 0 || (result == -1 && errno != EAGAIN && errno != EINTR))
+    {
+        on_hangup(p);
+        return;
+    }
+
+    if (result < 0)
+        return;
+
+    const auto size = static_cast<std::size_t>(result);
+    const auto written = p.acia.host_write(std::data(buffer_), size);
+
+    if (written < size)
+    {
+        p.pending_input.assign(std::data(buffer_) + written, std::data(buffer_) + size);
+        p.pending_input_offset = 0;
+        update_interest(p);
+    }
+}
+
+void serial_io_service::flush_output(port &p)
+{
+    const auto fd = p.backend->output_fd();
+
+    while (true)
+    {
+        const std::uint8_t *data = nullptr;
+        std::size_t size = 0;
+
+        if (std::empty(p.pending_output))
+        {
+            size = p.acia.host_read(std::data(buffer_), std::size(buffer_));
+
+            if (size == 0)
+                break;
+
+            // Nobody is listening; drop the data like an unplugged cable would.
+            if (fd == -1)
+                continue;
+
+            data = std::data(buffer_);
+        }
+        else
+        {
+            data = std::data(p.pending_output) + p.pending_output_offset;
+            size = std::size(p.pending_output) - p.pending_output_offset;
+        }
+
+        const auto result = write(fd, data, size);
+
+        if (result == -1 && errno != EAGAIN && errno != EINTR)
+        {
+            // The output is gone, so nothing that is pending can be written anymore.
+            drop_pending_output(p);
+            on_hangup(p);
+            return;
+        }
+
+        const auto written = result > 0 ? static_cast<std::size_t>(result) : std::size_t{0};
+
+        if (written == size)
+        {
+            p.pending_output.clear();
+            p.pending_output_offset = 0;
+            continue;
+        }
+
+        if (std::empty(p.pending_output))
+        {
+            p.pending_output.assign(data + written, data + size);
+            p.pending_output_offset = 0;
+        }
+        else
+        {
+            p.pending_output_offset += written;
+        }
+
+        break;
+    }
+
+    update_interest(p);
+}
+
+auto serial_io_service::poll_timeout() const noexcept -> int
+{
+    // Back off to polling while a receive FIFO is full or a regular file is being replayed.
+    for (const auto &p : ports_)
+    {
+        if (!std::empty(p->pending_input) || (p->registered_fd[slot_input] != -1 && !p->pollable[slot_input]))
+            return 1;
+    }
+
+    return -1;
+}
+
+} // namespace rua1::serial
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <serial/serial_backend.h>
+#include <emu6502/acia_6551.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace rua1::serial
+{
+
+/*!
+ * Services the host side of any number of emulated serial ports from a single epoll-driven thread.
+ *
+ * Received data is read from the backends in large chunks and bulk-queued into the ACIA receive
+ * FIFOs. When an ACIA starts a transmit burst, its port is pushed onto a lock-free ready list and
+ * the thread is woken through one shared eventfd, after which the whole transmit FIFO is drained
+ * into the backend with as few write calls as possible.
+ */
+class serial_io_service final
+{
+public:
+    serial_io_service();
+    ~serial_io_service();
+
+    serial_io_service(serial_io_service &&) noexcept = delete;
+    auto operator=(serial_io_service &&) noexcept -> serial_io_service & = delete;
+
+    serial_io_service(const serial_io_service &) noexcept = delete;
+    auto operator=(const serial_io_service &) noexcept -> serial_io_service & = delete;
+
+    /*!
+     * Connect an ACIA to a host backend. Ports can only be attached while the service is stopped.
+     */
+    void attach(emu6502::acia_6551 &acia, std::unique_ptr<serial_backend> backend);
+
+    void start();
+    void stop();
+
+    auto port_count() const noexcept
+    {
+        return std::size(ports_);
+    }
+
+private:
+    struct port;
+
+    void run();
+    void wake() const noexcept;
+    void notify_transmit(port &p) noexcept;
+
+    void update_interest(port &p);
+    void unregister_data_fds(port &p);
+    void set_interest(port &p, const int slot, const int fd, const std::uint32_t events);
+
+    void on_event(port &p, const int slot, const std::uint32_t events);
+    void on_accept(port &p);
+    void on_hangup(port &p);
+    static void drop_pending_output(port &p) noexcept;
+    void read_input(port &p);
+    void flush_output(port &p);
+
+    auto poll_timeout() const noexcept -> int;
+
+    int epoll_fd_;
+    int wake_fd_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+
+    std::vector<std::unique_ptr<port>> ports_;
+
+    // Intrusive lock-free stack of ports that have transmit data. Pushed by emulation threads,
+    // emptied all at once by the I/O thread.
+    std::atomic<port *> transmit_ready_;
+
+    // Scratch buffer, only touched by the I/O thread.
+    std::array<std::uint8_t, 64 * 1024> buffer_;
+};
+
+} // namespace rua1::serial
@@ -0,0 +1,37 @@
+#include <serial/stdio_backend.h>
+#include <serial/posix_utilities.h>
+#include <unistd.h>
+
+namespace rua1::serial
+{
+
+stdio_backend::stdio_backend()
+    : input_fd_{STDIN_FILENO}
+{
+    posix::set_non_blocking(STDIN_FILENO);
+    posix::set_non_blocking(STDOUT_FILENO);
+}
+
+auto stdio_backend::input_fd() const noexcept -> int
+{
+    return input_fd_;
+}
+
+auto stdio_backend::output_fd() const noexcept -> int
+{
+    return STDOUT_FILENO;
+}
+
+auto stdio_backend::disconnect() -> bool
+{
+    // Don't close stdin; just stop reading from it.
+    input_fd_ = -1;
+    return true;
+}
+
+auto stdio_backend::name() const -> std::string
+{
+    return "stdio";
+}
+
+} // namespace rua1::serial
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <serial/serial_backend.h>
+
+namespace rua1::serial
+{
+
+/*!
+ * Connects the serial port to the standard input and output of the emulator process.
+ */
+class stdio_backend final : public serial_backend
+{
+public:
+    stdio_backend();
+    ~stdio_backend() override = default;
+
+    stdio_backend(stdio_backend &&) noexcept = delete;
+    auto operator=(stdio_backend &&) noexcept -> stdio_backend & = delete;
+
+    stdio_backend(const stdio_backend &) noexcept = delete;
+    auto operator=(const stdio_backend &) noexcept -> stdio_backend & = delete;
+
+    auto input_fd() const noexcept -> int override;
+    auto output_fd() const noexcept -> int override;
+    auto disconnect() -> bool override;
+    auto name() const -> std::string override;
+
+private:
+    int input_fd_;
+};
+
+} // namespace rua1::serial
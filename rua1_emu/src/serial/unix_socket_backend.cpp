@@ -0,0 +1,88 @@
+#include <serial/unix_socket_backend.h>
+#include <serial/posix_utilities.h>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace rua1::serial
+{
+
+unix_socket_backend::unix_socket_backend(std::filesystem::path path)
+    : path_{std::move(path)}
+    , listen_fd_{socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)}
+    , client_fd_{-1}
+{
+    if (listen_fd_ == -1)
+        posix::throw_errno("Could not create socket");
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    const auto path_str = path_.string();
+    if (std::size(path_str) >= sizeof(address.sun_path))
+    {
+        posix::close_fd(listen_fd_);
+        throw std::runtime_error{"Socket path is too long: " + path_str};
+    }
+
+    std::strncpy(address.sun_path, path_str.c_str(), sizeof(address.sun_path) - 1);
+
+    // A stale socket from a previous run would make bind fail.
+    unlink(path_str.c_str());
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1 || listen(listen_fd_, 1) == -1)
+    {
+        posix::close_fd(listen_fd_);
+        posix::throw_errno("Could not listen on " + path_str);
+    }
+}
+
+unix_socket_backend::~unix_socket_backend()
+{
+    posix::close_fd(client_fd_);
+    posix::close_fd(listen_fd_);
+    unlink(path_.string().c_str());
+}
+
+auto unix_socket_backend::input_fd() const noexcept -> int
+{
+    return client_fd_;
+}
+
+auto unix_socket_backend::output_fd() const noexcept -> int
+{
+    return client_fd_;
+}
+
+auto unix_socket_backend::listen_fd() const noexcept -> int
+{
+    return listen_fd_;
+}
+
+auto unix_socket_backend::accept_connection() -> bool
+{
+    const auto fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+    if (fd == -1)
+        return false;
+
+    // Only one client at a time; a new connection replaces the old one.
+    posix::close_fd(client_fd_);
+    client_fd_ = fd;
+    return true;
+}
+
+auto unix_socket_backend::disconnect() -> bool
+{
+    posix::close_fd(client_fd_);
+    return true;
+}
+
+auto unix_socket_backend::name() const -> std::string
+{
+    return path_.string();
+}
+
+} // namespace rua1::serial
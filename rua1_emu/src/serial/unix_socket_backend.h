@@ -0,0 +1,38 @@
+#pragma once
+
+#include <serial/serial_backend.h>
+#include <filesystem>
+
+namespace rua1::serial
+{
+
+/*!
+ * Listens on a Unix domain stream socket. One client can be connected at a time; transmitted
+ * data is discarded while nobody is connected.
+ */
+class unix_socket_backend final : public serial_backend
+{
+public:
+    explicit unix_socket_backend(std::filesystem::path path);
+    ~unix_socket_backend() override;
+
+    unix_socket_backend(unix_socket_backend &&) noexcept = delete;
+    auto operator=(unix_socket_backend &&) noexcept -> unix_socket_backend & = delete;
+
+    unix_socket_backend(const unix_socket_backend &) noexcept = delete;
+    auto operator=(const unix_socket_backend &) noexcept -> unix_socket_backend & = delete;
+
+    auto input_fd() const noexcept -> int override;
+    auto output_fd() const noexcept -> int override;
+    auto listen_fd() const noexcept -> int override;
+    auto accept_connection() -> bool override;
+    auto disconnect() -> bool override;
+    auto name() const -> std::string override;
+
+private:
+    std::filesystem::path path_;
+    int listen_fd_;
+    int client_fd_;
+};
+
+} // namespace rua1::serial
@@ -13,10 +13,23 @@ frmacia::frmacia(frmacia_model_interface &model_interface, std::function<void()>
 {
     ui_->setupUi(this);
     setAttribute(Qt::WA_DeleteOnClose);
+
+    connect(ui_->chk_turbo_timing, &QCheckBox::toggled,
+            [this](const auto checked) { model_interface_.on_ui_turbo_timing_toggled(checked); });
 }
 
 frmacia::~frmacia() = default;
 
+void frmacia::set_turbo_timing(const bool val) const
+{
+    ui_->chk_turbo_timing->setChecked(val);
+}
+
+void frmacia::set_host_connection(const std::string &name) const
+{
+    ui_->lbl_host->setText(QString::fromStdString(name));
+}
+
 void frmacia::closeEvent(QCloseEvent *event)
 {
     close_signal_();
@@ -3,6 +3,7 @@
 #include <QtWidgets/QFrame>
 #include <memory>
 #include <functional>
+#include <string>
 
 namespace Ui
 {
@@ -21,6 +22,8 @@ public:
     frmacia_model_interface(const frmacia_model_interface &) noexcept = delete;
     auto operator=(const frmacia_model_interface &) noexcept -> frmacia_model_interface & = delete;
 
+    virtual void on_ui_turbo_timing_toggled(const bool enabled) = 0;
+
 protected:
     frmacia_model_interface() = default;
     virtual ~frmacia_model_interface() = default;
@@ -41,6 +44,13 @@ public:
     frmacia(const frmacia &) noexcept = delete;
     auto operator=(const frmacia &) noexcept -> frmacia & = delete;
 
+    void set_turbo_timing(const bool val) const;
+
+    /*!
+     * Show what the ACIA is connected to on the host, for example the pty device to open.
+     */
+    void set_host_connection(const std::string &name) const;
+
 private:
     void closeEvent(QCloseEvent *event) override;
 
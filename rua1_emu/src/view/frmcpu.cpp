@@ -2,6 +2,7 @@
 #include <view/ui_utilities.h>
 #include <ui_frmcpu.h>
 #include <QCloseEvent>
+#include <QInputDialog>
 
 namespace rua1::view
 {
@@ -24,8 +25,22 @@ frmcpu::frmcpu(frmcpu_model_interface &model_interface, std::function<void()> cl
             model_interface_.on_ui_dec_selected();
     });
 
+    connect(ui_->btn_run, &QPushButton::pressed, [this]() { model_interface_.on_ui_btn_run_clicked(); });
+    connect(ui_->btn_break, &QPushButton::pressed, [this]() { model_interface_.on_ui_btn_break_clicked(); });
     connect(ui_->btn_reset, &QPushButton::pressed, [this]() { model_interface_.on_ui_btn_reset_clicked(); });
     connect(ui_->btn_step, &QPushButton::pressed, [this]() { model_interface_.on_ui_btn_step_clicked(); });
+    connect(ui_->btn_stepn, &QPushButton::pressed, [this]() {
+        auto ok = false;
+        const auto count = ui_->txt_stepn_count->text().toUInt(&ok);
+
+        if (ok && count != 0)
+            model_interface_.on_ui_btn_stepn_clicked(count);
+    });
+
+    connect(ui_->btn_add_breakpoint, &QPushButton::pressed, [this]() { on_btn_add_breakpoint_clicked(); });
+    connect(ui_->btn_delete_breakpoint, &QPushButton::pressed, [this]() { on_btn_delete_breakpoint_clicked(); });
+
+    set_running(false);
 }
 
 frmcpu::~frmcpu() = default;
@@ -36,6 +51,20 @@ void frmcpu::set_hex_view(const bool val) const
     ui_->rdo_dec->setChecked(!val);
 }
 
+void frmcpu::set_running(const bool val) const
+{
+    ui_->btn_run->setEnabled(!val);
+    ui_->btn_break->setEnabled(val);
+    ui_->btn_step->setEnabled(!val);
+    ui_->btn_stepn->setEnabled(!val);
+}
+
+void frmcpu::add_breakpoint(const std::uint16_t address) const
+{
+    auto item = new QListWidgetItem{utilities::uint16_to_qstring(address, true), ui_->lst_breakpoints};
+    item->setData(Qt::UserRole, address);
+}
+
 void frmcpu::set_pc_value(const std::uint16_t val) const
 {
     ui_->lbl_register_pc->setText(utilities::uint16_to_qstring(val, ui_->rdo_hex->isChecked()));
@@ -61,6 +90,57 @@ void frmcpu::set_y_value(const std::uint8_t val) const
     ui_->lbl_register_y->setText(utilities::uint8_to_qstring(val, ui_->rdo_hex->isChecked()));
 }
 
+void frmcpu::set_stack(const std::uint8_t sp, const std::array<std::uint8_t, 256> &stack) const
+{
+    const auto hex = ui_->rdo_hex->isChecked();
+    const auto count = 0xFF - sp;
+
+    // Only the used part of the stack is shown, top of stack first.
+    while (ui_->lst_stack->count() > count)
+        delete ui_->lst_stack->takeItem(ui_->lst_stack->count() - 1);
+
+    while (ui_->lst_stack->count() < count)
+        ui_->lst_stack->addItem(QString{});
+
+    for (auto i = 0; i < count; ++i)
+    {
+        const auto address = static_cast<std::uint8_t>(sp + 1 + i);
+        ui_->lst_stack->item(i)->setText(utilities::uint16_to_qstring(0x0100 + address, true) + ": " +
+                                         utilities::uint8_to_qstring(stack[address], hex));
+    }
+}
+
+void frmcpu::on_btn_add_breakpoint_clicked()
+{
+    auto accepted = false;
+    const auto text = QInputDialog::getText(this, tr("Add breakpoint"), tr("Address (hex):"), QLineEdit::Normal,
+                                            QString{}, &accepted);
+
+    if (!accepted)
+        return;
+
+    auto ok = false;
+    const auto address = text.toUInt(&ok, 16);
+
+    if (!ok || address > 0xFFFF)
+        return;
+
+    model_interface_.on_ui_breakpoint_added(static_cast<std::uint16_t>(address));
+}
+
+void frmcpu::on_btn_delete_breakpoint_clicked()
+{
+    const auto item = ui_->lst_breakpoints->currentItem();
+
+    if (!item)
+        return;
+
+    const auto address = static_cast<std::uint16_t>(item->data(Qt::UserRole).toUInt());
+    delete item;
+
+    model_interface_.on_ui_breakpoint_removed(address);
+}
+
 void frmcpu::closeEvent(QCloseEvent *event)
 {
     close_signal_();
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QtWidgets/QFrame>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <functional>
 
@@ -21,8 +23,14 @@ public:
     frmcpu_model_interface(const frmcpu_model_interface &) noexcept = delete;
     auto operator=(const frmcpu_model_interface &) noexcept -> frmcpu_model_interface & = delete;
 
+    virtual void on_ui_btn_run_clicked() = 0;
+    virtual void on_ui_btn_break_clicked() = 0;
     virtual void on_ui_btn_reset_clicked() = 0;
     virtual void on_ui_btn_step_clicked() = 0;
+    virtual void on_ui_btn_stepn_clicked(const std::uint32_t count) = 0;
+
+    virtual void on_ui_breakpoint_added(const std::uint16_t address) = 0;
+    virtual void on_ui_breakpoint_removed(const std::uint16_t address) = 0;
 
     virtual void on_ui_hex_selected() = 0;
     virtual void on_ui_dec_selected() = 0;
@@ -48,14 +56,21 @@ public:
     auto operator=(const frmcpu &) noexcept -> frmcpu & = delete;
 
     void set_hex_view(const bool val) const;
+    void set_running(const bool val) const;
+
+    void add_breakpoint(const std::uint16_t address) const;
 
     void set_pc_value(const std::uint16_t val) const;
     void set_sp_value(const std::uint8_t val) const;
     void set_a_value(const std::uint8_t val) const;
     void set_x_value(const std::uint8_t val) const;
     void set_y_value(const std::uint8_t val) const;
+    void set_stack(const std::uint8_t sp, const std::array<std::uint8_t, 256> &stack) const;
 
 private:
+    void on_btn_add_breakpoint_clicked();
+    void on_btn_delete_breakpoint_clicked();
+
     void closeEvent(QCloseEvent *event) override;
 
     std::unique_ptr<Ui::frmcpu> ui_;
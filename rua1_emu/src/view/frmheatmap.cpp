@@ -0,0 +1,36 @@
+#include <view/frmheatmap.h>
+#include <ui_frmheatmap.h>
+#include <QCloseEvent>
+
+namespace rua1::view
+{
+
+frmheatmap::frmheatmap(frmheatmap_model_interface &model_interface, std::function<void()> close_signal,
+                       QWidget *parent)
+    : QFrame(parent)
+    , ui_{std::make_unique<Ui::frmheatmap>()}
+    , model_interface_{model_interface}
+    , close_signal_{std::move(close_signal)}
+{
+    ui_->setupUi(this);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    ui_->heatmap->set_address_clicked_handler(
+        [this](const auto address) { model_interface_.on_ui_address_clicked(address); });
+}
+
+frmheatmap::~frmheatmap() = default;
+
+void frmheatmap::add_counts(const std::uint32_t *reads, const std::uint32_t *writes,
+                            const std::uint32_t *fetches) const
+{
+    ui_->heatmap->add_counts(reads, writes, fetches);
+}
+
+void frmheatmap::closeEvent(QCloseEvent *event)
+{
+    close_signal_();
+    event->accept();
+}
+
+} // namespace rua1::view
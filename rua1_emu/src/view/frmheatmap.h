@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QtWidgets/QFrame>
+#include <cstdint>
+#include <memory>
+#include <functional>
+
+namespace Ui
+{
+class frmheatmap;
+}
+
+namespace rua1::view
+{
+
+class frmheatmap_model_interface
+{
+public:
+    frmheatmap_model_interface(frmheatmap_model_interface &&) noexcept = delete;
+    auto operator=(frmheatmap_model_interface &&) noexcept -> frmheatmap_model_interface & = delete;
+
+    frmheatmap_model_interface(const frmheatmap_model_interface &) noexcept = delete;
+    auto operator=(const frmheatmap_model_interface &) noexcept -> frmheatmap_model_interface & = delete;
+
+    virtual void on_ui_address_clicked(const std::uint16_t address) = 0;
+
+protected:
+    frmheatmap_model_interface() = default;
+    virtual ~frmheatmap_model_interface() = default;
+};
+
+class frmheatmap final : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit frmheatmap(frmheatmap_model_interface &model_interface, std::function<void()> close_signal,
+                        QWidget *parent = nullptr);
+    ~frmheatmap();
+
+    frmheatmap(frmheatmap &&) noexcept = delete;
+    auto operator=(frmheatmap &&) noexcept -> frmheatmap & = delete;
+
+    frmheatmap(const frmheatmap &) noexcept = delete;
+    auto operator=(const frmheatmap &) noexcept -> frmheatmap & = delete;
+
+    /*!
+     * Add the accesses made since the previous call, 64K counts of each type.
+     */
+    void add_counts(const std::uint32_t *reads, const std::uint32_t *writes, const std::uint32_t *fetches) const;
+
+private:
+    void closeEvent(QCloseEvent *event) override;
+
+    std::unique_ptr<Ui::frmheatmap> ui_;
+    frmheatmap_model_interface &model_interface_;
+    std::function<void()> close_signal_;
+};
+
+} // namespace rua1::view
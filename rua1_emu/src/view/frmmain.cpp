@@ -1,6 +1,6 @@
 #include <view/frmmain.h>
 #include <view/sidebar_toggle_button.h>
-#include <configuration.h>
+#include <rua1/configuration.h>
 #include <ui_frmmain.h>
 
 namespace rua1::view
@@ -1,4 +1,5 @@
 #include <view/frmmemory.h>
+#include <view/ui_utilities.h>
 #include <ui_frmmemory.h>
 #include <QCloseEvent>
 
@@ -13,10 +14,31 @@ frmmemory::frmmemory(frmmemory_model_interface &model_interface, std::function<v
 {
     ui_->setupUi(this);
     setAttribute(Qt::WA_DeleteOnClose);
+
+    connect(ui_->btn_hex_view, &QPushButton::toggled,
+            [this](const auto checked) { ui_->hex_view->setVisible(checked); });
 }
 
 frmmemory::~frmmemory() = default;
 
+void frmmemory::set_range(const std::uint16_t offset, const std::uint16_t size) const
+{
+    ui_->lbl_offset->setText(utilities::uint16_to_qstring(offset, true));
+    ui_->lbl_size->setText(utilities::uint16_to_qstring(size, true));
+    ui_->hex_view->set_range(offset, size);
+}
+
+void frmmemory::set_bytes(const std::uint16_t address, const std::uint8_t *data, const std::size_t size) const
+{
+    ui_->hex_view->set_bytes(address, data, size);
+}
+
+void frmmemory::scroll_to(const std::uint16_t address) const
+{
+    ui_->btn_hex_view->setChecked(true);
+    ui_->hex_view->scroll_to(address);
+}
+
 void frmmemory::closeEvent(QCloseEvent *event)
 {
     close_signal_();
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QtWidgets/QFrame>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <functional>
 
@@ -41,6 +43,18 @@ public:
     frmmemory(const frmmemory &) noexcept = delete;
     auto operator=(const frmmemory &) noexcept -> frmmemory & = delete;
 
+    void set_range(const std::uint16_t offset, const std::uint16_t size) const;
+
+    /*!
+     * Update the hex view. Only rows whose bytes differ from what is shown are repainted.
+     */
+    void set_bytes(const std::uint16_t address, const std::uint8_t *data, const std::size_t size) const;
+
+    /*!
+     * Show the hex view, scrolled so the row of the address is at the top.
+     */
+    void scroll_to(const std::uint16_t address) const;
+
 private:
     void closeEvent(QCloseEvent *event) override;
 
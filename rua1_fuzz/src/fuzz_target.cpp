@@ -0,0 +1,104 @@
+#include <rua1/fuzz_harness.h>
+#include <rua1/configuration.h>
+#include <aeon/common/string.h>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+/*
+ * libFuzzer entry points. The harness is set up from environment variables, since libFuzzer owns the
+ * command line:
+ *
+ * RUA1_FUZZ_CONFIG        Machine configuration (default: config.json)
+ * RUA1_FUZZ_ACIA          ACIA that receives the input (default: the first one)
+ * RUA1_FUZZ_BOOT_PC       Boot until this PC before taking the snapshot, for example 0x8123
+ * RUA1_FUZZ_BOOT_CYCLES   Boot cycles, or the boot time limit when a boot PC is given
+ * RUA1_FUZZ_CYCLES        Cycle budget per input
+ * RUA1_FUZZ_SENTINEL_PC   Stop an input early when this PC is reached
+ */
+
+static std::unique_ptr<rua1::fuzz::fuzz_harness> harness;
+
+#if defined(__clang__) && defined(__linux__)
+// libFuzzer treats counters in this section as extra coverage, so it is guided by the guest code
+// and not only by the emulator's own branches.
+__attribute__((used, section("__libfuzzer_extra_counters"))) static std::uint8_t guest_edges[1 << 16];
+#endif
+
+static auto get_env(const char *name) -> std::string
+{
+    const auto value = std::getenv(name);
+    return value ? std::string{value} : std::string{};
+}
+
+static auto get_env_pc(const char *name) -> std::optional<std::uint16_t>
+{
+    const auto value = get_env(name);
+
+    if (std::empty(value))
+        return std::nullopt;
+
+    return aeon::common::string::hex_string_to_int<std::uint16_t>(value);
+}
+
+static void create_harness()
+{
+    auto config_path = get_env("RUA1_FUZZ_CONFIG");
+
+    if (std::empty(config_path))
+        config_path = "config.json";
+
+    rua1::fuzz::fuzz_settings settings;
+    settings.acia = get_env("RUA1_FUZZ_ACIA");
+    settings.boot_pc = get_env_pc("RUA1_FUZZ_BOOT_PC");
+    settings.sentinel_pc = get_env_pc("RUA1_FUZZ_SENTINEL_PC");
+
+    if (const auto boot_cycles = get_env("RUA1_FUZZ_BOOT_CYCLES"); !std::empty(boot_cycles))
+        settings.boot_cycles = std::stoull(boot_cycles);
+
+    if (const auto cycles = get_env("RUA1_FUZZ_CYCLES"); !std::empty(cycles))
+        settings.cycle_budget = std::stoull(cycles);
+
+    const rua1::config::configuration config{config_path};
+    harness = std::make_unique<rua1::fuzz::fuzz_harness>(config, settings);
+
+#if defined(__clang__) && defined(__linux__)
+    harness->set_coverage({guest_edges, sizeof(guest_edges), nullptr});
+#endif
+}
+
+extern "C" int LLVMFuzzerInitialize([[maybe_unused]] int *argc, [[maybe_unused]] char ***argv)
+{
+    try
+    {
+        create_harness();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Could not set up the fuzz harness: " << e.what() << '\n';
+        std::exit(1);
+    }
+
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, const std::size_t size)
+{
+    const auto result = harness->run(data, size);
+
+    if (result.finding != rua1::fuzz::fuzz_finding::none)
+    {
+        std::cerr << "Finding: " << rua1::fuzz::fuzz_harness::to_string(result.finding) << " at PC "
+                  << aeon::common::string::int_to_hex_string(result.pc);
+
+        if (result.finding == rua1::fuzz::fuzz_finding::rom_write)
+            std::cerr << ", address " << aeon::common::string::int_to_hex_string(result.address);
+
+        std::cerr << " after " << result.cycles << " cycles\n";
+
+        // libFuzzer saves the input that led here.
+        std::abort();
+    }
+
+    return 0;
+}
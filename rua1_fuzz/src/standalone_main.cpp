@@ -0,0 +1,39 @@
+#include <aeon/streams/file_stream.h>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// Replays inputs without libFuzzer, for compilers that do not support -fsanitize=fuzzer and for
+// reproducing findings in a debugger.
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv);
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, const std::size_t size);
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: rua1_fuzz <input>...\n";
+        return 1;
+    }
+
+    try
+    {
+        LLVMFuzzerInitialize(&argc, &argv);
+
+        for (auto i = 1; i < argc; ++i)
+        {
+            aeon::streams::file_stream file{argv[i]};
+            const auto input = file.read_to_vector();
+            LLVMFuzzerTestOneInput(std::data(input), std::size(input));
+            std::cerr << argv[i] << ": ok\n";
+        }
+
+        return 0;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
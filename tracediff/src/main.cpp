@@ -0,0 +1,201 @@
+#include <emu6502/instruction_trace.h>
+#include <emu6502/trace_compare.h>
+#include <disasm6502/disasm.h>
+#include <disasm6502/formatter.h>
+#include <disasm6502/symbol_table.h>
+#include <aeon/common/string.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <tuple>
+
+static void print_usage()
+{
+    std::cerr << "Usage: tracediff <trace a> <trace b> [--context N] [--threads N] [--symbols FILE]\n";
+}
+
+// Traces are recorded by cpu_mos6502, which implements the documented NMOS instructions.
+static constexpr auto target = disasm6502::cpu_target::target_6502;
+
+static auto disassemble(const emu6502::trace_record &record, const disasm6502::symbol_table &symbols)
+{
+    const std::array<std::uint8_t, 3> bytes{record.opcode, record.operand[0], record.operand[1]};
+    const auto instruction = disasm6502::decode(
+        aeon::common::span<const std::uint8_t>{std::data(bytes), std::size(bytes)}, record.pc, target);
+
+    std::array<char, disasm6502::max_formatted_length> text;
+    const auto length = disasm6502::format(instruction, std::data(text), target);
+
+    std::array<char, 64> symbol;
+    const auto symbol_length = disasm6502::format_symbol(instruction, symbols, std::data(symbol), std::size(symbol));
+
+    std::string bytes_string;
+    for (auto i = 0; i < instruction.length; ++i)
+        bytes_string += aeon::common::string::int_to_hex_string(bytes[i]) + ' ';
+
+    return std::tuple{bytes_string, std::string{std::data(text), length},
+                      std::string{std::data(symbol), symbol_length}};
+}
+
+static auto differing_fields(const emu6502::trace_record &a, const emu6502::trace_record &b)
+{
+    std::string fields;
+
+    const auto add = [&fields](const bool differs, const char *name) {
+        if (!differs)
+            return;
+
+        if (!std::empty(fields))
+            fields += ", ";
+
+        fields += name;
+    };
+
+    add(a.cycle != b.cycle, "cycle");
+    add(a.pc != b.pc, "pc");
+    add(a.opcode != b.opcode || a.operand != b.operand, "instruction");
+    add(a.effective_address != b.effective_address, "effective address");
+    add(a.a != b.a, "a");
+    add(a.x != b.x, "x");
+    add(a.y != b.y, "y");
+    add(a.sp != b.sp, "sp");
+    add(a.status != b.status, "status");
+
+    return fields;
+}
+
+static void print_record(const char *prefix, const std::uint64_t index, const emu6502::trace_record &record,
+                         const disasm6502::symbol_table &symbols)
+{
+    const auto [bytes, disassembly, symbol] = disassemble(record, symbols);
+
+    std::cout << prefix << std::right << std::setw(14) << index << ' ';
+    std::cout << std::setw(14) << record.cycle << "  ";
+    std::cout << aeon::common::string::int_to_hex_string(record.pc) << "  ";
+    std::cout << std::left << std::setw(10) << bytes;
+    std::cout << std::setw(16) << disassembly;
+    std::cout << "A=" << aeon::common::string::int_to_hex_string(record.a);
+    std::cout << " X=" << aeon::common::string::int_to_hex_string(record.x);
+    std::cout << " Y=" << aeon::common::string::int_to_hex_string(record.y);
+    std::cout << " SP=" << aeon::common::string::int_to_hex_string(record.sp);
+    std::cout << " P=" << aeon::common::string::int_to_hex_string(record.status);
+    std::cout << " EA=" << aeon::common::string::int_to_hex_string(record.effective_address);
+
+    if (!std::empty(symbol))
+        std::cout << "  ; " << symbol;
+
+    std::cout << '\n';
+}
+
+static void print_context(const emu6502::instruction_trace_reader &a, const emu6502::instruction_trace_reader &b,
+                          const std::uint64_t divergence, const std::uint64_t context,
+                          const disasm6502::symbol_table &symbols)
+{
+    const auto first = std::max({divergence - std::min(divergence, context), a.first_index(), b.first_index()});
+
+    // Up to the divergence both traces hold the same records, so those are printed once.
+    for (auto index = first; index < divergence; ++index)
+        print_record("  ", index, a.read(index), symbols);
+
+    for (auto index = divergence; index <= divergence + context; ++index)
+    {
+        emu6502::trace_record record_a;
+        emu6502::trace_record record_b;
+        const auto has_a = a.read(index, &record_a, 1) == 1;
+        const auto has_b = b.read(index, &record_b, 1) == 1;
+
+        if (!has_a && !has_b)
+            break;
+
+        if (has_a)
+            print_record(index == divergence ? "a>" : "a ", index, record_a, symbols);
+        else
+            std::cout << "a " << std::right << std::setw(14) << index << "  (end of trace)\n";
+
+        if (has_b)
+            print_record(index == divergence ? "b>" : "b ", index, record_b, symbols);
+        else
+            std::cout << "b " << std::right << std::setw(14) << index << "  (end of trace)\n";
+    }
+}
+
+static void print_summary(const char *name, const emu6502::instruction_trace_reader &trace)
+{
+    std::cout << name << ": records " << trace.first_index() << " to " << trace.first_index() + trace.record_count()
+              << " (" << trace.record_count() << " records)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        if (argc < 3 || argc % 2 == 0)
+        {
+            print_usage();
+            return 1;
+        }
+
+        std::uint64_t context = 8;
+        emu6502::trace_compare_settings settings;
+        disasm6502::symbol_table symbols;
+
+        for (auto i = 3; i < argc; i += 2)
+        {
+            const std::string option{argv[i]};
+
+            if (option == "--context")
+            {
+                context = std::stoull(argv[i + 1]);
+            }
+            else if (option == "--threads")
+            {
+                settings.thread_count = std::stoul(argv[i + 1]);
+            }
+            else if (option == "--symbols")
+            {
+                symbols.load(argv[i + 1]);
+            }
+            else
+            {
+                print_usage();
+                return 1;
+            }
+        }
+
+        const emu6502::instruction_trace_reader a{argv[1]};
+        const emu6502::instruction_trace_reader b{argv[2]};
+
+        print_summary("a", a);
+        print_summary("b", b);
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto divergence = emu6502::find_trace_divergence(a, b, settings);
+        const auto duration = std::chrono::duration<double>{std::chrono::steady_clock::now() - start}.count();
+
+        if (!divergence)
+        {
+            std::cout << "Traces are identical (compared in " << duration << " s).\n";
+            return 0;
+        }
+
+        std::cout << "First difference at record " << *divergence << " (found in " << duration << " s)";
+
+        emu6502::trace_record record_a;
+        emu6502::trace_record record_b;
+        if (a.read(*divergence, &record_a, 1) == 1 && b.read(*divergence, &record_b, 1) == 1)
+            std::cout << " in: " << differing_fields(record_a, record_b);
+
+        std::cout << "\n\n";
+
+        print_context(a, b, *divergence, context, symbols);
+        return 2;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
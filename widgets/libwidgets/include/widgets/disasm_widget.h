@@ -1,17 +1,32 @@
 #pragma once
 
-#include <QWidget>
+#include <disasm6502/disassembly_cache.h>
+#include <QAbstractScrollArea>
+#include <QStaticText>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace rua1::widgets
 {
 
-class disasm_widget final : public QWidget
+/*!
+ * Disassembly view of a disassembly_cache, one item per row, with the item at the program counter
+ * highlighted.
+ *
+ * The view is virtualized: only the items of the visible rows are fetched from the cache, and a paint
+ * event only draws the rows in its exposed rectangle. Scrolling by whole rows moves the pixels that stay
+ * visible, so just the rows scrolled in are painted. The laid out text of each row is kept until the
+ * item at that address changes.
+ */
+class disasm_widget final : public QAbstractScrollArea
 {
     Q_OBJECT
 
 public:
     explicit disasm_widget(QWidget *parent = nullptr);
-    ~disasm_widget() = default;
+    ~disasm_widget();
 
     disasm_widget(disasm_widget &&) noexcept = delete;
     auto operator=(disasm_widget &&) noexcept -> disasm_widget & = delete;
@@ -19,11 +34,75 @@ public:
     disasm_widget(const disasm_widget &) noexcept = delete;
     auto operator=(const disasm_widget &) noexcept -> disasm_widget & = delete;
 
+    /*!
+     * Show the items of this cache, which must stay alive until another cache (or null) is set. The cache
+     * is only read from the GUI thread, when painting and from the calls below.
+     */
+    void set_cache(const disasm6502::disassembly_cache *cache);
+
+    /*!
+     * Highlight the item that contains the program counter. If it is not fully visible, the view scrolls
+     * so it is a few rows from the top.
+     */
+    void set_pc(const std::uint16_t pc);
+
+    /*!
+     * Make the item that contains the address the top row.
+     */
+    void scroll_to(const std::uint16_t address);
+
+    /*!
+     * Fetch the visible items again after the cache changed. Only the rows whose item changed are
+     * repainted, so a single step typically repaints nothing but the rows of the old and new program
+     * counter.
+     */
+    void refresh();
+
 private:
-    void paintEvent(QPaintEvent *pe) override;
+    struct row_text
+    {
+        disasm6502::decoded_instruction instruction;
+        QStaticText text;
+    };
+
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+    void on_scroll_action(const int action);
+
+    /*!
+     * The start of the item the given number of rows below (or above, when negative) the item that
+     * contains the address, stopping at the ends of the cache.
+     */
+    auto scrolled(const std::uint16_t address, const int rows) const -> std::uint16_t;
+
+    auto offset_of(const std::uint16_t address) const noexcept -> int;
+    auto address_column_width() const noexcept -> int;
+    auto full_row_count() const noexcept -> int;
+    auto row_of(const std::uint16_t address) const noexcept -> int;
+    void fetch_rows();
+    void update_row(const int row);
+    void update_scroll_range();
+    auto text_of(const disasm6502::decoded_instruction &instruction) -> const QStaticText &;
+
+    const disasm6502::disassembly_cache *cache_;
+
+    // The items of the visible rows, including a partially visible last row.
+    std::vector<disasm6502::decoded_instruction> rows_;
+
+    // Laid out text by item address. Cleared when it gets large, so it never holds much more than what
+    // was on screen recently.
+    std::unordered_map<std::uint16_t, row_text> texts_;
+
+    std::uint16_t top_;
+    std::optional<std::uint16_t> pc_;
+    int wheel_delta_;
 
     QSize charsize_;
     QColor address_background_;
+    QColor pc_background_;
 };
 
 } // namespace rua1::widgets
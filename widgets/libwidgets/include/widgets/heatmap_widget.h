@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QImage>
+#include <QWidget>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace rua1::widgets
+{
+
+/*!
+ * Heatmap of the 64KB address space, one pixel per address and one row of pixels per page. Writes heat up
+ * the red channel, reads the green channel and instruction fetches the blue channel. An address that is
+ * no longer accessed fades back to black.
+ *
+ * add_counts is meant to be called once per display frame. It cools down every address, heats up the
+ * accessed ones and writes the pixels straight into the image, which painting only scales up.
+ */
+class heatmap_widget final : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t address_count = 0x10000;
+
+    explicit heatmap_widget(QWidget *parent = nullptr);
+    ~heatmap_widget();
+
+    heatmap_widget(heatmap_widget &&) noexcept = delete;
+    auto operator=(heatmap_widget &&) noexcept -> heatmap_widget & = delete;
+
+    heatmap_widget(const heatmap_widget &) noexcept = delete;
+    auto operator=(const heatmap_widget &) noexcept -> heatmap_widget & = delete;
+
+    /*!
+     * Called with the address of a pixel when it is clicked.
+     */
+    void set_address_clicked_handler(std::function<void(const std::uint16_t)> handler);
+
+    /*!
+     * Add the accesses made since the previous call; each array holds address_count counts.
+     */
+    void add_counts(const std::uint32_t *reads, const std::uint32_t *writes, const std::uint32_t *fetches);
+
+    void clear();
+
+    auto sizeHint() const -> QSize override;
+
+private:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+    // Heat per address of the reads, writes and fetches.
+    std::array<std::vector<std::uint32_t>, 3> heat_;
+    QImage image_;
+    std::function<void(const std::uint16_t)> address_clicked_handler_;
+};
+
+} // namespace rua1::widgets
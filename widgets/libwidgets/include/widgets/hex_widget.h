@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QStaticText>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace rua1::widgets
+{
+
+/*!
+ * Hex and ASCII view of an address range, 16 bytes per row.
+ *
+ * The widget keeps its own copy of the bytes, which is changed through set_bytes. Only rows whose bytes
+ * actually changed are repainted, and only if they are visible; a paint event only draws the rows in its
+ * exposed rectangle. The laid out text of a row is kept until its bytes change.
+ */
+class hex_widget final : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit hex_widget(QWidget *parent = nullptr);
+    ~hex_widget();
+
+    hex_widget(hex_widget &&) noexcept = delete;
+    auto operator=(hex_widget &&) noexcept -> hex_widget & = delete;
+
+    hex_widget(const hex_widget &) noexcept = delete;
+    auto operator=(const hex_widget &) noexcept -> hex_widget & = delete;
+
+    /*!
+     * Show size bytes (at most 64KB) starting at the address, all zero until set_bytes is called.
+     */
+    void set_range(const std::uint16_t address, const std::size_t size);
+
+    /*!
+     * Update bytes in the range; bytes outside of it are ignored.
+     */
+    void set_bytes(const std::uint16_t address, const std::uint8_t *data, const std::size_t size);
+
+    /*!
+     * Make the row that contains the address the top row.
+     */
+    void scroll_to(const std::uint16_t address);
+
+private:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+    auto row_count() const noexcept -> int;
+    auto full_row_count() const noexcept -> int;
+    auto address_column_width() const noexcept -> int;
+    void update_row(const int row);
+    void update_scroll_range();
+    auto text_of(const int row) -> const QStaticText &;
+
+    std::uint16_t address_;
+    std::vector<std::uint8_t> bytes_;
+
+    // Laid out text by row. Cleared when it gets large.
+    std::unordered_map<int, QStaticText> texts_;
+
+    int top_row_;
+
+    QSize charsize_;
+    QColor address_background_;
+};
+
+} // namespace rua1::widgets
@@ -1,13 +1,76 @@
 #include <widgets/disasm_widget.h>
-#include <QPainter>
+#include <disasm6502/formatter.h>
 #include <QFontDatabase>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
 
 namespace rua1::widgets
 {
 
+// Rows an item is kept from the top when the view scrolls to the program counter.
+static constexpr auto pc_context_rows = 4;
+
+// A standard wheel notch of 120 scrolls three rows.
+static constexpr auto wheel_delta_per_row = 120 / 3;
+
+static constexpr std::size_t max_cached_texts = 4096;
+
+static auto same_item(const disasm6502::decoded_instruction &a, const disasm6502::decoded_instruction &b) noexcept
+{
+    return a.address == b.address && a.operand == b.operand && a.opcode == b.opcode && a.length == b.length &&
+           a.mode == b.mode && a.kind == b.kind;
+}
+
+static auto contains(const disasm6502::decoded_instruction &instruction, const std::uint16_t address) noexcept
+{
+    return static_cast<std::uint16_t>(address - instruction.address) < instruction.length;
+}
+
+/*!
+ * Write "aaaa  bb bb bb  text" for an item. The buffer needs room for 16 characters plus the formatted text.
+ */
+static auto format_row(const disasm6502::decoded_instruction &instruction, const disasm6502::cpu_target target,
+                       char *buffer) noexcept -> std::size_t
+{
+    auto *destination = disasm6502::format_hex16(instruction.address, buffer);
+    *destination++ = ' ';
+    *destination++ = ' ';
+
+    // A data word holds its value in the operand; everything else starts with the opcode byte.
+    const auto word = instruction.kind == disasm6502::record_kind::data_word;
+    const std::array<std::uint8_t, 3> bytes{static_cast<std::uint8_t>(word ? instruction.operand : instruction.opcode),
+                                            static_cast<std::uint8_t>(word ? instruction.operand >> 8
+                                                                           : instruction.operand),
+                                            static_cast<std::uint8_t>(instruction.operand >> 8)};
+
+    auto *const bytes_start = destination;
+    for (auto i = 0; i < instruction.length; ++i)
+    {
+        destination = disasm6502::format_hex8(bytes[i], destination);
+        *destination++ = ' ';
+    }
+
+    destination = std::fill_n(destination, 10 - (destination - bytes_start), ' ');
+    destination += disasm6502::format(instruction, destination, target);
+    return static_cast<std::size_t>(destination - buffer);
+}
+
 disasm_widget::disasm_widget(QWidget *parent)
-    : QWidget{parent}
+    : QAbstractScrollArea{parent}
+    , cache_{nullptr}
+    , rows_{}
+    , texts_{}
+    , top_{}
+    , pc_{}
+    , wheel_delta_{}
+    , charsize_{}
     , address_background_{0xF0, 0xF0, 0xFE}
+    , pc_background_{0xFF, 0xEE, 0xB0}
 {
     auto f = QFontDatabase::systemFont(QFontDatabase::FixedFont);
     f.setPointSize(12);
@@ -16,15 +79,292 @@ disasm_widget::disasm_widget(QWidget *parent)
 
     QFontMetrics metrics{f};
     charsize_ = QSize{metrics.width(" "), metrics.height()};
+
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+
+    // Every paint event fills its whole rectangle, so the background doesn't have to be erased first.
+    viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
+
+    connect(verticalScrollBar(), &QAbstractSlider::actionTriggered, this,
+            [this](const int action) { on_scroll_action(action); });
+
+    update_scroll_range();
+}
+
+disasm_widget::~disasm_widget() = default;
+
+void disasm_widget::set_cache(const disasm6502::disassembly_cache *cache)
+{
+    cache_ = cache;
+    texts_.clear();
+    top_ = cache_ ? cache_->begin_address() : 0;
+
+    fetch_rows();
+    update_scroll_range();
+    verticalScrollBar()->setValue(0);
+    viewport()->update();
+}
+
+void disasm_widget::set_pc(const std::uint16_t pc)
+{
+    if (pc_ == pc)
+        return;
+
+    const auto previous = pc_;
+    pc_ = pc;
+
+    const auto row = row_of(pc);
+    if ((row < 0 || row >= full_row_count()) && cache_ && cache_->contains(pc))
+        scroll_to(scrolled(pc, -pc_context_rows));
+
+    // After scrolling, so the rows are repainted where they are now.
+    if (previous)
+        update_row(row_of(*previous));
+
+    update_row(row_of(pc));
+}
+
+void disasm_widget::scroll_to(const std::uint16_t address)
+{
+    if (!cache_ || !cache_->contains(address))
+        return;
+
+    verticalScrollBar()->setValue(offset_of(cache_->item(address).address));
+}
+
+void disasm_widget::refresh()
+{
+    const auto previous = rows_;
+    fetch_rows();
+
+    // A write can merge the top row into the item before it; keep the scroll bar on the new top.
+    if (cache_)
+        verticalScrollBar()->setValue(offset_of(top_));
+
+    const auto count = std::max(std::size(previous), std::size(rows_));
+    for (auto row = std::size_t{0}; row < count; ++row)
+    {
+        if (row >= std::size(previous) || row >= std::size(rows_) || !same_item(previous[row], rows_[row]))
+            update_row(static_cast<int>(row));
+    }
 }
 
-void disasm_widget::paintEvent(QPaintEvent *pe)
+void disasm_widget::paintEvent(QPaintEvent *event)
 {
-    QPainter painter{this};
-    painter.drawLine(0, 0, width(), height());
+    QPainter painter{viewport()};
+    painter.setPen(palette().color(QPalette::Text));
+
+    const auto &rect = event->rect();
+    const auto row_height = charsize_.height();
+    const auto width = viewport()->width();
+
+    painter.fillRect(rect, palette().base());
+    painter.fillRect(QRect{0, rect.top(), address_column_width(), rect.height()}, address_background_);
+
+    const auto first = rect.top() / row_height;
+    const auto last = std::min(rect.bottom() / row_height, static_cast<int>(std::size(rows_)) - 1);
+
+    for (auto row = first; row <= last; ++row)
+    {
+        const auto &instruction = rows_[static_cast<std::size_t>(row)];
+        const auto y = row * row_height;
+
+        if (pc_ && contains(instruction, *pc_))
+            painter.fillRect(QRect{0, y, width, row_height}, pc_background_);
+
+        painter.drawStaticText(QPoint{charsize_.width(), y}, text_of(instruction));
+    }
+}
+
+void disasm_widget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    fetch_rows();
+    update_scroll_range();
+}
+
+void disasm_widget::wheelEvent(QWheelEvent *event)
+{
+    event->accept();
+
+    if (!cache_)
+        return;
+
+    // Smooth scrolling devices send fractions of a notch, which add up until they make a whole row.
+    wheel_delta_ += event->angleDelta().y();
+    const auto rows = wheel_delta_ / wheel_delta_per_row;
+    wheel_delta_ -= rows * wheel_delta_per_row;
+
+    if (rows != 0)
+        scroll_to(scrolled(top_, -rows));
+}
+
+void disasm_widget::scrollContentsBy(int, int)
+{
+    if (!cache_)
+        return;
+
+    const auto address = static_cast<std::uint16_t>(cache_->begin_address() + verticalScrollBar()->value());
+    const auto top = cache_->item(address).address;
+
+    if (top == top_)
+        return;
+
+    // Rows that stay visible are moved rather than painted again.
+    const auto down = row_of(top);
+    const auto previous_top = top_;
+    top_ = top;
+    fetch_rows();
+    const auto up = row_of(previous_top);
+
+    const auto row_height = charsize_.height();
+
+    if (down > 0)
+        viewport()->scroll(0, -down * row_height);
+    else if (up > 0)
+        viewport()->scroll(0, up * row_height);
+    else
+        viewport()->update();
+}
+
+void disasm_widget::on_scroll_action(const int action)
+{
+    if (!cache_)
+        return;
+
+    // The scroll bar counts bytes, but steps should move whole rows.
+    const auto page = std::max(full_row_count() - 1, 1);
+    auto rows = 0;
+
+    switch (action)
+    {
+        case QAbstractSlider::SliderSingleStepAdd:
+            rows = 1;
+            break;
+        case QAbstractSlider::SliderSingleStepSub:
+            rows = -1;
+            break;
+        case QAbstractSlider::SliderPageStepAdd:
+            rows = page;
+            break;
+        case QAbstractSlider::SliderPageStepSub:
+            rows = -page;
+            break;
+        default:
+            return;
+    }
+
+    verticalScrollBar()->setSliderPosition(offset_of(scrolled(top_, rows)));
+}
+
+auto disasm_widget::scrolled(const std::uint16_t address, const int rows) const -> std::uint16_t
+{
+    const auto count = static_cast<std::size_t>(std::abs(rows));
+    std::vector<disasm6502::decoded_instruction> items(count + 1);
+
+    const auto window = rows > 0 ? cache_->window(address, 0, count, std::data(items))
+                                 : cache_->window(address, count, 0, std::data(items));
+
+    if (window.size == 0)
+        return address;
+
+    return rows > 0 ? items[window.size - 1].address : items[0].address;
+}
+
+auto disasm_widget::offset_of(const std::uint16_t address) const noexcept -> int
+{
+    return static_cast<std::uint16_t>(address - cache_->begin_address());
+}
+
+auto disasm_widget::address_column_width() const noexcept -> int
+{
+    // The 4 address digits with a character of margin on both sides.
+    return charsize_.width() * 6;
+}
+
+auto disasm_widget::full_row_count() const noexcept -> int
+{
+    return viewport()->height() / charsize_.height();
+}
+
+auto disasm_widget::row_of(const std::uint16_t address) const noexcept -> int
+{
+    const auto row = std::find_if(std::begin(rows_), std::end(rows_),
+                                  [address](const auto &instruction) { return contains(instruction, address); });
+
+    if (row == std::end(rows_))
+        return -1;
+
+    return static_cast<int>(row - std::begin(rows_));
+}
+
+void disasm_widget::fetch_rows()
+{
+    if (!cache_)
+    {
+        rows_.clear();
+        return;
+    }
+
+    rows_.resize(static_cast<std::size_t>(full_row_count()) + 1);
+    const auto window = cache_->window(top_, 0, std::size(rows_) - 1, std::data(rows_));
+    rows_.resize(window.size);
+
+    if (!std::empty(rows_))
+        top_ = rows_.front().address;
+}
+
+void disasm_widget::update_row(const int row)
+{
+    if (row < 0)
+        return;
+
+    const auto row_height = charsize_.height();
+    viewport()->update(0, row * row_height, viewport()->width(), row_height);
+}
+
+void disasm_widget::update_scroll_range()
+{
+    auto *scroll_bar = verticalScrollBar();
+
+    if (!cache_)
+    {
+        scroll_bar->setRange(0, 0);
+        return;
+    }
+
+    // Only sizes the handle; on_scroll_action turns steps into rows. Items average about 2 bytes.
+    scroll_bar->setRange(0, static_cast<int>(cache_->size()) - 1);
+    scroll_bar->setPageStep(std::max(full_row_count(), 1) * 2);
+}
+
+auto disasm_widget::text_of(const disasm6502::decoded_instruction &instruction) -> const QStaticText &
+{
+    const auto cached = texts_.find(instruction.address);
+
+    if (cached != std::end(texts_))
+    {
+        if (same_item(cached->second.instruction, instruction))
+            return cached->second.text;
+    }
+    else if (std::size(texts_) >= max_cached_texts)
+    {
+        texts_.clear();
+    }
+
+    std::array<char, 16 + disasm6502::max_formatted_length> line;
+    const auto length = format_row(instruction, cache_->target(), std::data(line));
+
+    QStaticText text{QString::fromLatin1(std::data(line), static_cast<int>(length))};
+    text.setTextFormat(Qt::PlainText);
+    text.setPerformanceHint(QStaticText::AggressiveCaching);
+    text.prepare(QTransform{}, font());
 
-    painter.drawText(0, charsize_.height(), "8d 02 44");
-    painter.drawText(100, charsize_.height(), "sta $0244");
+    auto &entry = texts_[instruction.address];
+    entry.instruction = instruction;
+    entry.text = std::move(text);
+    return entry.text;
 }
 
 } // namespace rua1::widgets
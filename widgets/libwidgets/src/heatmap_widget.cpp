@@ -0,0 +1,121 @@
+#include <widgets/heatmap_widget.h>
+#include <QMouseEvent>
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+namespace rua1::widgets
+{
+
+static constexpr auto image_size = 256;
+
+// Every frame an address loses 1/32 of its heat, so at 60 frames per second it halves in about 0.4 seconds.
+static constexpr auto cooling_shift = 5;
+
+// Heat is kept below this, so an address that was hammered for a while still fades out within seconds.
+static constexpr std::uint32_t max_heat = 0xFFFF;
+
+/*!
+ * Brightness of each heat level. Logarithmic, so a single access is visible next to an address that is
+ * accessed thousands of times per frame.
+ */
+static auto brightness_table()
+{
+    std::vector<std::uint8_t> table(max_heat + 1);
+    const auto scale = 255.0 / std::log2(static_cast<double>(max_heat) + 1.0);
+
+    for (auto heat = std::size_t{0}; heat <= max_heat; ++heat)
+        table[heat] = static_cast<std::uint8_t>(std::lround(std::log2(static_cast<double>(heat) + 1.0) * scale));
+
+    return table;
+}
+
+static auto next_heat(std::uint32_t heat, const std::uint32_t count) noexcept -> std::uint32_t
+{
+    // Rounding up makes a single access fade out completely.
+    heat -= (heat + (1u << cooling_shift) - 1) >> cooling_shift;
+    return std::min(heat + std::min(count, max_heat), max_heat);
+}
+
+heatmap_widget::heatmap_widget(QWidget *parent)
+    : QWidget{parent}
+    , heat_{}
+    , image_{image_size, image_size, QImage::Format_RGB32}
+    , address_clicked_handler_{}
+{
+    for (auto &heat : heat_)
+        heat.assign(address_count, 0);
+
+    image_.fill(Qt::black);
+
+    // The image covers the whole widget, so the background doesn't have to be erased first.
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setCursor(Qt::CrossCursor);
+}
+
+heatmap_widget::~heatmap_widget() = default;
+
+void heatmap_widget::set_address_clicked_handler(std::function<void(const std::uint16_t)> handler)
+{
+    address_clicked_handler_ = std::move(handler);
+}
+
+void heatmap_widget::add_counts(const std::uint32_t *reads, const std::uint32_t *writes, const std::uint32_t *fetches)
+{
+    static const auto brightness = brightness_table();
+
+    auto *read_heat = std::data(heat_[0]);
+    auto *write_heat = std::data(heat_[1]);
+    auto *fetch_heat = std::data(heat_[2]);
+
+    for (auto page = 0; page < image_size; ++page)
+    {
+        auto *pixels = reinterpret_cast<QRgb *>(image_.scanLine(page));
+        const auto first = static_cast<std::size_t>(page) * image_size;
+
+        for (auto address = first; address < first + image_size; ++address)
+        {
+            read_heat[address] = next_heat(read_heat[address], reads[address]);
+            write_heat[address] = next_heat(write_heat[address], writes[address]);
+            fetch_heat[address] = next_heat(fetch_heat[address], fetches[address]);
+
+            *pixels++ = qRgb(brightness[write_heat[address]], brightness[read_heat[address]],
+                             brightness[fetch_heat[address]]);
+        }
+    }
+
+    update();
+}
+
+void heatmap_widget::clear()
+{
+    for (auto &heat : heat_)
+        std::fill(std::begin(heat), std::end(heat), 0);
+
+    image_.fill(Qt::black);
+    update();
+}
+
+auto heatmap_widget::sizeHint() const -> QSize
+{
+    return QSize{image_size * 2, image_size * 2};
+}
+
+void heatmap_widget::paintEvent(QPaintEvent *)
+{
+    // Without smooth pixmap transform the image is scaled by repeating pixels, which keeps addresses apart.
+    QPainter painter{this};
+    painter.drawImage(rect(), image_);
+}
+
+void heatmap_widget::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton || !address_clicked_handler_ || width() <= 0 || height() <= 0)
+        return;
+
+    const auto column = std::clamp(event->pos().x() * image_size / width(), 0, image_size - 1);
+    const auto page = std::clamp(event->pos().y() * image_size / height(), 0, image_size - 1);
+    address_clicked_handler_(static_cast<std::uint16_t>(page * image_size + column));
+}
+
+} // namespace rua1::widgets
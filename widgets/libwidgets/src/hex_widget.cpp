@@ -0,0 +1,213 @@
+#include <widgets/hex_widget.h>
+#include <disasm6502/formatter.h>
+#include <QFontDatabase>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+namespace rua1::widgets
+{
+
+static constexpr std::size_t bytes_per_row = 16;
+
+// "aaaa  " followed by 3 characters per byte, a space and 1 character per byte.
+static constexpr std::size_t row_length = 6 + bytes_per_row * 4 + 1;
+
+static constexpr std::size_t max_cached_texts = 1024;
+
+hex_widget::hex_widget(QWidget *parent)
+    : QAbstractScrollArea{parent}
+    , address_{}
+    , bytes_{}
+    , texts_{}
+    , top_row_{}
+    , charsize_{}
+    , address_background_{0xF0, 0xF0, 0xFE}
+{
+    auto f = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    f.setPointSize(12);
+    f.setStyleHint(QFont::TypeWriter);
+    setFont(f);
+
+    QFontMetrics metrics{f};
+    charsize_ = QSize{metrics.width(" "), metrics.height()};
+
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOn);
+
+    // Every paint event fills its whole rectangle, so the background doesn't have to be erased first.
+    viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
+
+    update_scroll_range();
+}
+
+hex_widget::~hex_widget() = default;
+
+void hex_widget::set_range(const std::uint16_t address, const std::size_t size)
+{
+    address_ = address;
+    bytes_.assign(std::min<std::size_t>(size, 0x10000), 0);
+    texts_.clear();
+    top_row_ = 0;
+
+    update_scroll_range();
+    verticalScrollBar()->setValue(0);
+    viewport()->update();
+}
+
+void hex_widget::set_bytes(const std::uint16_t address, const std::uint8_t *data, const std::size_t size)
+{
+    const auto offset = static_cast<std::size_t>(static_cast<std::uint16_t>(address - address_));
+
+    if (offset >= std::size(bytes_))
+        return;
+
+    const auto end = std::min(offset + size, std::size(bytes_));
+
+    for (auto begin = offset; begin < end;)
+    {
+        const auto row = begin / bytes_per_row;
+        const auto row_end = std::min((row + 1) * bytes_per_row, end);
+        const auto count = row_end - begin;
+        const auto *source = data + (begin - offset);
+
+        if (std::memcmp(std::data(bytes_) + begin, source, count) != 0)
+        {
+            std::memcpy(std::data(bytes_) + begin, source, count);
+            texts_.erase(static_cast<int>(row));
+            update_row(static_cast<int>(row));
+        }
+
+        begin = row_end;
+    }
+}
+
+void hex_widget::scroll_to(const std::uint16_t address)
+{
+    const auto offset = static_cast<std::size_t>(static_cast<std::uint16_t>(address - address_));
+
+    if (offset < std::size(bytes_))
+        verticalScrollBar()->setValue(static_cast<int>(offset / bytes_per_row));
+}
+
+void hex_widget::paintEvent(QPaintEvent *event)
+{
+    QPainter painter{viewport()};
+    painter.setPen(palette().color(QPalette::Text));
+
+    const auto &rect = event->rect();
+    const auto row_height = charsize_.height();
+    const auto x = charsize_.width() - horizontalScrollBar()->value();
+
+    painter.fillRect(rect, palette().base());
+    painter.fillRect(QRect{-horizontalScrollBar()->value(), rect.top(), address_column_width(), rect.height()},
+                     address_background_);
+
+    const auto first = rect.top() / row_height;
+    const auto last = std::min(rect.bottom() / row_height, row_count() - top_row_ - 1);
+
+    for (auto i = first; i <= last; ++i)
+        painter.drawStaticText(QPoint{x, i * row_height}, text_of(top_row_ + i));
+}
+
+void hex_widget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    update_scroll_range();
+}
+
+void hex_widget::scrollContentsBy(int dx, int dy)
+{
+    top_row_ = verticalScrollBar()->value();
+
+    // Rows that stay visible are moved rather than painted again.
+    if (dx == 0 && std::abs(dy) <= full_row_count())
+        viewport()->scroll(0, dy * charsize_.height());
+    else
+        viewport()->update();
+}
+
+auto hex_widget::row_count() const noexcept -> int
+{
+    return static_cast<int>((std::size(bytes_) + bytes_per_row - 1) / bytes_per_row);
+}
+
+auto hex_widget::full_row_count() const noexcept -> int
+{
+    return viewport()->height() / charsize_.height();
+}
+
+auto hex_widget::address_column_width() const noexcept -> int
+{
+    // The 4 address digits with a character of margin on both sides.
+    return charsize_.width() * 6;
+}
+
+void hex_widget::update_row(const int row)
+{
+    const auto visible_row = row - top_row_;
+
+    if (visible_row < 0 || visible_row > full_row_count())
+        return;
+
+    const auto row_height = charsize_.height();
+    viewport()->update(0, visible_row * row_height, viewport()->width(), row_height);
+}
+
+void hex_widget::update_scroll_range()
+{
+    const auto page = std::max(full_row_count(), 1);
+
+    auto *vertical = verticalScrollBar();
+    vertical->setRange(0, std::max(row_count() - page, 0));
+    vertical->setPageStep(page);
+
+    const auto width = static_cast<int>(row_length + 2) * charsize_.width();
+
+    auto *horizontal = horizontalScrollBar();
+    horizontal->setRange(0, std::max(width - viewport()->width(), 0));
+    horizontal->setPageStep(viewport()->width());
+    horizontal->setSingleStep(charsize_.width());
+}
+
+auto hex_widget::text_of(const int row) -> const QStaticText &
+{
+    const auto cached = texts_.find(row);
+
+    if (cached != std::end(texts_))
+        return cached->second;
+
+    if (std::size(texts_) >= max_cached_texts)
+        texts_.clear();
+
+    const auto offset = static_cast<std::size_t>(row) * bytes_per_row;
+    const auto count = std::min(bytes_per_row, std::size(bytes_) - offset);
+    const auto *bytes = std::data(bytes_) + offset;
+
+    std::array<char, row_length> line;
+    line.fill(' ');
+
+    disasm6502::format_hex16(static_cast<std::uint16_t>(address_ + offset), std::data(line));
+
+    auto *hex = std::data(line) + 6;
+    auto *ascii = std::data(line) + 6 + bytes_per_row * 3 + 1;
+
+    for (auto i = std::size_t{0}; i < count; ++i)
+    {
+        disasm6502::format_hex8(bytes[i], hex + i * 3);
+        ascii[i] = bytes[i] >= 0x20 && bytes[i] < 0x7F ? static_cast<char>(bytes[i]) : '.';
+    }
+
+    QStaticText text{QString::fromLatin1(std::data(line), static_cast<int>(ascii + count - std::data(line)))};
+    text.setTextFormat(Qt::PlainText);
+    text.setPerformanceHint(QStaticText::AggressiveCaching);
+    text.prepare(QTransform{}, font());
+
+    return texts_.emplace(row, std::move(text)).first->second;
+}
+
+} // namespace rua1::widgets
@@ -1,13 +1,56 @@
 #include <frmmain.h>
+#include <vector>
 
 namespace rua1::widgets_tests
 {
 
+static constexpr auto step_interval_ms = 100;
+
+static auto random_memory_cache(std::mt19937 &random)
+{
+    std::vector<std::uint8_t> memory(0x10000);
+    std::uniform_int_distribution<int> byte{0, 255};
+
+    for (auto &value : memory)
+        value = static_cast<std::uint8_t>(byte(random));
+
+    return disasm6502::disassembly_cache{
+        aeon::common::span<const std::uint8_t>{std::data(memory), std::size(memory)}, 0,
+        disasm6502::cpu_target::target_65c02};
+}
+
 frmmain::frmmain()
     : QMainWindow{}
+    , random_{}
+    , cache_{random_memory_cache(random_)}
+    , pc_{0x0200}
+    , step_timer_{}
     , disasm_widget_{new widgets::disasm_widget{}}
 {
     setCentralWidget(disasm_widget_);
+    disasm_widget_->set_cache(&cache_);
+    disasm_widget_->set_pc(pc_);
+
+    // Simulates a running machine: the program counter walks through the items and now and then a byte
+    // close to it is overwritten.
+    step_timer_.setInterval(step_interval_ms);
+    connect(&step_timer_, &QTimer::timeout, [this]() { on_step_timer(); });
+    step_timer_.start();
+}
+
+void frmmain::on_step_timer()
+{
+    const auto &instruction = cache_.item(pc_);
+    pc_ = static_cast<std::uint16_t>(instruction.address + instruction.length);
+
+    if (std::uniform_int_distribution<int>{0, 3}(random_) == 0)
+    {
+        const auto address = static_cast<std::uint16_t>(pc_ + std::uniform_int_distribution<int>{0, 15}(random_));
+        cache_.write(address, static_cast<std::uint8_t>(std::uniform_int_distribution<int>{0, 255}(random_)));
+        disasm_widget_->refresh();
+    }
+
+    disasm_widget_->set_pc(pc_);
 }
 
 } // namespace rua1::widgets_tests
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <QMainWindow>
+#include <QTimer>
 #include <QtWidgets/QVBoxLayout>
 #include <widgets/disasm_widget.h>
+#include <disasm6502/disassembly_cache.h>
+#include <cstdint>
+#include <random>
 
 namespace rua1::widgets_tests
 {
@@ -22,6 +26,12 @@ public:
     auto operator=(const frmmain &) noexcept -> frmmain & = delete;
 
 private:
+    void on_step_timer();
+
+    std::mt19937 random_;
+    disasm6502::disassembly_cache cache_;
+    std::uint16_t pc_;
+    QTimer step_timer_;
     widgets::disasm_widget *disasm_widget_;
 };
 